@@ -19,6 +19,7 @@ bool ApplicationWindow::ProcessInput(const InputCompactEvent& event)
 
 void ApplicationWindow::Update(int deltaTime)
 {
+  if (mMemoryReportAge < sMemoryReportPeriod) mMemoryReportAge += deltaTime;
   mViewController.Update(deltaTime);
   WindowManager::Update(deltaTime);
 }
@@ -35,3 +36,15 @@ bool ApplicationWindow::UpdateHelpSystem()
     mViewController.updateHelpPrompts();
   return true;
 }
+
+std::string ApplicationWindow::FramerateAdditionalInformation()
+{
+  // Computed again only when the game database changes, once per second at most.
+  // The full report is logged by the main runner
+  if (mMemoryReportAge >= sMemoryReportPeriod)
+  {
+    mMemoryReport.Refresh();
+    mMemoryReportAge = 0;
+  }
+  return mMemoryReport.Summary();
+}
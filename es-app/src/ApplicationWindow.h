@@ -6,6 +6,7 @@
 #include <WindowManager.h>
 #include <systems/SystemManager.h>
 #include <views/ViewController.h>
+#include <systems/MemoryReport.h>
 
 class ApplicationWindow: public WindowManager
 {
@@ -13,6 +14,13 @@ class ApplicationWindow: public WindowManager
     //! View controler
     ViewController mViewController;
 
+    //! Game database memory report
+    MemoryReport mMemoryReport;
+    //! Time elapsed since the last memory report refresh, in milliseconds
+    int mMemoryReportAge;
+    //! Minimum time between two memory report refreshes, in milliseconds
+    static constexpr int sMemoryReportPeriod = 1000;
+
     //! True when the Application window is being closed ASAP
     bool mClosed;
 
@@ -23,6 +31,12 @@ class ApplicationWindow: public WindowManager
      */
     bool UpdateHelpSystem() override;
 
+    /*!
+     * @brief Add the game database memory report to framerate statistics
+     * @return Memory report
+     */
+    std::string FramerateAdditionalInformation() override;
+
   public:
     /*!
      * @brief Constructor
@@ -30,6 +44,8 @@ class ApplicationWindow: public WindowManager
      */
     explicit ApplicationWindow(SystemManager& systemManager)
       : mViewController(*this, systemManager),
+        mMemoryReport(systemManager),
+        mMemoryReportAge(sMemoryReportPeriod),
         mClosed(false)
     {
     }
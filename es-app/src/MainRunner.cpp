@@ -10,6 +10,7 @@
 #include <audio/AudioManager.h>
 #include <views/ViewController.h>
 #include <systems/SystemManager.h>
+#include <systems/MemoryReport.h>
 #include <guis/GuiMsgBoxScroll.h>
 #include <VideoEngine.h>
 #include <guis/GuiDetectDevice.h>
@@ -26,6 +27,7 @@
 #include "CommandThread.h"
 #include "netplay/NetPlayThread.h"
 #include "DemoMode.h"
+#include <algorithm>
 
 MainRunner::ExitState MainRunner::sRequestedExitState = MainRunner::ExitState::Quit;
 bool MainRunner::sQuitRequested = false;
@@ -111,6 +113,14 @@ MainRunner::ExitState MainRunner::Run()
       return ExitState::FatalError;
     ResetForceReloadState();
 
+    // Memory report of loaded systems. It walks all trees and strings: on demand only
+    if (Log::getReportingLevel() >= LogLevel::LogDebug || mConfiguration.AsBool("emulationstation.memoryreport", false))
+    {
+      MemoryReport memoryReport(systemManager);
+      memoryReport.Refresh();
+      memoryReport.LogReport();
+    }
+
     // Run kodi at startup?
     if (RecalboxSystem::kodiExists())
       if ((mRunCount == 0) && mConfiguration.GetKodiEnabled() && mConfiguration.GetKodiAtStartup())
@@ -224,11 +234,21 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
   LOG(LogDebug) << "Entering main loop";
   Path mustExit(sQuitNow);
   int lastTime = SDL_GetTicks();
+  bool playStatsCompacted = false;
   for(;;)
   {
     // File watching
     fileNotifier.CheckAndDispatch();
 
+    // Reload externally modified gamelists in place, or relaunch if they cannot be reloaded
+    for (const Path& gamelist : mChangedGamelists)
+      if (!systemManager.ReloadGamelist(gamelist) && mPendingExit == PendingExit::None)
+        mPendingExit = PendingExit::GamelistChanged;
+    mChangedGamelists.clear();
+
+    // Apply rom folder modifications
+    systemManager.CheckRomFolders();
+
     // SDL
     SDL_Event event;
     while (SDL_PollEvent(&event) != 0)
@@ -250,6 +270,12 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
         case SDL_JOYDEVICEADDED:
         case SDL_JOYDEVICEREMOVED:
         {
+          // Any input wakes the window up: stop writing gamelists before games are modified
+          if (playStatsCompacted)
+          {
+            systemManager.CancelPlayStatsCompaction();
+            playStatsCompacted = false;
+          }
           // Convert event
           InputCompactEvent compactEvent = InputManager::Instance().ManageSDLEvent(&window, event);
           // Process
@@ -270,7 +296,15 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
 
     if (window.isSleeping())
     {
-      if (DemoMode::hasDemoMode())
+      // Nobody is waiting: fold play statistics into gamelists in background
+      if (!playStatsCompacted)
+      {
+        systemManager.StartPlayStatsCompaction();
+        playStatsCompacted = true;
+      }
+
+      // Demo games update play statistics: let the compaction complete first
+      if (DemoMode::hasDemoMode() && !systemManager.IsCompactingPlayStats())
         demoMode.runDemo();
 
       lastTime = SDL_GetTicks();
@@ -279,6 +313,13 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
       continue;
     }
 
+    // The user is back: do not compete with the UI
+    if (playStatsCompacted)
+    {
+      systemManager.CancelPlayStatsCompaction();
+      playStatsCompacted = false;
+    }
+
     int curTime = SDL_GetTicks();
     int deltaTime = curTime - lastTime;
     lastTime = curTime;
@@ -500,7 +541,10 @@ void MainRunner::FileSystemWatcherNotification(EventType event, const Path& path
     {
       std::string name = path.Filename();
       if (name == "gamelist.xml" || name == "gamelist.zip")
-        mPendingExit = PendingExit::GamelistChanged;
+      {
+        if (std::find(mChangedGamelists.begin(), mChangedGamelists.end(), path) == mChangedGamelists.end())
+          mChangedGamelists.push_back(path);
+      }
       else if (path.ToString().find("themes") != std::string::npos)
         mPendingExit = PendingExit::ThemeChanged;
     }
@@ -68,6 +68,8 @@ class MainRunner
 
     //! Pending exit
     PendingExit mPendingExit;
+    //! Gamelists modified by external tools, to reload
+    Path::PathList mChangedGamelists;
 
     //! Run count
     int mRunCount;
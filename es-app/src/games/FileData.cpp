@@ -1,7 +1,9 @@
 #include "FileData.h"
 #include "systems/SystemData.h"
+#include "PathIndex.h"
 
 #include <utils/Strings.h>
+#include <cstring>
 #include <GameNameMapManager.h>
 
 FileData::FileData(ItemType type, const Path& path, RootFolderData& ancestor)
@@ -9,9 +11,76 @@ FileData::FileData(ItemType type, const Path& path, RootFolderData& ancestor)
     mParent(nullptr),
     mType(type),
     mPath(path),
+    mRelativePath(false),
+    mIndexSlot(-1),
     mMetadata(getDisplayName(), type) // TODO: Move clean name into metadata
 {
+  // Store only the path part below the root folder: roots are never stored relative,
+  // and the master root, which is its own ancestor, may not be constructed yet
+  if (type != ItemType::Root)
+  {
+    const Path& rootPath = ((const FileData&)ancestor).mPath;
+    if (!rootPath.IsEmpty() && path != rootPath && path.StartWidth(rootPath))
+    {
+      mPath = Path(path.ToString().substr(rootPath.ToString().size() + 1));
+      mRelativePath = true;
+    }
+  }
+}
+
+Path FileData::getPath() const
+{
+  return mRelativePath ? ((const FileData&)mTopAncestor).mPath / mPath : mPath;
+}
+
+const std::string& FileData::getPathString(std::string& storage) const
+{
+  if (!mRelativePath) return mPath.ToString();
+  storage.assign(((const FileData&)mTopAncestor).mPath.ToString()).append(1, '/').append(mPath.ToString());
+  return storage;
+}
+
+unsigned long long FileData::getPathHash() const
+{
+  const std::string& path = mPath.ToString();
+  if (!mRelativePath) return PathIndex::HashPath(path.data(), path.size());
+
+  const std::string& root = ((const FileData&)mTopAncestor).mPath.ToString();
+  PathIndex::Hash hash = PathIndex::HashPath(root.data(), root.size());
+  hash = PathIndex::HashPath("/", 1, hash);
+  return PathIndex::HashPath(path.data(), path.size(), hash);
+}
+
+bool FileData::hasPath(const char* path, size_t length) const
+{
+  const std::string& stored = mPath.ToString();
+  if (!mRelativePath) return stored.size() == length && memcmp(stored.data(), path, length) == 0;
+
+  const std::string& root = ((const FileData&)mTopAncestor).mPath.ToString();
+  return root.size() + 1 + stored.size() == length &&
+         memcmp(root.data(), path, root.size()) == 0 && path[root.size()] == '/' &&
+         memcmp(stored.data(), path + root.size() + 1, stored.size()) == 0;
+}
 
+void FileData::HotMetadataChanged()
+{
+  if (!isGame()) return;
+
+  GameIndex& index = mTopAncestor.System().HotIndex();
+  Mutex::AutoLock locker(index.Locker());
+  int previousFlags = 0;
+  if (index.Patch(*this, mIndexSlot, previousFlags))
+  {
+    int flags = index.Flags()[mIndexSlot];
+    if (flags != previousFlags && mParent != nullptr)
+      mParent->moveCountedGame(index, previousFlags, flags);
+  }
+}
+
+void FileData::AddMemoryUsage(MemoryUsage& usage) const
+{
+  usage.Paths += Strings::HeapSize(mPath.ToString());
+  mMetadata.AddMemoryUsage(usage.Strings, usage.Paths);
 }
 
 FileData::FileData(const Path& path, RootFolderData& ancestor) : FileData(ItemType::Game, path, ancestor)
@@ -7,6 +7,7 @@
 #include "MetadataDescriptor.h"
 #include "ItemType.h"
 #include "utils/cplusplus/Bitflags.h"
+#include <utils/storage/Arena.h>
 
 // Forward declarations
 class SystemData;
@@ -17,7 +18,6 @@ class RootFolderData;
 class FileData
 {
   public:
-    typedef HashMap<std::string, FileData*> StringMap;
     typedef std::vector<FileData*> List;
     typedef std::vector<const FileData*> ConstList;
     typedef int (*Comparer)(const FileData& a, const FileData& b);
@@ -41,6 +41,15 @@ class FileData
       All           = 7, //!< All attributes
     };
 
+    //! Heap memory used by items, in bytes. Item nodes themselves live in system arenas
+    struct MemoryUsage
+    {
+      size_t Lists   = 0; //!< Child lists
+      size_t Strings = 0; //!< Metadata strings, interned values excluded
+      size_t Paths   = 0; //!< Item and media paths
+      size_t Indexes = 0; //!< Hot metadata indexes
+    };
+
   protected:
     //! Top ancestor (link to system)
     RootFolderData& mTopAncestor;
@@ -50,8 +59,15 @@ class FileData
     const ItemType mType;
 
   private:
-    //! Item path on the filesystem
+    // Allow folders to record index slots of their games
+    friend class FolderData;
+
+    //! Item path, relative to the top ancestor when mRelativePath is true, absolute otherwise
     Path mPath;
+    //! True if mPath is relative to the top ancestor path
+    bool mRelativePath;
+    //! Slot of the game in the hot metadata index of its system
+    int mIndexSlot;
     //! Metadata
     MetadataDescriptor mMetadata;
 
@@ -72,6 +88,17 @@ class FileData
      */
     FileData(const Path& path, RootFolderData& ancestor);
 
+    /*
+     * Allocation
+     * Items are allocated from the arena of their system, and their memory is released along with the system.
+     * Deleting an item only runs its destructor
+     */
+
+    static void* operator new(size_t size, Arena& arena) { return arena.Allocate(size); }
+    static void operator delete(void*, Arena&) {}
+    static void operator delete(void*) {}
+    static void* operator new(size_t) = delete;
+
     /*
      * Getters
      */
@@ -79,7 +106,16 @@ class FileData
     inline const std::string& getName() const { return mMetadata.Name(); }
     inline std::string getHash() const { return mMetadata.RomCrc32AsString(); }
     inline ItemType getType() const { return mType; }
-    inline const Path& getPath() const { return mPath; }
+    Path getPath() const;
+    /*!
+     * @brief Get the absolute path as a string without building a Path.
+     * Relative paths are assembled into the given storage, so that loops reusing it do not allocate per item
+     * @param storage Storage for assembled paths
+     * @return Absolute path string: either the stored path or the storage
+     */
+    const std::string& getPathString(std::string& storage) const;
+    inline const Path& getRelativePath() const { return mPath; }
+    unsigned long long getPathHash() const;
     inline FolderData* getParent() const { return mParent; }
     inline RootFolderData& getTopAncestor() const { return mTopAncestor; }
     SystemData* getSystem() const;
@@ -100,6 +136,25 @@ class FileData
 
     inline void setParent(FolderData* parent) { mParent = parent; }
 
+    /*!
+     * @brief Set the favorite flag. Index and game counts of the system are updated in place
+     * @param favorite New favorite flag
+     */
+    void SetFavorite(bool favorite) { mMetadata.SetFavorite(favorite); HotMetadataChanged(); }
+
+    /*!
+     * @brief Set the hidden flag. Index and game counts of the system are updated in place
+     * @param hidden New hidden flag
+     */
+    void SetHidden(bool hidden) { mMetadata.SetHidden(hidden); HotMetadataChanged(); }
+
+    /*!
+     * @brief Must be called after hot metadata (flags, genre, region, players, play statistics, rating)
+     * have been modified through Metadata(), so that the index of the system and game counts of
+     * parent folders are updated in place
+     */
+    void HotMetadataChanged();
+
     /*!
      * Get Thumbnail path if there is one, or Image path.
      * @return file path (may be empty)
@@ -137,11 +192,25 @@ class FileData
      */
     std::string getDisplayName() const;
 
+    /*!
+     * @brief Check the item path without rebuilding it
+     * @param path Path characters
+     * @param length Path length
+     * @return True if the item path is the given path
+     */
+    bool hasPath(const char* path, size_t length) const;
+
+    /*!
+     * @brief Add the heap memory used by this item, out of its node
+     * @param usage Memory usage to update
+     */
+    void AddMemoryUsage(MemoryUsage& usage) const;
+
     /*!
      * @brief Get Pad2Keyboard configuration file path
      * @return Pad2Keyboard configuration file path
      */
-    Path P2KPath() const { return mPath.ChangeExtension(mPath.Extension() + ".p2k.cfg"); }
+    Path P2KPath() const { Path path(getPath()); return path.ChangeExtension(path.Extension() + ".p2k.cfg"); }
 
     /*!
      * @brief Check if Pad2Keyboard configuration file exists
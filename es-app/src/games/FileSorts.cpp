@@ -44,6 +44,12 @@ static int unicodeCompareUppercase(const std::string& a, const std::string& b)
   }
 }
 
+static int compareKeys(const std::string& a, const std::string& b)
+{
+  // Sort keys: byte order is the uppercase code point order
+  return a.compare(b);
+}
+
 static int compareFoldersAndGames(const FileData& fd1, const FileData& fd2)
 {
   ItemType f1 = fd1.getType();
@@ -59,15 +65,18 @@ ImplementSortMethod(compareSystemName)
 {
   const SystemData * system1 = file1.getSystem();
   const SystemData * system2 = file2.getSystem();
-  const int result = unicodeCompareUppercase(system1->getName(), system2->getName());
-  if (result != 0) { return result; }
-  return unicodeCompareUppercase(file1.getName(), file2.getName());
+  if (system1 != system2)
+  {
+    const int result = unicodeCompareUppercase(system1->getName(), system2->getName());
+    if (result != 0) { return result; }
+  }
+  return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
 }
 
 ImplementSortMethod(compareFileName)
 {
   CheckFoldersAndGames(file1, file2)
-  return unicodeCompareUppercase(file1.getName(), file2.getName());
+  return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
 }
 
 ImplementSortMethod(compareRating)
@@ -76,7 +85,7 @@ ImplementSortMethod(compareRating)
   float c = file1.Metadata().Rating() - file2.Metadata().Rating();
   if (c < 0) { return -1; }
   if (c > 0) { return 1; }
-  return unicodeCompareUppercase(file1.getName(), file2.getName());
+  return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
 }
 
 ImplementSortMethod(compareTimesPlayed)
@@ -84,7 +93,7 @@ ImplementSortMethod(compareTimesPlayed)
   CheckFoldersAndGames(file1, file2)
   int playCount = (file1).Metadata().PlayCount() - (file2).Metadata().PlayCount();
   if (playCount != 0) return playCount;
-  return unicodeCompareUppercase(file1.getName(), file2.getName());
+  return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
 }
 
 ImplementSortMethod(compareLastPlayed)
@@ -95,7 +104,7 @@ ImplementSortMethod(compareLastPlayed)
   if (ep1 == 0) ep1 = 0xFFFFFFFF;
   if (ep2 == 0) ep2 = 0xFFFFFFFF;
   if (ep1 == ep2)
-    return unicodeCompareUppercase(file1.getName(), file2.getName());
+    return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
   return ep1 < ep2 ? -1 : 1;
 }
 
@@ -104,19 +113,27 @@ ImplementSortMethod(compareNumberPlayers)
   CheckFoldersAndGames(file1, file2)
   int players = (file1).Metadata().PlayerRange() - (file2).Metadata().PlayerRange();
   if (players != 0) return players;
-  return unicodeCompareUppercase(file1.getName(), file2.getName());
+  return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
 }
 
 ImplementSortMethod(compareDevelopper)
 {
   CheckFoldersAndGames(file1, file2)
-  return unicodeCompareUppercase(file1.Metadata().Developer(), file2.Metadata().Developer());
+  // Interned values: equal values share the same string
+  const std::string& developer1 = file1.Metadata().Developer();
+  const std::string& developer2 = file2.Metadata().Developer();
+  if (&developer1 == &developer2) return 0;
+  return unicodeCompareUppercase(developer1, developer2);
 }
 
 ImplementSortMethod(comparePublisher)
 {
   CheckFoldersAndGames(file1, file2)
-  return unicodeCompareUppercase(file1.Metadata().Publisher(), file2.Metadata().Publisher());
+  // Interned values: equal values share the same string
+  const std::string& publisher1 = file1.Metadata().Publisher();
+  const std::string& publisher2 = file2.Metadata().Publisher();
+  if (&publisher1 == &publisher2) return 0;
+  return unicodeCompareUppercase(publisher1, publisher2);
 }
 
 ImplementSortMethod(compareGenre)
@@ -124,7 +141,7 @@ ImplementSortMethod(compareGenre)
   CheckFoldersAndGames(file1, file2)
   int genre = (int)(file1).Metadata().GenreId() - (int)(file2).Metadata().GenreId();
   if (genre != 0) return genre;
-  return unicodeCompareUppercase(file1.getName(), file2.getName());
+  return compareKeys(file1.Metadata().SortKey(), file2.Metadata().SortKey());
 }
 
 const std::vector<FileSorts::Sorts>& FileSorts::AvailableSorts(bool multisystem)
@@ -6,7 +6,10 @@
 #include "utils/Log.h"
 #include "systems/SystemData.h"
 #include "GameNameMapManager.h"
+#include "ScanManifest.h"
+#include "FileSorts.h"
 #include <algorithm>
+#include <cstring>
 
 #define CastFolder(f) ((FolderData*)(f))
 
@@ -19,6 +22,11 @@ FolderData::~FolderData()
   mChildren.clear();
 }
 
+void FolderData::treeChanged() const
+{
+  mTopAncestor.System().TreeChanged();
+}
+
 void FolderData::addChild(FileData* file, bool lukeImYourFather)
 {
   assert(file->getParent() == nullptr || !lukeImYourFather);
@@ -26,6 +34,7 @@ void FolderData::addChild(FileData* file, bool lukeImYourFather)
   mChildren.push_back(file);
   if (lukeImYourFather)
     file->setParent(this);
+  treeChanged();
 }
 
 void FolderData::removeChild(FileData* file)
@@ -34,10 +43,119 @@ void FolderData::removeChild(FileData* file)
     if(*it == file)
     {
       mChildren.erase(it);
+      treeChanged();
       return;
     }
 }
 
+int FolderData::removeFilteredGamesRecursively(IFilter* filter)
+{
+  int removed = 0;
+  for (int i = (int)mChildren.size(); --i >= 0; )
+  {
+    FileData* fd = mChildren[i];
+    if (fd->isFolder())
+      removed += CastFolder(fd)->removeFilteredGamesRecursively(filter);
+    else if (fd->isGame() && filter->ApplyFilter(*fd))
+    {
+      mChildren.erase(mChildren.begin() + i);
+      treeChanged();
+      removed++;
+    }
+  }
+  return removed;
+}
+
+bool FolderData::refreshFolder(RootFolderData& root, const std::string& filteredExtensions, FileData::List& removed)
+{
+  const Path& folderPath = getPath();
+  if (!folderPath.IsDirectory()) return false;
+
+  // Scan aside. Unmodified sub-folders are taken from the manifest, which is not saved:
+  // it would only contain the folders scanned here
+  // Scanned items live in a scratch arena: only new items are created again in the system arena,
+  // so that rescans do not leave a copy of the known items in the system arena each time
+  Arena scratch;
+  FolderData scanned(folderPath, root);
+  ScanManifest manifest(root.getPath());
+  manifest.Load();
+  scanned.scanFolder(root, scratch, filteredExtensions, manifest, nullptr, folderPath.IsSymLink());
+
+  return mergeScannedFolder(root, scanned, removed);
+}
+
+bool FolderData::mergeScannedFolder(RootFolderData& root, const FolderData& scanned, FileData::List& removed)
+{
+  bool changed = false;
+
+  // Both lists are children of the same folder in the same root: stored paths are enough to match items
+  HashMap<std::string, FileData*> known;
+  for (FileData* fd : mChildren)
+    known[fd->getRelativePath().ToString()] = fd;
+
+  // Add new items, merge known folders
+  for (FileData* fd : scanned.mChildren)
+  {
+    const std::string& key = fd->getRelativePath().ToString();
+    FileData** existing = known.try_get(key);
+    if (existing != nullptr && (*existing)->getType() == fd->getType())
+    {
+      if (fd->isFolder())
+        changed |= CastFolder(*existing)->mergeScannedFolder(root, *CastFolder(fd), removed);
+      known.erase(key);
+    }
+    else
+    {
+      addChild(createScannedItem(root, *fd), true);
+      changed = true;
+    }
+  }
+
+  // Remove items not found anymore. Items created from the gamelist only are kept as long as they exist
+  for (int i = (int)mChildren.size(); --i >= 0; )
+  {
+    FileData* fd = mChildren[i];
+    FileData** missing = known.try_get(fd->getRelativePath().ToString());
+    if (missing == nullptr || *missing != fd) continue;
+    if (fd->getPath().Exists() && (!fd->isFolder() || CastFolder(fd)->hasChildren())) continue;
+    mChildren.erase(mChildren.begin() + i);
+    treeChanged();
+    removed.push_back(fd);
+    changed = true;
+  }
+
+  // Scanned items are destroyed along with the scanned folder
+  return changed;
+}
+
+FileData* FolderData::createScannedItem(RootFolderData& root, const FileData& scanned)
+{
+  Arena& arena = root.System().ItemArena();
+  if (!scanned.isFolder())
+  {
+    FileData* newGame = new (arena) FileData(scanned.getPath(), root);
+    newGame->Metadata().SetDirty();
+    return newGame;
+  }
+
+  FolderData* newFolder = new (arena) FolderData(scanned.getPath(), root);
+  for (const FileData* fd : CastFolder(&scanned)->mChildren)
+    newFolder->addChild(createScannedItem(root, *fd), true);
+  return newFolder;
+}
+
+std::string FolderData::GetFolderExtensions(const RootFolderData& root, const Path& folderPath, const std::string& extensions)
+{
+  std::string result = extensions;
+  for (int i = root.getPath().ItemCount() - 1, last = folderPath.ItemCount() - 1; i < last; ++i)
+  {
+    Path folder(folderPath.UptoItem(i));
+    if ((folder / ".system.cfg").Exists())
+      result = ReadSystemConfigExtensions(folder, result);
+  }
+  return result;
+}
+
 static bool IsMatching(const std::string& fileWoExt, const std::string& extension, const std::string& extensionList)
 {
   #define sFilesPrefix "files:"
@@ -60,7 +178,7 @@ static bool IsMatching(const std::string& fileWoExt, const std::string& extensio
          ((filePos + file.size() == extensionList.size()) || (p[filePos + file.size()] == ' '));
 }
 
-void FolderData::populateRecursiveFolder(RootFolderData& root, const std::string& originalFilteredExtensions, FileData::StringMap& doppelgangerWatcher)
+void FolderData::populateRecursiveFolder(RootFolderData& root, const std::string& filteredExtensions, PathIndex& doppelgangerWatcher, ScanManifest& manifest, WorkStealingScheduler* scheduler)
 {
   const Path& folderPath = getPath();
   if (!folderPath.IsDirectory())
@@ -69,12 +187,23 @@ void FolderData::populateRecursiveFolder(RootFolderData& root, const std::string
     return;
   }
 
+  scanFolder(root, root.System().ItemArena(), filteredExtensions, manifest, scheduler, folderPath.IsSymLink());
+
+  // Fill the duplicate map once the whole tree is built, so that it does not depend on the task scheduling
+  // Keys MUST MATCH KEYS USED IN Gamelist.findOrCreateFile - Always fullpath
+  BuildDoppelgangerMap(doppelgangerWatcher, true);
+}
+
+void FolderData::scanFolder(RootFolderData& root, Arena& arena, const std::string& originalFilteredExtensions, ScanManifest& manifest, WorkStealingScheduler* scheduler, bool symLink)
+{
+  const Path& folderPath = getPath();
+
   // media folder?
   if (folderPath.FilenameWithoutExtension() == "media")
     return;
 
   //make sure that this isn't a symlink to a thing we already have
-  if (folderPath.IsSymLink())
+  if (symLink)
   {
     // if this symlink resolves to somewhere that's at the beginning of our path, it's gonna recurse
     Path canonical = folderPath.ToCanonical();
@@ -85,37 +214,76 @@ void FolderData::populateRecursiveFolder(RootFolderData& root, const std::string
     }
   }
 
-  // Subsystem override
-  std::string filteredExtensions = originalFilteredExtensions;
-  if ((folderPath / ".system.cfg").Exists())
+  // Scanned items, in listing order. Sub-folders may be scanned by other threads,
+  // so items are only added once they are all complete, keeping the tree deterministic
+  FileData::List items;
+  WorkStealingScheduler::Group subFolders;
+
+  // Unchanged since the last scan? Get entries from the manifest and just recurse into sub-folders
+  // Time is read before listing, so that any modification during the scan is caught on next run
+  long long folderTime = folderPath.LastModificationTime();
+  const ScanManifest::Folder* previous = manifest.Lookup(folderPath, folderTime);
+  if (previous != nullptr)
   {
-    IniFile subSystem(folderPath / ".system.cfg");
-    filteredExtensions = subSystem.AsString("extensions", originalFilteredExtensions);
+    // Subsystem override. The .system.cfg content may have changed without changing the folder time
+    std::string filteredExtensions = previous->SystemConfig ? ReadSystemConfigExtensions(folderPath, originalFilteredExtensions)
+                                                            : originalFilteredExtensions;
+    if (previous->MatchExtensions(filteredExtensions))
+    {
+      for (const std::string& game : previous->Games)
+        addScannedGame(root, arena, folderPath / game, items);
+      for (const std::string& subFolder : previous->SubFolders)
+        addScannedFolder(root, arena, folderPath / subFolder, filteredExtensions, manifest, scheduler, subFolders, items,
+                         std::find(previous->SymLinks.begin(), previous->SymLinks.end(), subFolder) != previous->SymLinks.end());
+      manifest.Store(folderPath, *previous, false);
+    }
+    else previous = nullptr;
   }
 
-  // special system?
-  bool hasFiltering = GameNameMapManager::HasFiltering(*getSystem());
-  // No extension?
-  bool noExtensions = filteredExtensions.empty();
-
-  // Keep temporary object outside the loop to avoid construction/destruction and keep memory allocated AMAP
-  Path::PathList items = folderPath.GetDirectoryContent();
-  for (Path& filePath : items)
+  if (previous == nullptr)
   {
-    // Get file
-    std::string stem = filePath.FilenameWithoutExtension();
-    if (stem == "gamelist") continue; // Ignore gamelist.zip/xml
-    if (stem.empty()) continue;
+    // Entries are typed by the listing itself, so that no further stat is required
+    Path::DirectoryEntryList entries = folderPath.GetDirectoryEntries();
+
+    // Subsystem override
+    std::string filteredExtensions = originalFilteredExtensions;
+    bool systemConfig = false;
+    for (const Path::DirectoryEntry& entry : entries)
+      if (entry.Name == ".system.cfg")
+      {
+        filteredExtensions = ReadSystemConfigExtensions(folderPath, originalFilteredExtensions);
+        systemConfig = true;
+        break;
+      }
+
+    ScanManifest::Folder scanned;
+    scanned.Time = folderTime;
+    scanned.Extensions = ScanManifest::Folder::HashExtensions(filteredExtensions);
+    scanned.EntryCount = (int)entries.size();
+    scanned.SystemConfig = systemConfig;
 
-    // and Extension
-    std::string extension = Strings::ToLowerASCII(filePath.Extension());
+    // special system?
+    bool hasFiltering = GameNameMapManager::HasFiltering(*getSystem());
+    // No extension?
+    bool noExtensions = filteredExtensions.empty();
 
-    //fyi, folders *can* also match the extension and be added as games - this is mostly just to support higan
-    //see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
-    bool isLaunchableGame = false;
-    if (!filePath.IsHidden())
+    for (const Path::DirectoryEntry& entry : entries)
     {
-      if ((noExtensions && filePath.IsFile()) ||
+      if (entry.IsHidden()) continue;
+
+      // Get file
+      Path filePath = folderPath / entry.Name;
+      std::string stem = filePath.FilenameWithoutExtension();
+      if (stem == "gamelist") continue; // Ignore gamelist.zip/xml
+      if (stem.empty()) continue;
+
+      // and Extension
+      std::string extension = Strings::ToLowerASCII(filePath.Extension());
+
+      //fyi, folders *can* also match the extension and be added as games - this is mostly just to support higan
+      //see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
+      bool isLaunchableGame = false;
+      if ((noExtensions && entry.IsFile()) ||
           (!extension.empty() && IsMatching(stem, extension, filteredExtensions)))
       {
         if (hasFiltering)
@@ -123,40 +291,88 @@ void FolderData::populateRecursiveFolder(RootFolderData& root, const std::string
           if (GameNameMapManager::IsFiltered(*getSystem(), stem))
             continue; // MAME Bios or Machine
         }
-        // Get the key for duplicate detection. MUST MATCH KEYS USED IN Gamelist.findOrCreateFile - Always fullpath
-        if (doppelgangerWatcher.find(filePath.ToString()) == doppelgangerWatcher.end())
-        {
-          FileData* newGame = new FileData(filePath, root);
-          newGame->Metadata().SetDirty();
-          addChild(newGame, true);
-          doppelgangerWatcher[filePath.ToString()] = newGame;
-        }
+        scanned.Games.push_back(entry.Name);
+        addScannedGame(root, arena, filePath, items);
         isLaunchableGame = true;
       }
 
       //add directories that also do not match an extension as folders
-      if (!isLaunchableGame && filePath.IsDirectory())
+      if (!isLaunchableGame && entry.IsDirectory())
       {
-        FolderData* newFolder = new FolderData(filePath, root);
-        newFolder->populateRecursiveFolder(root, filteredExtensions, doppelgangerWatcher);
-
-        //ignore folders that do not contain games
-        if (newFolder->hasChildren())
-        {
-          const std::string& key = newFolder->getPath().ToString();
-          if (doppelgangerWatcher.find(key) == doppelgangerWatcher.end())
-          {
-            addChild(newFolder, true);
-            doppelgangerWatcher[key] = newFolder;
-          }
-        }
-        else
-          delete newFolder;
+        // Record even empty folders: games may be added later without changing this folder's time
+        scanned.SubFolders.push_back(entry.Name);
+        if (entry.SymLink) scanned.SymLinks.push_back(entry.Name);
+        addScannedFolder(root, arena, filePath, filteredExtensions, manifest, scheduler, subFolders, items, entry.SymLink);
       }
     }
+
+    manifest.Store(folderPath, scanned, true);
+  }
+
+  // Wait for sub-folders, then add items
+  if (scheduler != nullptr)
+    scheduler->Wait(subFolders);
+  for (FileData* item : items)
+  {
+    //ignore folders that do not contain games
+    if (item->isFolder() && !CastFolder(item)->hasChildren()) delete item;
+    else addChild(item, true);
   }
 }
 
+bool FolderData::isScanUpToDate(const Path& folderPath, const std::string& originalFilteredExtensions, const ScanManifest& manifest, bool symLink)
+{
+  // Same folders as scanFolder
+  if (folderPath.FilenameWithoutExtension() == "media") return true;
+  if (symLink)
+  {
+    Path canonical = folderPath.ToCanonical();
+    if (folderPath.ToString().compare(0, canonical.ToString().size(), canonical.ToChars()) == 0) return true;
+  }
+
+  const ScanManifest::Folder* previous = manifest.Lookup(folderPath, folderPath.LastModificationTime());
+  if (previous == nullptr) return false;
+
+  // The .system.cfg content may have changed without changing the folder time
+  std::string filteredExtensions = previous->SystemConfig ? ReadSystemConfigExtensions(folderPath, originalFilteredExtensions)
+                                                          : originalFilteredExtensions;
+  if (!previous->MatchExtensions(filteredExtensions)) return false;
+
+  for (const std::string& subFolder : previous->SubFolders)
+    if (!isScanUpToDate(folderPath / subFolder, filteredExtensions, manifest,
+                        std::find(previous->SymLinks.begin(), previous->SymLinks.end(), subFolder) != previous->SymLinks.end()))
+      return false;
+  return true;
+}
+
+std::string FolderData::ReadSystemConfigExtensions(const Path& folderPath, const std::string& defaultExtensions)
+{
+  IniFile subSystem(folderPath / ".system.cfg");
+  return subSystem.AsString("extensions", defaultExtensions);
+}
+
+void FolderData::addScannedGame(RootFolderData& root, Arena& arena, const Path& filePath, FileData::List& items)
+{
+  FileData* newGame = new (arena) FileData(filePath, root);
+  newGame->Metadata().SetDirty();
+  items.push_back(newGame);
+}
+
+void FolderData::addScannedFolder(RootFolderData& root, Arena& arena, const Path& folderPath, const std::string& filteredExtensions, ScanManifest& manifest,
+                                  WorkStealingScheduler* scheduler, WorkStealingScheduler::Group& group, FileData::List& items, bool symLink)
+{
+  FolderData* newFolder = new (arena) FolderData(folderPath, root);
+  items.push_back(newFolder);
+
+  if (scheduler != nullptr)
+    scheduler->Push(group, [newFolder, &root, &arena, filteredExtensions, &manifest, scheduler, symLink]
+    {
+      newFolder->scanFolder(root, arena, filteredExtensions, manifest, scheduler, symLink);
+    });
+  else
+    newFolder->scanFolder(root, arena, filteredExtensions, manifest, scheduler, symLink);
+}
+
 int FolderData::getAllFoldersRecursively(FileData::List& to) const
 {
   int gameCount = 0;
@@ -194,9 +410,10 @@ void FolderData::ClearSubChildList()
     else
       mChildren[i] = nullptr;
   }
+  treeChanged();
 }
 
-void FolderData::BuildDoppelgangerMap(FileData::StringMap& doppelganger, bool includefolder) const
+void FolderData::BuildDoppelgangerMap(PathIndex& doppelganger, bool includefolder) const
 {
   for (FileData* fd : mChildren)
   {
@@ -204,10 +421,10 @@ void FolderData::BuildDoppelgangerMap(FileData::StringMap& doppelganger, bool in
     {
       CastFolder(fd)->BuildDoppelgangerMap(doppelganger, includefolder);
       if (includefolder)
-        doppelganger[fd->getPath().ToString()] = fd;
+        doppelganger.Set(fd);
     }
     else
-      doppelganger[fd->getPath().ToString()] = fd;
+      doppelganger.Set(fd);
   }
 }
 
@@ -236,6 +453,15 @@ int FolderData::getItemsRecursively(FileData::List& to, IFilter* filter, bool in
 
 int FolderData::getItemsRecursively(FileData::List& to, Filter includes, bool includefolders, bool includeadult) const
 {
+  // Without folders, matching games are a contiguous scan of the index
+  if (!includefolders)
+  {
+    GameIndex& index = mTopAncestor.System().HotIndex();
+    Mutex::AutoLock locker(index.Locker());
+    refreshIndex(index);
+    return index.Get(to, mIndexBegin, mIndexEnd, (int)includes, includeadult);
+  }
+
   int gameCount = 0;
   for (FileData* fd : mChildren)
   {
@@ -263,48 +489,93 @@ int FolderData::getItemsRecursively(FileData::List& to, Filter includes, bool in
 
 int FolderData::countItemsRecursively(Filter includes, bool includefolders, bool includeadult) const
 {
-  int result = 0;
+  GameIndex& index = mTopAncestor.System().HotIndex();
+  Mutex::AutoLock locker(index.Locker());
+  refreshIndex(index);
+  if (!includefolders)
+    return GameIndex::Sum(cachedCounters(index), (int)includes, includeadult);
+
+  int games = 0;
+  int folders = countFoldersRecursively(index, includes, includeadult, games);
+  return games + folders;
+}
+
+int FolderData::countFoldersRecursively(const GameIndex& index, Filter includes, bool includeadult, int& games) const
+{
+  games = GameIndex::Sum(cachedCounters(index), (int)includes, includeadult);
+  int folders = 0;
   for (FileData* fd : mChildren)
-  {
     if (fd->isFolder())
     {
-      int subCount = CastFolder(fd)->countItemsRecursively(includes, includefolders, includeadult);
-      result += subCount;
-      if (subCount > 1)
-        if (includefolders)
-          result++; // Include folders iif it contains more than one game.
-    }
-    else if (fd->isGame())
-    {
-      Filter current = Filter::None;
-      if (fd->Metadata().Hidden()) current |= Filter::Hidden;
-      if (fd->Metadata().Favorite()) current |= Filter::Favorite;
-      if (current == 0) current = Filter::Normal;
-      if ((current & includes) != 0 && (includeadult || !fd->Metadata().Adult()))
-        result++;
+      int subGames = 0;
+      int subFolders = CastFolder(fd)->countFoldersRecursively(index, includes, includeadult, subGames);
+      folders += subFolders;
+      if (subGames + subFolders > 1)
+        folders++; // Include folders iif it contains more than one game.
     }
-  }
-  return result;
+  return folders;
 }
 
-bool FolderData::hasGame() const 
+const GameIndex::Counters& FolderData::cachedCounters(const GameIndex& index) const
 {
-  for(FileData* fd : mChildren)
+  if (mCountersRevision != index.Revision())
   {
-    if (fd->isGame() || (fd->isFolder() && CastFolder(fd)->hasGame()))
-      return true;
+    index.Count(mIndexBegin, mIndexEnd, mCounters);
+    mCountersRevision = index.Revision();
   }
-  return false;
+  return mCounters;
 }
 
-bool FolderData::hasVisibleGame() const
+void FolderData::refreshIndex(GameIndex& index) const
 {
-  for (FileData* fd : mChildren)
+  const FolderData* top = this;
+  while (top->mParent != nullptr) top = top->mParent;
+  if (index.IsStale(*top))
   {
-    if ( (fd->isGame() && !fd->Metadata().Hidden()) || (fd->isFolder() && CastFolder(fd)->hasVisibleGame()))
-      return true;
+    index.Reset(*top);
+    top->indexRecursively(index);
   }
-  return false;
+}
+
+void FolderData::indexRecursively(GameIndex& index) const
+{
+  mIndexBegin = index.Size();
+  for (FileData* fd : mChildren)
+    if (fd->isFolder()) CastFolder(fd)->indexRecursively(index);
+    else if (fd->isGame())
+    {
+      // Games shared by virtual systems keep the slot of their own system
+      if (fd->mParent == this) fd->mIndexSlot = index.Size();
+      index.Add(*fd);
+    }
+  mIndexEnd = index.Size();
+}
+
+void FolderData::moveCountedGame(const GameIndex& index, int previousFlags, int flags)
+{
+  // Folders not counted since the last rebuild will count from the patched index
+  for (FolderData* folder = this; folder != nullptr; folder = folder->mParent)
+    if (folder->mCountersRevision == index.Revision())
+    {
+      folder->mCounters[previousFlags]--;
+      folder->mCounters[flags]++;
+    }
+}
+
+bool FolderData::hasGame() const
+{
+  GameIndex& index = mTopAncestor.System().HotIndex();
+  Mutex::AutoLock locker(index.Locker());
+  refreshIndex(index);
+  return GameIndex::Sum(cachedCounters(index), (int)Filter::All, true) != 0;
+}
+
+bool FolderData::hasVisibleGame() const
+{
+  GameIndex& index = mTopAncestor.System().HotIndex();
+  Mutex::AutoLock locker(index.Locker());
+  refreshIndex(index);
+  return GameIndex::HasVisible(cachedCounters(index));
 }
 
 bool FolderData::hasVisibleGameWithVideo() const
@@ -318,6 +589,79 @@ bool FolderData::hasVisibleGameWithVideo() const
     return false;
 }
 
+void FolderData::addMemoryUsageRecursively(MemoryUsage& usage, bool folders, bool games) const
+{
+  usage.Lists += mChildren.capacity() * sizeof(FileData*);
+  for (const FileData* fd : mChildren)
+    if (fd->isRoot()) ((const RootFolderData*)fd)->AddTreeMemoryUsage(usage);
+    else if (fd->isFolder())
+    {
+      if (folders)
+      {
+        fd->AddMemoryUsage(usage);
+        CastFolder(fd)->addMemoryUsageRecursively(usage, folders, games);
+      }
+    }
+    else if (games) fd->AddMemoryUsage(usage);
+}
+
+bool FolderData::visitGamesRecursively(IVisitor& visitor, Filter includes, bool includeadult) const
+{
+  for (FileData* fd : mChildren)
+    if (fd->isFolder())
+    {
+      if (!CastFolder(fd)->visitGamesRecursively(visitor, includes, includeadult)) return false;
+    }
+    else if (fd->isGame())
+    {
+      Filter current = Filter::None;
+      if (fd->Metadata().Hidden()) current |= Filter::Hidden;
+      if (fd->Metadata().Favorite()) current |= Filter::Favorite;
+      if (current == 0) current = Filter::Normal;
+      if ((current & includes) != 0 && (includeadult || !fd->Metadata().Adult()))
+        if (!visitor.Visit(*fd)) return false;
+    }
+  return true;
+}
+
+bool FolderData::visitGamesRecursively(IVisitor& visitor, IFilter* filter, bool includeadult) const
+{
+  for (FileData* fd : mChildren)
+    if (fd->isFolder())
+    {
+      if (!CastFolder(fd)->visitGamesRecursively(visitor, filter, includeadult)) return false;
+    }
+    else if (fd->isGame())
+      if (filter->ApplyFilter(*fd) && (includeadult || !fd->Metadata().Adult()))
+        if (!visitor.Visit(*fd)) return false;
+  return true;
+}
+
+bool FolderData::visitIndexedGames(IVisitor& visitor, const IFilter& filter, bool includeadult) const
+{
+  GameIndex& index = mTopAncestor.System().HotIndex();
+  Mutex::AutoLock locker(index.Locker());
+  refreshIndex(index);
+  const unsigned char* flags = index.Flags().data();
+  for (int i = mIndexBegin; i < mIndexEnd; ++i)
+    if ((includeadult || (flags[i] & GameIndex::FlagAdult) == 0) && filter.ApplyIndexFilter(index, i))
+      if (!visitor.Visit(*index.Games()[i])) return false;
+  return true;
+}
+
+bool FolderData::hasFilteredGameRecursively(IFilter* filter, bool includeadult) const
+{
+  for (FileData* fd : mChildren)
+    if (fd->isFolder())
+    {
+      if (CastFolder(fd)->hasFilteredGameRecursively(filter, includeadult)) return true;
+    }
+    else if (fd->isGame())
+      if (filter->ApplyFilter(*fd) && (includeadult || !fd->Metadata().Adult()))
+        return true;
+  return false;
+}
+
 int FolderData::getItems(FileData::List& to, Filter includes, bool includefolders, bool includeadult) const
 {
   int gameCount = 0;
@@ -345,7 +689,7 @@ int FolderData::getItems(FileData::List& to, Filter includes, bool includefolder
       if (isolatedFile != nullptr) to.push_back(isolatedFile);
       else
       if (includefolders)
-        if (folder->countItems(includes, includefolders, includeadult) > 0) // Only add if it contains at leas one game
+        if (folder->countItemsRecursively(includes, false, includeadult) > 0) // Only add if it contains at leas one game (cached count)
           to.push_back(fd);
     }
     else
@@ -391,7 +735,7 @@ int FolderData::countItems(Filter includes, bool includefolders, bool includeadu
       if (isolatedFile != nullptr) result++;
       else
         if (includefolders)
-          if (folder->countItems(includes, includefolders, includeadult) > 0) // Only add if it contains at leas one game
+          if (folder->countItemsRecursively(includes, false, includeadult) > 0) // Only add if it contains at leas one game (cached count)
             result++;
     }
     else if (fd->isGame())
@@ -436,7 +780,7 @@ FileData* FolderData::LookupGame(const std::string& item, SearchAttributes attri
   // Recursively look for the game in subfolders too
   for (FileData* fd : mChildren)
   {
-    std::string filename = path.empty() ? fd->getPath().ToString() : path + '/' + fd->getPath().Filename();
+    std::string filename = path.empty() ? fd->getPath().ToString() : path + '/' + fd->getRelativePath().Filename();
 
     if (fd->isFolder())
     {
@@ -455,7 +799,7 @@ FileData* FolderData::LookupGame(const std::string& item, SearchAttributes attri
           return fd;
       if ((attributes & SearchAttributes::ByName) != 0)
       {
-        filename = path.empty() ? fd->getPath().FilenameWithoutExtension() : path + '/' + fd->getPath().FilenameWithoutExtension();
+        filename = path.empty() ? fd->getPath().FilenameWithoutExtension() : path + '/' + fd->getRelativePath().FilenameWithoutExtension();
         if (strcasecmp(filename.c_str(), item.c_str()) == 0)
           return fd;
       }
@@ -491,13 +835,64 @@ void FolderData::Sort(FileData::List& items, FileData::Comparer comparer, bool a
 {
   if (items.size() > 1)
   {
-    if (ascending)
+    if (comparer == &FileSorts::compareFileName)
+      SortByName(items, ascending);
+    else if (ascending)
       QuickSortAscending(items, 0, (int)items.size() - 1, comparer);
     else
       QuickSortDescending(items, 0, (int)items.size() - 1, comparer);
   }
 }
 
+void FolderData::SortByName(FileData::List& items, bool ascending)
+{
+  // Folders first
+  FileData::List::iterator games = std::partition(items.begin(), items.end(), [](const FileData* item) { return item->getType() == ItemType::Folder; });
+  int folders = (int)(games - items.begin());
+
+  FileData::List temp(items.size());
+  RadixSortByKey(items.data(), temp.data(), folders, 0);
+  RadixSortByKey(items.data() + folders, temp.data(), (int)items.size() - folders, 0);
+
+  // Descending order is the exact reverse, including folders now last
+  if (!ascending) std::reverse(items.begin(), items.end());
+}
+
+void FolderData::RadixSortByKey(FileData** items, FileData** temp, int count, int depth)
+{
+  // Small ranges: insertion sort. Keys share their first bytes, so compare from there
+  if (count < 32)
+  {
+    for (int i = 1; i < count; ++i)
+    {
+      FileData* item = items[i];
+      const std::string& key = item->Metadata().SortKey();
+      int j = i;
+      for (; j > 0 && items[j - 1]->Metadata().SortKey().compare(depth, std::string::npos, key, depth, std::string::npos) > 0; --j)
+        items[j] = items[j - 1];
+      items[j] = item;
+    }
+    return;
+  }
+
+  // Bucket 0 holds keys ending here, others hold keys by their next byte
+  #define RadixBucket(item) ((int)(item)->Metadata().SortKey().size() > depth ? (unsigned char)(item)->Metadata().SortKey()[depth] + 1 : 0)
+  int offsets[257] = { 0 };
+  for (int i = count; --i >= 0; ) offsets[RadixBucket(items[i])]++;
+  for (int b = 1; b < 257; ++b) offsets[b] += offsets[b - 1];
+  // Backward scatter leaves each offset on its bucket start
+  for (int i = count; --i >= 0; ) temp[--offsets[RadixBucket(items[i])]] = items[i];
+  memcpy(items, temp, count * sizeof(FileData*));
+  #undef RadixBucket
+
+  // Keys of bucket 0 are all equal
+  for (int b = 1; b < 257; ++b)
+  {
+    int size = (b < 256 ? offsets[b + 1] : count) - offsets[b];
+    if (size > 1) RadixSortByKey(items + offsets[b], temp, size, depth + 1);
+  }
+}
+
 void FolderData::QuickSortAscending(FileData::List& items, int low, int high, FileData::Comparer comparer)
 {
   int Low = low, High = high;
@@ -550,9 +945,7 @@ bool FolderData::Contains(const FileData* item, bool recurse) const
 FileData::List FolderData::getFilteredItemsRecursively(IFilter* filter, bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItemsRecursively(Filter::All, includefolders, includeadult)); // Allocate once
   getItemsRecursively(result, filter, includefolders, includeadult);
-  result.shrink_to_fit();
 
   return result;
 }
@@ -560,7 +953,7 @@ FileData::List FolderData::getFilteredItemsRecursively(IFilter* filter, bool inc
 FileData::List FolderData::getFilteredItemsRecursively(Filter filters, bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItemsRecursively(filters, includefolders, includeadult)); // Allocate once
+  if (!includefolders) result.reserve((unsigned long)countItemsRecursively(filters, false, includeadult)); // Cached count, allocate once
   getItemsRecursively(result, filters, includefolders, includeadult);
 
   return result;
@@ -569,7 +962,7 @@ FileData::List FolderData::getFilteredItemsRecursively(Filter filters, bool incl
 FileData::List FolderData::getAllItemsRecursively(bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItemsRecursively(Filter::All, includefolders, includeadult)); // Allocate once
+  if (!includefolders) result.reserve((unsigned long)countItemsRecursively(Filter::All, false, includeadult)); // Cached count, allocate once
   getItemsRecursively(result, Filter::All, includefolders, includeadult);
 
   return result;
@@ -578,7 +971,7 @@ FileData::List FolderData::getAllItemsRecursively(bool includefolders, bool incl
 FileData::List FolderData::getAllDisplayableItemsRecursively(bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItemsRecursively(Filter::Normal | Filter::Favorite, includefolders, includeadult)); // Allocate once
+  if (!includefolders) result.reserve((unsigned long)countItemsRecursively(Filter::Normal | Filter::Favorite, false, includeadult)); // Cached count, allocate once
   getItemsRecursively(result, Filter::Normal | Filter::Favorite, includefolders, includeadult);
 
   return result;
@@ -587,7 +980,7 @@ FileData::List FolderData::getAllDisplayableItemsRecursively(bool includefolders
 FileData::List FolderData::getAllFavoritesRecursively(bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItemsRecursively(Filter::Favorite, includefolders, includeadult)); // Allocate once
+  if (!includefolders) result.reserve((unsigned long)countItemsRecursively(Filter::Favorite, false, includeadult)); // Cached count, allocate once
   getItemsRecursively(result, Filter::Favorite, includefolders, includeadult);
 
   return result;
@@ -596,7 +989,6 @@ FileData::List FolderData::getAllFavoritesRecursively(bool includefolders, bool
 FileData::List FolderData::getFilteredItems(Filter filters, bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItems(filters, includefolders, includeadult)); // Allocate once
   getItems(result, filters, includefolders, includeadult);
 
   return result;
@@ -605,7 +997,6 @@ FileData::List FolderData::getFilteredItems(Filter filters, bool includefolders,
 FileData::List FolderData::getAllItems(bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItems(Filter::All, includefolders, includeadult)); // Allocate once
   getItems(result, Filter::All, includefolders, includeadult);
 
   return result;
@@ -614,7 +1005,6 @@ FileData::List FolderData::getAllItems(bool includefolders, bool includeadult) c
 FileData::List FolderData::getAllDisplayableItems(bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItems(Filter::Normal | Filter::Favorite, includefolders, includeadult)); // Allocate once
   getItems(result, Filter::Normal | Filter::Favorite, includefolders, includeadult);
 
   return result;
@@ -623,7 +1013,6 @@ FileData::List FolderData::getAllDisplayableItems(bool includefolders, bool incl
 FileData::List FolderData::getAllFavorites(bool includefolders, bool includeadult) const
 {
   FileData::List result;
-  result.reserve((unsigned long)countItems(Filter::Favorite, includefolders, includeadult)); // Allocate once
   getItems(result, Filter::Favorite, includefolders, includeadult);
 
   return result;
@@ -641,23 +1030,6 @@ bool FolderData::IsDirty() const
   return false;
 }
 
-int FolderData::FastSearchText(const std::string& text, const std::string& into)
-{
-  const char* fdn = into.c_str();                        // Keep filedata name pointer for fast result computation
-  const char* tts = text.c_str();                        // Keep text pointer for fast search reset
-  int lmax = (int)into.size() - (int)text.size() + 1;    // MAximum byte to search in
-
-  for(const char* p = fdn - 1; --lmax >= 0; ++p)         // Run through the game name, straight forward
-    if ((*p | 0x20) == (*tts))                           // Try to catch the first char
-      for (const char* s = tts, *ip = p; ; )             // Got it, run through both string
-      {
-        const char c = *(++s);
-        if ((c != 0) && ((*(++ip) | 0x20) != c) ) break; // Chars are not equal, exit the inner loop
-        if (c == 0) return (int)(p - fdn);               // Chars are equal, got a zero terminal? Found it!
-      }
-  return -1;                                             // Nothing found
-}
-
 void FolderData::FastSearch(FastSearchContext context, const std::string& text, ResultList& results, int& remaining) const
 {
   for (FileData* fd : mChildren)
@@ -667,30 +1039,38 @@ void FolderData::FastSearch(FastSearchContext context, const std::string& text,
     else
     if (!fd->Metadata().Hidden())
     {
-      int distance = 0;
-      switch(context)
-      {
-        case FastSearchContext::Name       : distance = FastSearchText(text, fd->getName()); break;
-        case FastSearchContext::Path       : distance = FastSearchText(text, fd->getPath().ToString()); break;
-        case FastSearchContext::Description: distance = FastSearchText(text, fd->Metadata().Description()); break;
-        case FastSearchContext::Developer  : distance = FastSearchText(text, fd->Metadata().Developer()); break;
-        case FastSearchContext::Publisher  : distance = FastSearchText(text, fd->Metadata().Publisher()); break;
-        case FastSearchContext::All        :
-        {
-          distance = FastSearchText(text, fd->getName());
-          if (distance < 0) distance = FastSearchText(text, fd->getPath().ToString());
-          if (distance < 0) distance = FastSearchText(text, fd->Metadata().Description());
-          if (distance < 0) distance = FastSearchText(text, fd->Metadata().Developer());
-          if (distance < 0) distance = FastSearchText(text, fd->Metadata().Publisher());
-          break;
-        }
-      }
+      int distance = FastSearchGame(context, text, *fd);
       if (distance >= 0)
         if (--remaining > 0)
           results.push_back(FastSearchItem(distance, fd));
     }
 }
 
+int FolderData::FastSearchGame(FastSearchContext context, const std::string& text, const FileData& game)
+{
+  // Reused for every game searched by this thread
+  static thread_local std::string sPathStorage;
+  int distance = -1;
+  switch(context)
+  {
+    case FastSearchContext::Name       : distance = FastSearchKey(text, game.Metadata().SearchKey()); break;
+    case FastSearchContext::Path       : distance = FastSearchText(text, game.getPathString(sPathStorage)); break;
+    case FastSearchContext::Description: distance = FastSearchText(text, game.Metadata().Description()); break;
+    case FastSearchContext::Developer  : distance = FastSearchText(text, game.Metadata().Developer()); break;
+    case FastSearchContext::Publisher  : distance = FastSearchText(text, game.Metadata().Publisher()); break;
+    case FastSearchContext::All        :
+    {
+      distance = FastSearchKey(text, game.Metadata().SearchKey());
+      if (distance < 0) distance = FastSearchText(text, game.getPathString(sPathStorage));
+      if (distance < 0) distance = FastSearchText(text, game.Metadata().Description());
+      if (distance < 0) distance = FastSearchText(text, game.Metadata().Developer());
+      if (distance < 0) distance = FastSearchText(text, game.Metadata().Publisher());
+      break;
+    }
+  }
+  return distance;
+}
+
 int FolderData::getFoldersRecursivelyTo(FileData::List& to) const
 {
   if (isTopMostRoot())
@@ -2,18 +2,43 @@
 
 #include "FileData.h"
 #include "IFilter.h"
+#include "IVisitor.h"
+#include "GameIndex.h"
+#include "PathIndex.h"
+#include <utils/os/system/WorkStealingScheduler.h>
+#include <utils/SubstringSearch.h>
+
+// Forward declaration
+class ScanManifest;
 
 class FolderData : public FileData
 {
+  // Allow snapshots to run through the raw tree
+  friend class GamelistSnapshot;
+  // Allow games to update counters of their parents
+  friend class FileData;
+
   protected:
     //! Current folder child list
     FileData::List mChildren;
+    //! First game of the current folder in the hot metadata index
+    mutable int mIndexBegin;
+    //! Last game of the current folder in the hot metadata index, + 1
+    mutable int mIndexEnd;
+    //! Cached recursive game counts, by packed flags
+    mutable GameIndex::Counters mCounters;
+    //! Index revision of the cached counts
+    mutable int mCountersRevision;
 
     /*!
      * Constructor
      */
     FolderData(RootFolderData& topAncestor, const Path& startpath)
-      : FileData(ItemType::Root, startpath, topAncestor)
+      : FileData(ItemType::Root, startpath, topAncestor),
+        mIndexBegin(0),
+        mIndexEnd(0),
+        mCounters(),
+        mCountersRevision(-1)
     {
     }
 
@@ -21,7 +46,7 @@ class FolderData : public FileData
      * Clear the internal child lists without destroying them.
      * Used by inherited class that store children object without ownership
      */
-    void ClearChildList() { mChildren.clear(); }
+    void ClearChildList() { mChildren.clear(); treeChanged(); }
 
     /*!
      * @brief Clear the internal child list recusively but the folders
@@ -100,12 +125,164 @@ class FolderData : public FileData
     static void QuickSortDescending(FileData::List& items, int low, int high, FileData::Comparer comparer);
 
     /*!
-     * @brief Search text into the game name, returning the index of the text
-     * @param text text to search for
-     * @param fd FileData to search in
+     * @brief Sort items by name, folders first, as FileSorts::compareFileName does
+     * @param items Items to sort
+     * @param ascending True for ascending sort, false for descending.
+     */
+    static void SortByName(FileData::List& items, bool ascending);
+
+    /*!
+     * @brief MSD radix sort on name sort keys. Items must share the same first key bytes
+     * @param items Items to sort
+     * @param temp Temporary storage, at least count items large
+     * @param count Item count
+     * @param depth Key bytes already sorted
+     */
+    static void RadixSortByKey(FileData** items, FileData** temp, int count, int depth);
+
+    /*!
+     * @brief Search text into another text, folding ASCII case, returning the index of the text
+     * @param text Lowercase text to search for
+     * @param into Text to search in
      * @return Index of the text found, or -1
      */
-    static int FastSearchText(const std::string& text, const std::string& into);
+    static int FastSearchText(const std::string& text, const std::string& into) { return SubstringSearch::Find(text, into, true); }
+
+    /*!
+     * @brief Search a search key into another search key, returning the index of the key.
+     * Both keys are already folded (see Strings::ToSearchKey) so that they are compared byte per byte
+     * @param key Key to search for
+     * @param into Key to search in
+     * @return Index of the key found, or -1
+     */
+    static int FastSearchKey(const std::string& key, const std::string& into) { return SubstringSearch::Find(key, into, false); }
+
+    /*!
+     * @brief Create a game found while scanning
+     * @param root Root folder
+     * @param arena Arena to allocate items from
+     * @param filePath Game path
+     * @param items Scanned item list to add the game to
+     */
+    static void addScannedGame(RootFolderData& root, Arena& arena, const Path& filePath, FileData::List& items);
+
+    /*!
+     * @brief Create a sub-folder found while scanning and scan it, as a new task if a scheduler is available.
+     * The sub-folder must be removed from the item list if it does not contain any game once scanned
+     * @param root Root folder
+     * @param arena Arena to allocate items from
+     * @param folderPath Sub-folder path
+     * @param filteredExtensions Extension filter
+     * @param manifest Scan manifest
+     * @param scheduler Scheduler to run sub-folder scans on, or null to scan synchronously
+     * @param group Group to push the sub-folder scan into
+     * @param items Scanned item list to add the sub-folder to
+     * @param symLink True if the sub-folder is a symbolic link
+     */
+    static void addScannedFolder(RootFolderData& root, Arena& arena, const Path& folderPath, const std::string& filteredExtensions, ScanManifest& manifest,
+                                 WorkStealingScheduler* scheduler, WorkStealingScheduler::Group& group, FileData::List& items, bool symLink);
+
+    /*!
+     * @brief Scan the current folder, already known as a directory, and its sub-folders
+     * @param root Root folder
+     * @param arena Arena to allocate items from: the system arena, or a scratch arena for rescans
+     * @param filteredExtensions Extension filter
+     * @param manifest Scan manifest
+     * @param scheduler Scheduler to run sub-folder scans on, or null to scan synchronously
+     * @param symLink True if the current folder is a symbolic link
+     */
+    void scanFolder(RootFolderData& root, Arena& arena, const std::string& filteredExtensions, ScanManifest& manifest, WorkStealingScheduler* scheduler, bool symLink);
+
+    /*!
+     * @brief Check that the given folder and its sub-folders have not been modified since their last scan
+     * @param folderPath Folder path
+     * @param filteredExtensions Extension filter
+     * @param manifest Scan manifest
+     * @param symLink True if the folder is a symbolic link
+     * @return True if the manifest still reflects the whole folder tree
+     */
+    static bool isScanUpToDate(const Path& folderPath, const std::string& filteredExtensions, const ScanManifest& manifest, bool symLink);
+
+    /*!
+     * @brief Read the extension override from the .system.cfg file of the given folder
+     * @param folderPath Folder containing a .system.cfg file
+     * @param defaultExtensions Extensions to return if the file does not override them
+     * @return Extension filter
+     */
+    static std::string ReadSystemConfigExtensions(const Path& folderPath, const std::string& defaultExtensions);
+
+    /*!
+     * @brief Merge a fresh scan of the current folder into the current folder.
+     * New items are created again in the system arena, missing items are detached into the removed list.
+     * The scanned folder is left untouched, to be destroyed along with its scratch arena
+     * @param root Root folder
+     * @param scanned Fresh scan of the current folder
+     * @param removed List to add detached items to
+     * @return True if the current folder has been modified
+     */
+    bool mergeScannedFolder(RootFolderData& root, const FolderData& scanned, FileData::List& removed);
+
+    /*!
+     * @brief Create a copy of a scanned item and all its sub-items in the system arena
+     * @param root Root folder
+     * @param scanned Scanned item
+     * @return New item
+     */
+    static FileData* createScannedItem(RootFolderData& root, const FileData& scanned);
+
+    /*!
+     * @brief Rebuild the given hot metadata index from the topmost folder of the current tree, if it is out of date.
+     * The index lock must be held
+     * @param index Index to refresh
+     */
+    void refreshIndex(GameIndex& index) const;
+
+    /*!
+     * @brief Add all games of the current folder to the given index, in tree order, and record the folder range
+     * @param index Index to fill
+     */
+    void indexRecursively(GameIndex& index) const;
+
+    /*!
+     * @brief Get recursive game counts of the current folder, recomputed only when the index has changed.
+     * The index lock must be held and the index refreshed
+     * @param index Refreshed index
+     * @return Game counts by packed flags
+     */
+    const GameIndex::Counters& cachedCounters(const GameIndex& index) const;
+
+    /*!
+     * @brief Move a game from a flag counter to another in cached counts of the current folder and all its parents.
+     * The index lock must be held
+     * @param index Index the counts have been computed from
+     * @param previousFlags Previous packed flags of the game
+     * @param flags New packed flags of the game
+     */
+    void moveCountedGame(const GameIndex& index, int previousFlags, int flags);
+
+    /*!
+     * @brief Count sub-folders that would be listed as regular items, using the given index
+     * @param index Refreshed index
+     * @param includes Count only items matching these filters
+     * @param includeadult Include adult games
+     * @param games Filled with the amount of matching games in the current folder
+     * @return Amount of listed sub-folders
+     */
+    int countFoldersRecursively(const GameIndex& index, Filter includes, bool includeadult, int& games) const;
+
+    /*!
+     * @brief Add the heap memory used by child lists and owned descendants
+     * Sub-roots are always owned, and counted according to their own ownership
+     * @param usage Memory usage to update
+     * @param folders Count sub-folders
+     * @param games Count games
+     */
+    void addMemoryUsageRecursively(MemoryUsage& usage, bool folders, bool games) const;
+
+    /*!
+     * @brief Record an item addition or removal in this tree
+     */
+    void treeChanged() const;
 
   public:
     typedef std::vector<FolderData*> List;
@@ -139,7 +316,11 @@ class FolderData : public FileData
      * Constructor
      */
     FolderData(const Path& startpath, RootFolderData& topAncestor)
-      : FileData(ItemType::Folder, startpath, topAncestor)
+      : FileData(ItemType::Folder, startpath, topAncestor),
+        mIndexBegin(0),
+        mIndexEnd(0),
+        mCounters(),
+        mCountersRevision(-1)
     {
     }
 
@@ -159,6 +340,32 @@ class FolderData : public FileData
      * @param file Item to remove
      */
     void removeChild(FileData* file);
+    /*!
+     * Remove games matching the given filter, recursively. Removed games are not destroyed
+     * @param filter Filter to apply
+     * @return Number of removed games
+     */
+    int removeFilteredGamesRecursively(IFilter* filter);
+
+    /*!
+     * Scan the current folder again and apply differences to the current tree.
+     * Removed items are detached but not destroyed, since they may be referenced elsewhere
+     * @param root Root folder
+     * @param filteredExtensions Extension filter of the current folder
+     * @param removed List to add detached items to
+     * @return True if the tree has been modified
+     */
+    bool refreshFolder(RootFolderData& root, const std::string& filteredExtensions, FileData::List& removed);
+
+    /*!
+     * Get the extension filter inherited by the given folder, applying .system.cfg overrides
+     * of its ancestors, from the root down to its parent
+     * @param root Root folder
+     * @param folderPath Folder path, inside the root
+     * @param extensions Extension filter of the system
+     * @return Extension filter
+     */
+    static std::string GetFolderExtensions(const RootFolderData& root, const Path& folderPath, const std::string& extensions);
 
     /*!
      * Return true if this FileData is a folder and has at lease one child
@@ -171,8 +378,22 @@ class FolderData : public FileData
      * @param filteredExtensions Filter files that do not match this extension list (casee sensitive)
      * @param systemData System to attach to
      * @param doppelgangerWatcher Map used to check duplicate games
+     * @param manifest Previous scan results, used to skip unmodified folders and updated with the current scan
+     * @param scheduler Scheduler to scan sub-folders in parallel, or null to scan synchronously
      */
-    void populateRecursiveFolder(RootFolderData& root, const std::string& filteredExtensions, FileData::StringMap& doppelgangerWatcher);
+    void populateRecursiveFolder(RootFolderData& root, const std::string& filteredExtensions, PathIndex& doppelgangerWatcher, ScanManifest& manifest, WorkStealingScheduler* scheduler);
+
+    /*!
+     * @brief Check that no folder has been modified since the last scan, without listing any of them
+     * @param filteredExtensions Filter files that do not match this extension list
+     * @param manifest Loaded scan manifest
+     * @return True if a scan would give the same result as the last one
+     */
+    bool isScanUpToDate(const std::string& filteredExtensions, const ScanManifest& manifest) const
+    {
+      const Path folderPath = getPath();
+      return isScanUpToDate(folderPath, filteredExtensions, manifest, folderPath.IsSymLink());
+    }
 
     /*!
      * Get next favorite game, starting from the reference entry
@@ -205,6 +426,13 @@ class FolderData : public FileData
      */
     bool hasVisibleGameWithVideo() const;
 
+    /*!
+     * Return true if contain at least one game matching the given filter. Stop at the first one
+     * @param filter Filter to apply
+     * @param includeadult True to include adult games
+     */
+    bool hasFilteredGameRecursively(IFilter* filter, bool includeadult) const;
+
     /*!
      * Get total games in all folders, including hidden
      * @param includefolders True to include subfolders in the result
@@ -241,7 +469,7 @@ class FolderData : public FileData
     bool Contains(const FileData* item, bool recurse) const;
 
     /*!
-     * Quick sort items in the given list.
+     * Quick sort items in the given list. Name sorts use a radix sort.
      * @param items Items to sort
      * @param comparer Comparison function
      * @param ascending True for ascending sort, false for descending.
@@ -347,6 +575,30 @@ class FolderData : public FileData
      * @return Total amount of items (not including folders!)
      */
     int getItemsRecursivelyTo(FileData::List& to, Filter includes, bool includefolders, bool includeadult) const;
+    /*!
+     * Visit games recursively, without building any list
+     * @param visitor Visitor called for each matching game
+     * @param includes Visit only games matching these filters
+     * @param includeadult True to include adult games
+     * @return False if the visitor stopped the walk
+     */
+    bool visitGamesRecursively(IVisitor& visitor, Filter includes, bool includeadult) const;
+    /*!
+     * Visit games recursively, without building any list
+     * @param visitor Visitor called for each matching game
+     * @param filter Visit only games accepted by this filter
+     * @param includeadult True to include adult games
+     * @return False if the visitor stopped the walk
+     */
+    bool visitGamesRecursively(IVisitor& visitor, IFilter* filter, bool includeadult) const;
+    /*!
+     * Visit games recursively, scanning the hot metadata index instead of the tree
+     * @param visitor Visitor called for each matching game. The index lock is held meanwhile
+     * @param filter Visit only games accepted by this filter, through IFilter::ApplyIndexFilter
+     * @param includeadult True to include adult games
+     * @return False if the visitor stopped the walk
+     */
+    bool visitIndexedGames(IVisitor& visitor, const IFilter& filter, bool includeadult) const;
     /*!
      * Get all items - Root hierarchy aware methods!
      * @param to List to fill
@@ -368,7 +620,7 @@ class FolderData : public FileData
      * @param doppelganger Map to fill in
      * @param includefolder include folder or not
      */
-    void BuildDoppelgangerMap(FileData::StringMap& doppelganger, bool includefolder) const;
+    void BuildDoppelgangerMap(PathIndex& doppelganger, bool includefolder) const;
 
     /*!
      * @brief Search for all games containing 'text' and add them to 'result'
@@ -378,6 +630,15 @@ class FolderData : public FileData
      * @param remaining Maximum results
      */
     void FastSearch(FastSearchContext context, const std::string& text, ResultList& results, int& remaining) const;
+
+    /*!
+     * @brief Search text into a single game
+     * @param context Field in which to search text for
+     * @param text Text to search for, as a search key
+     * @param game Game to search in
+     * @return Index of the text found, or -1
+     */
+    static int FastSearchGame(FastSearchContext context, const std::string& text, const FileData& game);
 };
 
 
@@ -0,0 +1,121 @@
+#include "GameIndex.h"
+#include "FileData.h"
+
+std::atomic<int> GameIndex::sSharedRevision(0);
+
+void GameIndex::Reset(const FolderData& root)
+{
+  mGames.clear();
+  mFlags.clear();
+  mGenreIds.clear();
+  mPlayers.clear();
+  mLastPlayed.clear();
+  mRoot = &root;
+  // Read the revision before the tree is walked, so that concurrent modifications trigger a new rebuild
+  mRevision = DataRevision();
+}
+
+unsigned char GameIndex::FlagsOf(const FileData& game)
+{
+  const MetadataDescriptor& metadata = game.Metadata();
+  return (unsigned char)((metadata.Hidden() ? FlagHidden : 0) |
+                         (metadata.Favorite() ? FlagFavorite : 0) |
+                         (metadata.Adult() ? FlagAdult : 0));
+}
+
+void GameIndex::Add(FileData& game)
+{
+  const MetadataDescriptor& metadata = game.Metadata();
+  mGames.push_back(&game);
+  mFlags.push_back(FlagsOf(game));
+  mGenreIds.push_back((unsigned short)metadata.GenreId());
+  mPlayers.push_back(metadata.PlayerRange());
+  mLastPlayed.push_back(metadata.LastPlayedEpoc());
+}
+
+bool GameIndex::Patch(const FileData& game, int slot, int& previousFlags)
+{
+  // Shared indexes holding this game are rebuilt
+  sSharedRevision.fetch_add(1, std::memory_order_relaxed);
+
+  if (mRevision != DataRevision()) return false;
+  if ((unsigned int)slot >= (unsigned int)mGames.size() || mGames[slot] != &game)
+  {
+    // Not indexed here: rebuild to be safe
+    mDataRevision.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  const MetadataDescriptor& metadata = game.Metadata();
+  previousFlags = mFlags[slot];
+  mFlags[slot] = FlagsOf(game);
+  mGenreIds[slot] = (unsigned short)metadata.GenreId();
+  mPlayers[slot] = metadata.PlayerRange();
+  mLastPlayed[slot] = metadata.LastPlayedEpoc();
+  return true;
+}
+
+void GameIndex::BuildMatchTable(int includes, bool includeadult, unsigned char (&match)[FlagAll + 1])
+{
+  for (int flags = 0; flags <= FlagAll; ++flags)
+  {
+    int current = 0;
+    if ((flags & FlagHidden) != 0) current |= (int)FileData::Filter::Hidden;
+    if ((flags & FlagFavorite) != 0) current |= (int)FileData::Filter::Favorite;
+    if (current == 0) current = (int)FileData::Filter::Normal;
+    match[flags] = (unsigned char)((current & includes) != 0 && (includeadult || (flags & FlagAdult) == 0));
+  }
+}
+
+void GameIndex::Count(int begin, int end, Counters& counters) const
+{
+  for (int& counter : counters) counter = 0;
+  const unsigned char* flags = mFlags.data();
+  for (int i = begin; i < end; ++i)
+    counters[flags[i]]++;
+}
+
+int GameIndex::Sum(const Counters& counters, int includes, bool includeadult)
+{
+  unsigned char match[FlagAll + 1];
+  BuildMatchTable(includes, includeadult, match);
+
+  int count = 0;
+  for (int flags = 0; flags <= FlagAll; ++flags)
+    if (match[flags] != 0)
+      count += counters[flags];
+  return count;
+}
+
+bool GameIndex::HasVisible(const Counters& counters)
+{
+  for (int flags = 0; flags <= FlagAll; ++flags)
+    if ((flags & FlagHidden) == 0 && counters[flags] != 0)
+      return true;
+  return false;
+}
+
+size_t GameIndex::MemoryUsage() const
+{
+  return mGames.capacity()      * sizeof(FileData*) +
+         mFlags.capacity()      * sizeof(unsigned char) +
+         mGenreIds.capacity()   * sizeof(unsigned short) +
+         mPlayers.capacity()    * sizeof(int) +
+         mLastPlayed.capacity() * sizeof(unsigned int);
+}
+
+int GameIndex::Get(std::vector<FileData*>& to, int begin, int end, int includes, bool includeadult) const
+{
+  unsigned char match[FlagAll + 1];
+  BuildMatchTable(includes, includeadult, match);
+
+  const unsigned char* flags = mFlags.data();
+  int count = 0;
+  for (int i = begin; i < end; ++i)
+    if (match[flags[i]] != 0)
+    {
+      to.push_back(mGames[i]);
+      count++;
+    }
+  return count;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <utils/os/system/Mutex.h>
+
+// Forward declarations
+class FileData;
+class FolderData;
+
+/*!
+ * @brief Packed index of the most used game metadata, stored as a structure of arrays
+ *
+ * Games are indexed in tree order, so that each folder covers a contiguous range of the index.
+ * Filters and counts are then simple scans of small contiguous arrays instead of walks through
+ * every item and its metadata. Only fields read by collection filters (IFilter::ApplyIndexFilter) are indexed.
+ * Each system owns its index and its revision: tree modifications and bulk metadata loads bump
+ * the revision, and the index is rebuilt lazily on the next query. Single game modifications
+ * patch the game slot in place.
+ * Indexes of virtual systems hold games of other systems: they are also rebuilt when any other
+ * index changes.
+ */
+class GameIndex
+{
+  public:
+    //! Packed flags
+    enum Flags : unsigned char
+    {
+      FlagHidden   = 1, //!< Hidden game
+      FlagFavorite = 2, //!< Favorite game
+      FlagAdult    = 4, //!< Adult game
+      FlagAll      = 7, //!< All flags
+    };
+
+    /*!
+     * @brief Constructor
+     * @param shared True if the index holds games of other systems
+     */
+    explicit GameIndex(bool shared)
+      : mRoot(nullptr)
+      , mRevision(-1)
+      , mDataRevision(0)
+      , mShared(shared)
+    {
+    }
+
+    /*!
+     * @brief Invalidate the index. Must be called on any tree modification or bulk metadata modification
+     */
+    void Invalidate()
+    {
+      mDataRevision.fetch_add(1, std::memory_order_relaxed);
+      sSharedRevision.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief Get the shared revision, bumped on any modification of any index
+     * @return Shared revision
+     */
+    static int SharedRevision() { return sSharedRevision.load(std::memory_order_relaxed); }
+
+    /*!
+     * @brief Check if the index must be rebuilt for the given tree
+     * @param root Topmost folder of the tree
+     * @return True if the index is out of date
+     */
+    bool IsStale(const FolderData& root) const { return &root != mRoot || mRevision != DataRevision(); }
+
+    /*!
+     * @brief Reset the index before a rebuild
+     * @param root Topmost folder of the tree
+     */
+    void Reset(const FolderData& root);
+
+    /*!
+     * @brief Append a game
+     * @param game Game to index
+     */
+    void Add(FileData& game);
+
+    /*!
+     * @brief Update the slot of a single game from its metadata, if the index is up to date.
+     * The index lock must be held
+     * @param game Modified game
+     * @param slot Game slot, recorded when the index has been built
+     * @param previousFlags Filled with the packed flags of the game before the update
+     * @return True if the slot has been updated, false if the index will be rebuilt anyway
+     */
+    bool Patch(const FileData& game, int slot, int& previousFlags);
+
+    /*!
+     * @brief Get packed flags from game metadata
+     * @param game Game
+     * @return Packed flags
+     */
+    static unsigned char FlagsOf(const FileData& game);
+
+    //! Game counts by packed flags
+    typedef int Counters[FlagAll + 1];
+
+    /*!
+     * @brief Count games of the given range by packed flags
+     * @param begin First index
+     * @param end Last index + 1
+     * @param counters Counters to fill
+     */
+    void Count(int begin, int end, Counters& counters) const;
+
+    /*!
+     * @brief Sum counters matching the given flags
+     * @param counters Game counts by packed flags
+     * @param includes Filter mask (FileData::Filter)
+     * @param includeadult Include adult games
+     * @return Game count
+     */
+    static int Sum(const Counters& counters, int includes, bool includeadult);
+
+    /*!
+     * @brief Check if counters include at least one visible (non hidden) game
+     * @param counters Game counts by packed flags
+     * @return True if a visible game exists
+     */
+    static bool HasVisible(const Counters& counters);
+
+    /*!
+     * @brief Get games of the given range, matching the given flags
+     * @param to List to fill
+     * @param begin First index
+     * @param end Last index + 1
+     * @param includes Filter mask (FileData::Filter)
+     * @param includeadult Include adult games
+     * @return Game count
+     */
+    int Get(std::vector<FileData*>& to, int begin, int end, int includes, bool includeadult) const;
+
+    //! Get index size
+    int Size() const { return (int)mGames.size(); }
+    //! Get the memory used by the index arrays, in bytes
+    size_t MemoryUsage() const;
+    //! Get the revision of the indexed data
+    int Revision() const { return mRevision; }
+    //! Get index lock
+    Mutex& Locker() { return mLocker; }
+
+    /*
+     * Packed arrays
+     */
+
+    const std::vector<FileData*>&       Games()      const { return mGames;      }
+    const std::vector<unsigned char>&  Flags()      const { return mFlags;      }
+    const std::vector<unsigned short>& GenreIds()   const { return mGenreIds;   }
+    const std::vector<int>&            Players()    const { return mPlayers;    }
+    const std::vector<unsigned int>&   LastPlayed() const { return mLastPlayed; }
+
+  private:
+    //! Shared revision, bumped on any modification of any index
+    static std::atomic<int> sSharedRevision;
+
+    //! Games
+    std::vector<FileData*> mGames;
+    //! Hidden/Favorite/Adult flags
+    std::vector<unsigned char> mFlags;
+    //! Normalized genres (GameGenres fit in 16 bits) - Genre collections
+    std::vector<unsigned short> mGenreIds;
+    //! Player ranges - Multiplayer collection
+    std::vector<int> mPlayers;
+    //! Last played dates (epoch) - Last played collection
+    std::vector<unsigned int> mLastPlayed;
+
+    //! Indexed tree
+    const FolderData* mRoot;
+    //! Revision of the indexed data
+    int mRevision;
+    //! Revision of the source data, bumped on each invalidation
+    std::atomic<int> mDataRevision;
+    //! True if the index holds games of other systems
+    bool mShared;
+    //! Lock
+    Mutex mLocker;
+
+    /*!
+     * @brief Get the revision of the source data
+     * @return Own revision, plus the shared revision for shared indexes
+     */
+    int DataRevision() const
+    {
+      return mDataRevision.load(std::memory_order_relaxed) + (mShared ? sSharedRevision.load(std::memory_order_relaxed) : 0);
+    }
+
+    /*!
+     * @brief Build the lookup table of matching flags
+     * @param includes Filter mask (FileData::Filter)
+     * @param includeadult Include adult games
+     * @param match Table to fill, indexed by packed flags
+     */
+    static void BuildMatchTable(int includes, bool includeadult, unsigned char (&match)[FlagAll + 1]);
+};
@@ -0,0 +1,156 @@
+#include "GamelistSnapshot.h"
+#include "RootFolderData.h"
+#include "ScanManifest.h"
+#include "systems/SystemData.h"
+#include <utils/Log.h>
+#include <utils/Strings.h>
+
+GamelistSnapshot::GamelistSnapshot(RootFolderData& root, unsigned int configuration)
+  : mRoot(root),
+    mFile(BuildSnapshotPath(root.getPath())),
+    mConfiguration(configuration)
+{
+}
+
+Path GamelistSnapshot::BuildSnapshotPath(const Path& root)
+{
+  std::string name = Strings::Replace(root.ToString(), "/", "_");
+  return Path(sSnapshotFolder) / name.append(".snapshot");
+}
+
+GamelistSnapshot::Fingerprint GamelistSnapshot::CurrentFingerprint() const
+{
+  // Any scan that finds a modification rewrites the manifest
+  return GamelistSnapshotFile::BuildFingerprint(SystemData::getGamelistPath(mRoot, false),
+                                                SystemData::getGamelistJournalPath(mRoot),
+                                                mRoot.getPath(),
+                                                ScanManifest(mRoot.getPath()).FileTime(),
+                                                mConfiguration);
+}
+
+bool GamelistSnapshot::IsUpToDate() const
+{
+  return mFile.IsUpToDate(CurrentFingerprint());
+}
+
+bool GamelistSnapshot::Load()
+{
+  // Only load into fresh roots
+  if (mRoot.hasChildren()) return false;
+
+  if (!mFile.Map(CurrentFingerprint())) return false;
+  bool result = BuildTree();
+  mFile.Unmap();
+  return result;
+}
+
+bool GamelistSnapshot::BuildTree()
+{
+  int count = mFile.RecordCount();
+  const Record* records = mFile.Records();
+
+  // Build
+  std::vector<FolderData*> folders((size_t)count, nullptr);
+  FolderData& root = mRoot;
+  Arena& arena = mRoot.System().ItemArena();
+  for (int i = 0; i < count; ++i)
+  {
+    const Record& record = records[i];
+    // Items outside the root folder are stored with their absolute path
+    std::string storedPath = mFile.String(record, Texts::Path);
+    Path path = !storedPath.empty() && storedPath[0] == '/' ? Path(storedPath) : mRoot.getPath() / storedPath;
+    FileData* item = nullptr;
+    if (record.Type == ItemType::Folder) item = folders[i] = new (arena) FolderData(path, mRoot);
+    else item = new (arena) FileData(path, mRoot);
+
+    MetadataDescriptor& metadata = item->Metadata();
+    metadata.mName = mFile.String(record, Texts::Name);
+    metadata.UpdateNameKeys();
+    metadata.mDescription = mFile.String(record, Texts::Description);
+    metadata.mImage = mFile.String(record, Texts::Image);
+    MetadataDescriptor::AssignPString(metadata.mDeveloper, mFile.String(record, Texts::Developer));
+    MetadataDescriptor::AssignPString(metadata.mPublisher, mFile.String(record, Texts::Publisher));
+    MetadataDescriptor::AssignPPath(metadata.mThumbnail, Path(mFile.String(record, Texts::Thumbnail)));
+    MetadataDescriptor::AssignPPath(metadata.mVideo, Path(mFile.String(record, Texts::Video)));
+    MetadataDescriptor::AssignPString(metadata.mGenre, mFile.String(record, Texts::Genre));
+    MetadataDescriptor::AssignPString(metadata.mEmulator, mFile.String(record, Texts::Emulator));
+    MetadataDescriptor::AssignPString(metadata.mCore, mFile.String(record, Texts::Core));
+    MetadataDescriptor::AssignPString(metadata.mRatio, mFile.String(record, Texts::Ratio));
+    metadata.mRating = record.Rating;
+    metadata.mGenreId = (GameGenres)record.GenreId;
+    metadata.mRegion = record.Region;
+    metadata.mPlayers = record.Players;
+    metadata.mReleaseDate = record.ReleaseDate;
+    metadata.mPlaycount = record.Playcount;
+    metadata.mLastPlayed = record.LastPlayed;
+    metadata.mRomCrc32 = record.RomCrc32;
+    metadata.mFavorite = (record.Flags & GamelistSnapshotFile::FlagFavorite) != 0;
+    metadata.mHidden = (record.Flags & GamelistSnapshotFile::FlagHidden) != 0;
+    metadata.mAdult = (record.Flags & GamelistSnapshotFile::FlagAdult) != 0;
+    metadata.mDirty = (record.Flags & GamelistSnapshotFile::FlagDirty) != 0;
+
+    FolderData& parent = record.Parent < 0 ? root : *folders[record.Parent];
+    parent.addChild(item, true);
+  }
+
+  return true;
+}
+
+void GamelistSnapshot::SerializeFolder(const FolderData& folder, int parent, std::string& records, std::string& pool, bool synchronized) const
+{
+  for (const FileData* item : folder.mChildren)
+  {
+    if (item->isRoot() || item->isEmpty()) continue; // Sub-roots have their own snapshots
+
+    const MetadataDescriptor& metadata = item->Metadata();
+    Record record = {};
+    record.Parent = parent;
+    record.Type = item->getType();
+    record.Flags = (char)((metadata.mFavorite ? GamelistSnapshotFile::FlagFavorite : 0) |
+                          (metadata.mHidden ? GamelistSnapshotFile::FlagHidden : 0) |
+                          (metadata.mAdult ? GamelistSnapshotFile::FlagAdult : 0) |
+                          (metadata.mDirty && !synchronized ? GamelistSnapshotFile::FlagDirty : 0));
+    record.Rating = metadata.mRating;
+    record.GenreId = (int)metadata.mGenreId;
+    record.Region = metadata.mRegion;
+    record.Players = metadata.mPlayers;
+    record.ReleaseDate = metadata.mReleaseDate;
+    record.Playcount = metadata.mPlaycount;
+    record.LastPlayed = metadata.mLastPlayed;
+    record.RomCrc32 = metadata.mRomCrc32;
+    record.Strings[(int)Texts::Path] = GamelistSnapshotFile::Store(pool, item->getRelativePath().ToString());
+    record.Strings[(int)Texts::Name] = GamelistSnapshotFile::Store(pool, metadata.mName);
+    record.Strings[(int)Texts::Description] = GamelistSnapshotFile::Store(pool, metadata.mDescription);
+    record.Strings[(int)Texts::Image] = GamelistSnapshotFile::Store(pool, metadata.mImage.ToString());
+    record.Strings[(int)Texts::Thumbnail] = GamelistSnapshotFile::Store(pool, MetadataDescriptor::ReadPPath(metadata.mThumbnail, Path::Empty).ToString());
+    record.Strings[(int)Texts::Video] = GamelistSnapshotFile::Store(pool, MetadataDescriptor::ReadPPath(metadata.mVideo, Path::Empty).ToString());
+    record.Strings[(int)Texts::Developer] = GamelistSnapshotFile::Store(pool, metadata.Developer());
+    record.Strings[(int)Texts::Publisher] = GamelistSnapshotFile::Store(pool, metadata.Publisher());
+    record.Strings[(int)Texts::Genre] = GamelistSnapshotFile::Store(pool, MetadataDescriptor::ReadPString(metadata.mGenre, MetadataDescriptor::DefaultValueEmpty));
+    record.Strings[(int)Texts::Emulator] = GamelistSnapshotFile::Store(pool, MetadataDescriptor::ReadPString(metadata.mEmulator, MetadataDescriptor::DefaultValueEmpty));
+    record.Strings[(int)Texts::Core] = GamelistSnapshotFile::Store(pool, MetadataDescriptor::ReadPString(metadata.mCore, MetadataDescriptor::DefaultValueEmpty));
+    record.Strings[(int)Texts::Ratio] = GamelistSnapshotFile::Store(pool, MetadataDescriptor::ReadPString(metadata.mRatio, MetadataDescriptor::DefaultValueEmpty));
+
+    int index = (int)(records.size() / sizeof(Record));
+    records.append((const char*)&record, sizeof(record));
+
+    if (item->isFolder())
+      SerializeFolder(*(const FolderData*)item, index, records, pool, synchronized);
+  }
+}
+
+bool GamelistSnapshot::Save(bool synchronized) const
+{
+  try
+  {
+    std::string records;
+    std::string pool;
+    SerializeFolder(mRoot, -1, records, pool, synchronized);
+    return mFile.Save(CurrentFingerprint(), records, pool);
+  }
+  catch (std::exception& ex)
+  {
+    LOG(LogError) << "[Snapshot] Error saving " << mFile.FilePath().ToString() << " : " << ex.what();
+  }
+  return false;
+}
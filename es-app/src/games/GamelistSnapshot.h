@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <utils/os/fs/Path.h>
+#include "GamelistSnapshotFile.h"
+
+// Forward declarations
+class RootFolderData;
+class FolderData;
+class FileData;
+
+/*!
+ * @brief Binary image of a root folder tree (folders, games & metadata)
+ *
+ * Parsing gamelist.xml and scanning rom folders is by far the slowest part of the startup.
+ * Once gamelists are saved, the complete tree of each root is dumped into a flat binary file
+ * stored next to the system weight file. On the next startup, if neither the gamelist nor the
+ * rom folder have been modified since, the file is memory-mapped and the tree is rebuilt
+ * straight from the records, without any XML parsing nor file system scanning.
+ * Sub-folders are checked by the caller against the scan manifest, and the snapshot is dropped
+ * as soon as a new scan updates the manifest.
+ */
+class GamelistSnapshot
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param root Root folder to load/save
+     * @param configuration Configuration key. A snapshot saved with a different key is considered stale
+     */
+    GamelistSnapshot(RootFolderData& root, unsigned int configuration);
+
+    /*!
+     * @brief Check if the snapshot file exists and matches the current gamelist & rom folder states
+     * @return True if the snapshot is up to date
+     */
+    bool IsUpToDate() const;
+
+    /*!
+     * @brief Load the snapshot into the root folder, if and only if it is up to date.
+     * The root must be empty
+     * @return True if the tree has been loaded. False if the snapshot is stale, missing or corrupted
+     */
+    bool Load();
+
+    /*!
+     * @brief Save the current root tree into the snapshot file
+     * @param synchronized True if the gamelist has just been written from the current tree,
+     * so that all items can be stored as clean
+     * @return True if the snapshot has been written successfully
+     */
+    bool Save(bool synchronized) const;
+
+    /*!
+     * @brief Delete the snapshot file, if any
+     */
+    void Delete() const { mFile.Delete(); }
+
+  private:
+    //! Snapshot folder, next to the system weight file
+    static constexpr const char* sSnapshotFolder = "/recalbox/share/system/.emulationstation/snapshots";
+
+    // Record format
+    typedef GamelistSnapshotFile::Texts Texts;
+    typedef GamelistSnapshotFile::Record Record;
+    typedef GamelistSnapshotFile::Fingerprint Fingerprint;
+
+    //! Root folder
+    RootFolderData& mRoot;
+    //! Snapshot file
+    GamelistSnapshotFile mFile;
+    //! Configuration key
+    unsigned int mConfiguration;
+
+    /*!
+     * @brief Build the fingerprint of the current sources
+     * @return Fingerprint
+     */
+    Fingerprint CurrentFingerprint() const;
+
+    /*!
+     * @brief Build the tree from the mapped records
+     * @return True if all records have been processed successfully
+     */
+    bool BuildTree();
+
+    /*!
+     * @brief Add records of the given folder's children, recursively
+     * @param folder Folder to serialize
+     * @param parent Parent record index
+     * @param records Record list to fill in
+     * @param pool String pool to fill in
+     * @param synchronized True to store all items as clean
+     */
+    void SerializeFolder(const FolderData& folder, int parent, std::string& records, std::string& pool, bool synchronized) const;
+
+    /*!
+     * @brief Build the snapshot file path from the root folder path
+     * @param root Root folder path
+     * @return Snapshot file path
+     */
+    static Path BuildSnapshotPath(const Path& root);
+};
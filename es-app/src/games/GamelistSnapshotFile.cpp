@@ -0,0 +1,159 @@
+#include "GamelistSnapshotFile.h"
+#include <utils/Log.h>
+#include <utils/Files.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+GamelistSnapshotFile::GamelistSnapshotFile(const Path& path)
+  : mPath(path),
+    mMap(nullptr),
+    mMapSize(0),
+    mRecords(nullptr),
+    mPool(nullptr),
+    mRecordCount(0),
+    mPoolSize(0)
+{
+}
+
+GamelistSnapshotFile::Fingerprint GamelistSnapshotFile::BuildFingerprint(const Path& gamelist, const Path& journal, const Path& romFolder, long long manifestTime, unsigned int configuration)
+{
+  Fingerprint result = { 0, 0, 0, manifestTime, configuration, 0 };
+
+  if (gamelist.Exists())
+  {
+    result.GamelistTime = gamelist.LastModificationTime();
+    result.GamelistSize = gamelist.Size();
+  }
+  // Journaled changes do not touch the gamelist
+  if (journal.Exists())
+    result.GamelistSize += journal.Size();
+  result.RomFolderTime = romFolder.LastModificationTime();
+
+  return result;
+}
+
+bool GamelistSnapshotFile::ReadHeader(Header& header) const
+{
+  int fd = open(mPath.ToChars(), O_RDONLY);
+  if (fd < 0) return false;
+  bool ok = (read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header));
+  close(fd);
+
+  return ok && header.Magic == sMagic && header.Version == sVersion;
+}
+
+bool GamelistSnapshotFile::IsUpToDate(const Fingerprint& source) const
+{
+  Header header = {};
+  if (!ReadHeader(header)) return false;
+  return header.Source == source;
+}
+
+bool GamelistSnapshotFile::Save(const Fingerprint& source, const std::string& records, const std::string& pool) const
+{
+  Header header = {};
+  header.Magic = sMagic;
+  header.Version = sVersion;
+  header.Source = source;
+  header.RecordCount = (unsigned int)(records.size() / sizeof(Record));
+  header.PoolSize = (unsigned int)pool.size();
+
+  std::string content;
+  content.reserve(sizeof(Header) + records.size() + pool.size());
+  content.append((const char*)&header, sizeof(header))
+         .append(records)
+         .append(pool);
+
+  // Write aside and rename, so that a reader never gets a partial file
+  mPath.Directory().CreatePath();
+  Path temporary(mPath.ToString() + ".tmp");
+  if (Files::SaveFile(temporary, content) && Path::Rename(temporary, mPath))
+  {
+    LOG(LogDebug) << "[Snapshot] " << header.RecordCount << " items saved into " << mPath.ToString();
+    return true;
+  }
+  temporary.Delete();
+  LOG(LogError) << "[Snapshot] Cannot save " << mPath.ToString();
+  return false;
+}
+
+bool GamelistSnapshotFile::Map(const Fingerprint& source)
+{
+  Unmap();
+
+  int fd = open(mPath.ToChars(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat64 info = {};
+  if (fstat64(fd, &info) != 0 || info.st_size < (long long)sizeof(Header))
+  {
+    close(fd);
+    return false;
+  }
+
+  size_t size = (size_t)info.st_size;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps its own reference on the file
+  if (map == MAP_FAILED)
+  {
+    LOG(LogError) << "[Snapshot] Cannot map " << mPath.ToString();
+    return false;
+  }
+  madvise(map, size, MADV_SEQUENTIAL);
+  mMap = map;
+  mMapSize = size;
+
+  const Header& header = *(const Header*)map;
+  if (header.Magic != sMagic || header.Version != sVersion ||
+      sizeof(Header) + (size_t)header.RecordCount * sizeof(Record) + (size_t)header.PoolSize != size)
+  {
+    LOG(LogWarning) << "[Snapshot] Invalid snapshot " << mPath.ToString();
+    Unmap();
+    return false;
+  }
+  if (!(header.Source == source))
+  {
+    Unmap();
+    return false;
+  }
+
+  mRecords = (const Record*)((const char*)map + sizeof(Header));
+  mPool = (const char*)(mRecords + header.RecordCount);
+  mRecordCount = (int)header.RecordCount;
+  mPoolSize = header.PoolSize;
+  if (!CheckRecords())
+  {
+    LOG(LogError) << "[Snapshot] Corrupted snapshot " << mPath.ToString();
+    Unmap();
+    return false;
+  }
+
+  return true;
+}
+
+void GamelistSnapshotFile::Unmap()
+{
+  if (mMap != nullptr) munmap(mMap, mMapSize);
+  mMap = nullptr;
+  mMapSize = 0;
+  mRecords = nullptr;
+  mPool = nullptr;
+  mRecordCount = 0;
+  mPoolSize = 0;
+}
+
+bool GamelistSnapshotFile::CheckRecords() const
+{
+  for (int i = 0; i < mRecordCount; ++i)
+  {
+    const Record& record = mRecords[i];
+    if (record.Type != ItemType::Game && record.Type != ItemType::Folder) return false;
+    if (record.Parent < -1 || record.Parent >= i) return false;
+    if (record.Parent >= 0 && mRecords[record.Parent].Type != ItemType::Folder) return false;
+    for (const StringRef& string : record.Strings)
+      if ((unsigned long long)string.Offset + string.Length > mPoolSize) return false;
+  }
+  return true;
+}
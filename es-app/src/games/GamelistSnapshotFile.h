@@ -0,0 +1,226 @@
+#pragma once
+
+#include <string>
+#include <utils/os/fs/Path.h>
+#include <utils/cplusplus/INoCopy.h>
+#include "ItemType.h"
+
+/*!
+ * @brief On-disk format of gamelist snapshots, independent from the game tree
+ *
+ * A snapshot file starts with a header holding the state of the sources it has been built from,
+ * followed by fixed-size records and a string pool. Files are written aside then renamed, and read
+ * through a read-only memory mapping. A file whose header, size or source state does not match
+ * is stale and never mapped.
+ */
+class GamelistSnapshotFile : private INoCopy
+{
+  public:
+    //! String indexes in records
+    enum class Texts
+    {
+      Path,        //!< Item path, relative to the root path, or absolute for items outside the root folder
+      Name,        //!< Metadata name
+      Description, //!< Metadata description
+      Image,       //!< Metadata image path
+      Thumbnail,   //!< Metadata thumbnail path
+      Video,       //!< Metadata video path
+      Developer,   //!< Metadata developer
+      Publisher,   //!< Metadata publisher
+      Genre,       //!< Metadata genre
+      Emulator,    //!< Metadata emulator
+      Core,        //!< Metadata core
+      Ratio,       //!< Metadata ratio
+      __Count,     //!< String count
+    };
+
+    //! Record flags
+    enum Flags
+    {
+      FlagFavorite = 1, //!< Favorite game
+      FlagHidden   = 2, //!< Hidden game
+      FlagAdult    = 4, //!< Adult game
+      FlagDirty    = 8, //!< Modified metadata, not yet written in the gamelist
+    };
+
+    //! State of the sources the snapshot has been built from
+    struct Fingerprint
+    {
+      long long GamelistTime;    //!< gamelist.xml/zip modification time (ns) - 0 if there is no gamelist
+      long long GamelistSize;    //!< gamelist.xml/zip size plus its journal size - 0 if there is none
+      long long RomFolderTime;   //!< Root rom folder modification time (ns)
+      long long ManifestTime;    //!< Scan manifest modification time (ns) - 0 if there is no manifest
+      unsigned int Configuration;//!< Configuration key
+      unsigned int Reserved;     //!< Keep 64bit alignment
+
+      bool operator == (const Fingerprint& to) const
+      {
+        return GamelistTime == to.GamelistTime &&
+               GamelistSize == to.GamelistSize &&
+               RomFolderTime == to.RomFolderTime &&
+               ManifestTime == to.ManifestTime &&
+               Configuration == to.Configuration;
+      }
+    };
+
+    //! Reference to a string in the string pool
+    struct StringRef
+    {
+      unsigned int Offset; //!< Offset in the pool
+      unsigned int Length; //!< Length in bytes
+    };
+
+    //! Single folder/game record. Parent records always come before their children
+    struct Record
+    {
+      int          Parent;      //!< Parent record index or -1 if the parent is the root
+      ItemType     Type;        //!< Item type: Game or Folder
+      char         Flags;       //!< Favorite/Hidden/Adult/Dirty
+      short        Reserved;    //!< Alignment
+      float        Rating;      //!< Metadata rating
+      int          GenreId;     //!< Metadata normalized genre
+      int          Region;      //!< Metadata region
+      int          Players;     //!< Metadata players range
+      int          ReleaseDate; //!< Metadata release date
+      int          Playcount;   //!< Metadata play count
+      unsigned int LastPlayed;  //!< Metadata last played
+      int          RomCrc32;    //!< Metadata rom crc32
+      StringRef    Strings[(int)Texts::__Count]; //!< Strings
+    };
+
+    /*!
+     * @brief Constructor
+     * @param path Snapshot file path
+     */
+    explicit GamelistSnapshotFile(const Path& path);
+
+    /*!
+     * @brief Destructor. Release the mapping, if any
+     */
+    ~GamelistSnapshotFile() { Unmap(); }
+
+    /*!
+     * @brief Build the fingerprint of the given sources
+     * @param gamelist gamelist.xml/zip path
+     * @param journal Gamelist journal path
+     * @param romFolder Root rom folder
+     * @param manifestTime Scan manifest modification time (ns) - 0 if there is no manifest
+     * @param configuration Configuration key
+     * @return Fingerprint
+     */
+    static Fingerprint BuildFingerprint(const Path& gamelist, const Path& journal, const Path& romFolder, long long manifestTime, unsigned int configuration);
+
+    /*!
+     * @brief Check if the snapshot file exists and has been built from the given sources
+     * @param source Current source state
+     * @return True if the snapshot is up to date
+     */
+    bool IsUpToDate(const Fingerprint& source) const;
+
+    /*!
+     * @brief Write the snapshot file
+     * @param source Source state
+     * @param records Records, stored contiguously
+     * @param pool String pool
+     * @return True if the file has been written successfully
+     */
+    bool Save(const Fingerprint& source, const std::string& records, const std::string& pool) const;
+
+    /*!
+     * @brief Map the snapshot file, if and only if it is valid and built from the given sources
+     * @param source Current source state
+     * @return True if the file is mapped. False if it is stale, missing or corrupted
+     */
+    bool Map(const Fingerprint& source);
+
+    /*!
+     * @brief Release the mapping, if any
+     */
+    void Unmap();
+
+    //! Number of mapped records
+    int RecordCount() const { return mRecordCount; }
+    //! First mapped record
+    const Record* Records() const { return mRecords; }
+    //! Mapped string pool
+    const char* Pool() const { return mPool; }
+    //! Mapped string pool size
+    unsigned int PoolSize() const { return mPoolSize; }
+
+    /*!
+     * @brief Store a string into the pool
+     * @param pool String pool
+     * @param string String to store
+     * @return String reference
+     */
+    static StringRef Store(std::string& pool, const std::string& string)
+    {
+      StringRef result = { (unsigned int)pool.size(), (unsigned int)string.size() };
+      pool.append(string);
+      return result;
+    }
+
+    /*!
+     * @brief Get a string from the mapped pool
+     * @param record Mapped record
+     * @param index String index
+     * @return String
+     */
+    std::string String(const Record& record, Texts index) const
+    {
+      const StringRef& string = record.Strings[(int)index];
+      return std::string(mPool + string.Offset, string.Length);
+    }
+
+    //! Snapshot file path
+    const Path& FilePath() const { return mPath; }
+
+    /*!
+     * @brief Delete the snapshot file, if any
+     */
+    void Delete() const { mPath.Delete(); }
+
+  private:
+    //! Snapshot file magic: 'ESGS'
+    static constexpr unsigned int sMagic = 0x53475345;
+    //! Snapshot format version. Increment each time Header or Record change
+    static constexpr unsigned int sVersion = 2;
+
+    //! File header
+    struct Header
+    {
+      unsigned int Magic;       //!< File magic
+      unsigned int Version;     //!< Format version
+      Fingerprint  Source;      //!< Source state
+      unsigned int RecordCount; //!< Number of records, right after the header
+      unsigned int PoolSize;    //!< String pool size, right after records
+    };
+
+    //! Snapshot file path
+    Path mPath;
+    //! Mapping
+    void* mMap;
+    //! Mapping size
+    size_t mMapSize;
+    //! First mapped record
+    const Record* mRecords;
+    //! Mapped string pool
+    const char* mPool;
+    //! Number of mapped records
+    int mRecordCount;
+    //! Mapped string pool size
+    unsigned int mPoolSize;
+
+    /*!
+     * @brief Read and check the header of the snapshot file
+     * @param header Header to fill in
+     * @return True if the header has been read and is valid
+     */
+    bool ReadHeader(Header& header) const;
+
+    /*!
+     * @brief Check records against the mapped pool: known types, parents before children, strings inside the pool
+     * @return True if all records are consistent
+     */
+    bool CheckRecords() const;
+};
@@ -3,6 +3,8 @@
 //
 #pragma once
 
+#include "GameIndex.h"
+
 class FileData;
 
 class IFilter
@@ -14,4 +16,12 @@ class IFilter
      * @return Return true to validate this entry, false to ignore it
      */
     virtual bool ApplyFilter(const FileData& file) const = 0;
+
+    /*!
+     * @brief Filter an indexed game. Override to read packed metadata instead of game metadata
+     * @param index Hot metadata index of the game system
+     * @param slot Game slot in the index
+     * @return Return true to validate this game, false to ignore it
+     */
+    virtual bool ApplyIndexFilter(const GameIndex& index, int slot) const { return ApplyFilter(*index.Games()[slot]); }
 };
\ No newline at end of file
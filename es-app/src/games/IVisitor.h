@@ -0,0 +1,14 @@
+#pragma once
+
+class FileData;
+
+class IVisitor
+{
+  public:
+    /*!
+     * @brief Visit a FileData entry
+     * @param file FileData to visit
+     * @return Return true to continue the walk, false to stop it
+     */
+    virtual bool Visit(FileData& file) = 0;
+};
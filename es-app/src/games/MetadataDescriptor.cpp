@@ -2,6 +2,7 @@
 #include "MetadataFieldDescriptor.h"
 #include "utils/locale/LocaleHelper.h"
 #include "utils/Log.h"
+#include <cstring>
 
 // TODO: Use const char* instead
 const std::string MetadataDescriptor::DefaultValueRatio = "auto";
@@ -44,8 +45,8 @@ const MetadataFieldDescriptor* MetadataDescriptor::GetMetadataFieldDescriptors(I
         MetadataFieldDescriptor("thumbnail"  , DefaultValueEmpty    , _("Thumbnail")   , _("enter path to thumbnail")     , (int)offsetof(MetadataDescriptor, mThumbnail)  , MetadataFieldDescriptor::DataType::PPath  , MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultThumbnail      , &MetadataDescriptor::ThumbnailAsString   , &MetadataDescriptor::SetThumbnailPathAsString, false, false),
         MetadataFieldDescriptor("video"      , DefaultValueEmpty    , _("Video")       , _("enter path to video")         , (int)offsetof(MetadataDescriptor, mVideo)      , MetadataFieldDescriptor::DataType::PPath  , MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultVideo          , &MetadataDescriptor::VideoAsString       , &MetadataDescriptor::SetVideoPathAsString    , false, false),
         MetadataFieldDescriptor("releasedate", DefaultValueEmpty    , _("Release date"), _("enter release date")          , (int)offsetof(MetadataDescriptor, mReleaseDate), MetadataFieldDescriptor::DataType::Date   , MetadataFieldDescriptor::EditableType::Date   , &MetadataDescriptor::IsDefaultReleaseDateEpoc, &MetadataDescriptor::ReleaseDateAsString , &MetadataDescriptor::SetReleaseDateAsString  , false, false),
-        MetadataFieldDescriptor("developer"  , DefaultValueEmpty    , _("Developer")   , _("enter game developer")        , (int)offsetof(MetadataDescriptor, mDeveloper)  , MetadataFieldDescriptor::DataType::String , MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultDeveloper      , &MetadataDescriptor::DeveloperAsString   , &MetadataDescriptor::SetDeveloper            , false, false),
-        MetadataFieldDescriptor("publisher"  , DefaultValueEmpty    , _("Publisher")   , _("enter game publisher")        , (int)offsetof(MetadataDescriptor, mPublisher)  , MetadataFieldDescriptor::DataType::String , MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultPublisher      , &MetadataDescriptor::PublisherAsString   , &MetadataDescriptor::SetPublisher            , false, false),
+        MetadataFieldDescriptor("developer"  , DefaultValueEmpty    , _("Developer")   , _("enter game developer")        , (int)offsetof(MetadataDescriptor, mDeveloper)  , MetadataFieldDescriptor::DataType::PString, MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultDeveloper      , &MetadataDescriptor::DeveloperAsString   , &MetadataDescriptor::SetDeveloper            , false, false),
+        MetadataFieldDescriptor("publisher"  , DefaultValueEmpty    , _("Publisher")   , _("enter game publisher")        , (int)offsetof(MetadataDescriptor, mPublisher)  , MetadataFieldDescriptor::DataType::PString, MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultPublisher      , &MetadataDescriptor::PublisherAsString   , &MetadataDescriptor::SetPublisher            , false, false),
         MetadataFieldDescriptor("genre"      , DefaultValueEmpty    , _("Genre")       , _("enter game genre")            , (int)offsetof(MetadataDescriptor, mGenre)      , MetadataFieldDescriptor::DataType::PString, MetadataFieldDescriptor::EditableType::Text   , &MetadataDescriptor::IsDefaultGenre          , &MetadataDescriptor::GenreAsString       , &MetadataDescriptor::SetGenre                , false, false),
         MetadataFieldDescriptor("genreid"    , DefaultValueEmpty    , _("Genre ID")    , _("enter game genre id")         , (int)offsetof(MetadataDescriptor, mGenreId)    , MetadataFieldDescriptor::DataType::Int    , MetadataFieldDescriptor::EditableType::List   , &MetadataDescriptor::IsDefaultGenreId        , &MetadataDescriptor::GenreIdAsString     , &MetadataDescriptor::SetGenreIdAsString      , false, false),
         MetadataFieldDescriptor("adult"      , DefaultValueEmpty    , _("Adult")       , _("enter adult state")           , (int)offsetof(MetadataDescriptor, mAdult)      , MetadataFieldDescriptor::DataType::Bool   , MetadataFieldDescriptor::EditableType::Switch , &MetadataDescriptor::IsDefaultAdult          , &MetadataDescriptor::AdultAsString       , &MetadataDescriptor::SetAdultAsString        , false, false),
@@ -84,6 +85,7 @@ const MetadataFieldDescriptor* MetadataDescriptor::GetMetadataFieldDescriptors(I
 }
 
 MetadataDescriptor MetadataDescriptor::sDefault = MetadataDescriptor::BuildDefaultValueMetadataDescriptor();
+std::atomic<int> MetadataDescriptor::sTextRevision(0);
 
 MetadataDescriptor MetadataDescriptor::BuildDefaultValueMetadataDescriptor()
 {
@@ -126,20 +128,20 @@ std::string MetadataDescriptor::IntToRange(int range)
   return value;
 }
 
-bool MetadataDescriptor::RangeToInt(const std::string& range, int& to)
+bool MetadataDescriptor::RangeToInt(const char* range, int& to)
 {
   // max+ (min+)
-  int p = (int)range.find('+');
-  if (p != (int)std::string::npos)
+  int p = 0;
+  if (strchr(range, '+') != nullptr)
   {
-    if (!StringToInt(range, p, 0, '+')) return false;
+    if (!StringToInt(range, p, '+')) return false;
     to = (p << 16) + 0xFFFF;
     return true;
   }
 
   // max-max
-  p = (int)range.find('-');
-  if (p == (int)std::string::npos)
+  const char* separator = strchr(range, '-');
+  if (separator == nullptr)
   {
     if (!StringToInt(range, p)) return false;
     to = (p << 16) + p;
@@ -147,8 +149,8 @@ bool MetadataDescriptor::RangeToInt(const std::string& range, int& to)
   }
 
   // min-max
-  int min = 0; if (!StringToInt(range, min, 0, '-')) return false;
-  int max = 0; if (!StringToInt(range, max, p + 1, 0  )) return false;
+  int min = 0; if (!StringToInt(range, min, '-')) return false;
+  int max = 0; if (!StringToInt(separator + 1, max, 0  )) return false;
   if (min > max) { min = min ^ max; max = max ^ min; min = min ^ max; }
   to = (max << 16) + min;
   return true;
@@ -167,10 +169,10 @@ bool MetadataDescriptor::IntToHex(int from, std::string& to)
   return true;
 }
 
-bool MetadataDescriptor::HexToInt(const std::string& from, int& to)
+bool MetadataDescriptor::HexToInt(const char* from, int& to)
 {
-  if (from.empty()) return false;
-  const char* src = from.c_str();
+  if (from[0] == 0) return false;
+  const char* src = from;
 
   int result = 0;
   for (;; src++)
@@ -190,9 +192,9 @@ bool MetadataDescriptor::HexToInt(const std::string& from, int& to)
   return true;
 }
 
-bool MetadataDescriptor::StringToInt(const std::string& from, int& to, int offset, char stop)
+bool MetadataDescriptor::StringToInt(const char* from, int& to, char stop)
 {
-  const char* src = from.c_str() + offset;
+  const char* src = from;
 
   bool sign = (src[0] == '-');
   if (sign) src++;
@@ -205,24 +207,9 @@ bool MetadataDescriptor::StringToInt(const std::string& from, int& to, int offse
   return true;
 }
 
-bool MetadataDescriptor::StringToInt(const std::string& from, int& to)
+bool MetadataDescriptor::StringToFloat(const char* from, float& to)
 {
-  const char* src = from.c_str();
-
-  bool sign = (src[0] == '-');
-  if (sign) src++;
-
-  int result = 0;
-  while ((unsigned int)(src[0] - 0x30) <= 9) { result *= 10; result += src[0] - 0x30; src++; }
-  if (src[0] != 0) return false;
-
-  to = sign ? -result : result;
-  return true;
-}
-
-bool MetadataDescriptor::StringToFloat(const std::string& from, float& to)
-{
-  const char* src = from.c_str();
+  const char* src = from;
 
   bool sign = (src[0] == '-');
   if (sign) src++;
@@ -246,135 +233,311 @@ bool MetadataDescriptor::StringToFloat(const std::string& from, float& to)
   return true;
 }
 
-bool MetadataDescriptor::Deserialize(const XmlNode from, const Path& relativeTo)
+namespace
 {
-  #ifdef _METADATA_STATS_
-    if (_Type == ItemType::Game) LivingGames--;
-    if (_Type == ItemType::Folder) LivingFolders--;
-  #endif
-
-  std::string name = from.name();
-  if (name == GameNodeIdentifier) mType = ItemType::Game;
-  else if (name == FolderNodeIdentifier) mType = ItemType::Folder;
-  else return false; // Unidentified node
-
-  #ifdef _METADATA_STATS_
-    if (_Type == ItemType::Game) LivingGames++;
-    if (_Type == ItemType::Folder) LivingFolders++;
-  #endif
+  // Xml keys
+  constexpr char sKeyName[]        = "name";
+  constexpr char sKeyRating[]      = "rating";
+  constexpr char sKeyFavorite[]    = "favorite";
+  constexpr char sKeyHidden[]      = "hidden";
+  constexpr char sKeyEmulator[]    = "emulator";
+  constexpr char sKeyCore[]        = "core";
+  constexpr char sKeyRatio[]       = "ratio";
+  constexpr char sKeyDescription[] = "desc";
+  constexpr char sKeyImage[]       = "image";
+  constexpr char sKeyThumbnail[]   = "thumbnail";
+  constexpr char sKeyVideo[]       = "video";
+  constexpr char sKeyReleaseDate[] = "releasedate";
+  constexpr char sKeyDeveloper[]   = "developer";
+  constexpr char sKeyPublisher[]   = "publisher";
+  constexpr char sKeyGenre[]       = "genre";
+  constexpr char sKeyGenreId[]     = "genreid";
+  constexpr char sKeyAdult[]       = "adult";
+  constexpr char sKeyPlayers[]     = "players";
+  constexpr char sKeyRegion[]      = "region";
+  constexpr char sKeyPlayCount[]   = "playcount";
+  constexpr char sKeyLastPlayed[]  = "lastplayed";
+  constexpr char sKeyRomCrc32[]    = "hash";
+
+  // Default string values, as in field descriptors
+  constexpr char sDefaultEmpty[]     = "";
+  constexpr char sDefaultRating[]    = "0.0";
+  constexpr char sDefaultFalse[]     = "false";
+  constexpr char sDefaultRatio[]     = "auto";
+  constexpr char sDefaultPlayers[]   = "1";
+  constexpr char sDefaultPlayCount[] = "0";
+}
 
-  int count = 0;
-  const MetadataFieldDescriptor* fields = GetMetadataFieldDescriptors(mType, count);
+/*!
+ * @brief Compile-time counterpart of the field descriptor tables, for Deserialize & Serialize only
+ *
+ * Each field is a type carrying its codec, member, key and default value, so that
+ * a whole node is read or written by a fully inlined sequence of field operations,
+ * without offset arithmetic nor type switches.
+ * Field order must match GetMetadataFieldDescriptors.
+ */
+struct MetadataDescriptor::FieldTable
+{
+  /*
+   * Codecs, one per MetadataFieldDescriptor::DataType
+   */
 
-  // Extract default name
-  std::string defaultName = std::move(mName);
+  //! String & Text
+  struct StringCodec
+  {
+    static void Read(std::string& to, const char* value, const char*, const Path&) { to = value; }
+    static void Write(XmlNode node, const char* key, const std::string& from, const Path&) { Xml::AddAsString(node, key, from.c_str()); }
+  };
 
-  for (; --count >= 0; )
+  //! PString & PList
+  struct PStringCodec
   {
-    // Get field descriptor
-    const MetadataFieldDescriptor& field = fields[count];
+    static void Read(const std::string*& to, const char* value, const char*, const Path&) { AssignPString(to, value); }
+    static void Write(XmlNode node, const char* key, const std::string* from, const Path&) { Xml::AddAsString(node, key, ReadPString(from, DefaultValueEmpty).c_str()); }
+  };
 
-    // Get field data as string
-    const std::string& defaultStringValue = field.DefaultValue();
-    std::string value = Xml::AsString(from, field.Key(), defaultStringValue);
-    // Ignore default values
-    if (value == defaultStringValue) continue;
+  //! Path
+  struct PathCodec
+  {
+    static void Read(Path& to, const char* value, const char*, const Path& relativeTo) { to = Path(value).ToAbsolute(relativeTo); }
+    static void Write(XmlNode node, const char* key, const Path& from, const Path& relativeTo)
+    {
+      bool dummy = false;
+      Xml::AddAsString(node, key, from.MakeRelative(relativeTo, dummy).ToChars());
+    }
+  };
 
-    // Get neutral target
-    void* target = ((unsigned char*)this) + field.Offset();
+  //! PPath
+  struct PPathCodec
+  {
+    static void Read(Path*& to, const char* value, const char*, const Path& relativeTo) { AssignPPath(to, Path(value).ToAbsolute(relativeTo)); }
+    static void Write(XmlNode node, const char* key, const Path* from, const Path& relativeTo) { PathCodec::Write(node, key, ReadPPath(from, DefaultEmptyPath), relativeTo); }
+  };
 
-    // Convert & store
-    // We could use field.SetValueMethod() to set fields by string values,
-    // but we want to do more control that simple assignations
-    switch(field.Type())
+  //! Int
+  struct IntCodec
+  {
+    template<typename T> static void Read(T& to, const char* value, const char* defaultValue, const Path&)
     {
-      case MetadataFieldDescriptor::DataType::PString:
-      case MetadataFieldDescriptor::DataType::PList:
-      {
-        AssignPString(*((std::string**)target), value);
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::PPath:
-      {
-        value = Path(value).ToAbsolute(relativeTo).ToString();
-        AssignPPath(*((Path**)target), Path(value));
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::String:
-      case MetadataFieldDescriptor::DataType::Text:
+      int intValue = 0;
+      if (!StringToInt(value, intValue))
       {
-        *((std::string*)target) = value;
-        break;
+        LOG(LogWarning) << "Invalid int value " << value;
+        StringToInt(defaultValue, intValue);
       }
-      case MetadataFieldDescriptor::DataType::Path:
-      {
-        value = Path(value).ToAbsolute(relativeTo).ToString();
-        *((Path*)target) = value;
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Int:
-      {
-        int intValue = 0;
-        if (!StringToInt(value, intValue))
-        {
-          LOG(LogWarning) << "Invalid int value " << value;
-          StringToInt(field.DefaultValue(), intValue);
-        }
-        *((int*)target) = intValue;
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Bool:
+      to = (T)intValue;
+    }
+    template<typename T> static void Write(XmlNode node, const char* key, T from, const Path&) { Xml::AddAsString(node, key, Strings::ToString((int)from).c_str()); }
+  };
+
+  //! Bool
+  struct BoolCodec
+  {
+    static void Read(bool& to, const char* value, const char*, const Path&) { to = (strcmp(value, "true") == 0); }
+    static void Write(XmlNode node, const char* key, bool from, const Path&) { Xml::AddAsString(node, key, from ? "true" : "false"); }
+  };
+
+  //! Float & Rating
+  struct FloatCodec
+  {
+    static void Read(float& to, const char* value, const char* defaultValue, const Path&)
+    {
+      float floatValue = 0;
+      if (!StringToFloat(value, floatValue))
       {
-        *((bool*)target) = (value == "true");
-        break;
+        LOG(LogWarning) << "Invalid float value " << value;
+        StringToFloat(defaultValue, floatValue);
       }
-      case MetadataFieldDescriptor::DataType::Float:
-      case MetadataFieldDescriptor::DataType::Rating:
+      to = floatValue;
+    }
+    static void Write(XmlNode node, const char* key, float from, const Path&) { Xml::AddAsString(node, key, Strings::ToString(from, 5).c_str()); }
+  };
+
+  //! Date (epoch)
+  struct DateCodec
+  {
+    template<typename T> static void Read(T& to, const char* value, const char*, const Path&)
+    {
+      int epoch = 0;
+      if (value[0] != 0)
       {
-        float floatValue = 0;
-        if (!StringToFloat(value, floatValue))
+        DateTime dt(false); // Unitialized DateTime
+        if (DateTime::ParseFromString("%yyyy%MM%ddT%hh%mm%ss", value, dt))
+          epoch = (int) dt.ToLocal().ToEpochTime();
+        else
         {
-          LOG(LogWarning) << "Invalid float value " << value;
-          StringToFloat(field.DefaultValue(), floatValue);
+          LOG(LogWarning) << "Invalid DateTime value " << value;
         }
-        *((float*)target) = floatValue;
-        break;
       }
-      case MetadataFieldDescriptor::DataType::Date:
-      {
-        int epoch = 0;
-        if (value.length() != 0)
+      to = (T)epoch;
+    }
+    template<typename T> static void Write(XmlNode node, const char* key, T from, const Path&) { Xml::AddAsString(node, key, DateTime((long long)(int)from).ToUtc().ToCompactISO8601().c_str()); }
+  };
+
+  //! Range
+  struct RangeCodec
+  {
+    static void Read(int& to, const char* value, const char*, const Path&)
+    {
+      int intValue = 0;
+      if (!RangeToInt(value, intValue)) { LOG(LogWarning) << "Invalid Range " << value; }
+      to = intValue;
+    }
+    static void Write(XmlNode node, const char* key, int from, const Path&) { Xml::AddAsString(node, key, IntToRange(from).c_str()); }
+  };
+
+  //! Crc32
+  struct Crc32Codec
+  {
+    static void Read(int& to, const char* value, const char*, const Path&)
+    {
+      int intValue = 0;
+      if (value[0] != 0)
+        if (!HexToInt(value, intValue))
         {
-          DateTime dt(false); // Unitialized DateTime
-          if (DateTime::ParseFromString("%yyyy%MM%ddT%hh%mm%ss", value, dt))
-            epoch = (int) dt.ToLocal().ToEpochTime();
-          else
-            LOG(LogWarning) << "Invalid DateTime value " << value;
+          LOG(LogWarning) << "Invalid CRC32 " << value;
         }
-        *((int*) target) = epoch;
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Range:
-      {
-        int intValue = 0;
-        if (!RangeToInt(value, intValue)) { LOG(LogWarning) << "Invalid Range " << value; }
-        *((int*)target) = intValue;
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Crc32:
-      {
-        int intValue = 0;
-        if (value.length() != 0)
-          if (!HexToInt(value, intValue))
-          {
-            LOG(LogWarning) << "Invalid CRC32 " << value;
-          }
-        *((int*)target) = intValue;
-        break;
-      }
-      default: throw std::logic_error("Unknown field type");
+      to = intValue;
     }
-  }
+    static void Write(XmlNode node, const char* key, int from, const Path&)
+    {
+      std::string value;
+      IntToHex(from, value);
+      Xml::AddAsString(node, key, value.c_str());
+    }
+  };
+
+  /*!
+   * @brief Single field
+   * @tparam Codec Field codec
+   * @tparam T Member type
+   * @tparam Member Member
+   * @tparam Key Xml key
+   * @tparam Default Default string value. Nodes holding this value are ignored
+   * @tparam IsDefault Default value check, to skip default values when serializing
+   */
+  template<class Codec, typename T, T MetadataDescriptor::* Member, const char* Key, const char* Default, bool (MetadataDescriptor::*IsDefault)() const>
+  struct Field
+  {
+    static void Deserialize(MetadataDescriptor& metadata, const XmlNode from, const Path& relativeTo)
+    {
+      XmlNode child = from.child(Key);
+      if (child == nullptr) return;
+      const char* value = child.child_value();
+      // Ignore default values
+      if (strcmp(value, Default) == 0) return;
+      Codec::Read(metadata.*Member, value, Default, relativeTo);
+    }
+
+    static void Serialize(const MetadataDescriptor& metadata, XmlNode node, const Path& relativeTo)
+    {
+      if ((metadata.*IsDefault)()) return;
+      Codec::Write(node, Key, metadata.*Member, relativeTo);
+    }
+
+    static bool Match(const MetadataDescriptor& probe, const MetadataFieldDescriptor& field)
+    {
+      return field.Key() == Key && field.DefaultValue() == Default &&
+             field.Offset() == (int)((const char*)&(probe.*Member) - (const char*)&probe);
+    }
+  };
+
+  /*!
+   * @brief Field list, unrolled at compile time. Empty list
+   */
+  template<class... Fields> struct List
+  {
+    static constexpr int Count = 0;
+    static void Deserialize(MetadataDescriptor&, const XmlNode, const Path&) {}
+    static void Serialize(const MetadataDescriptor&, XmlNode, const Path&) {}
+    static bool Match(const MetadataDescriptor&, const MetadataFieldDescriptor*) { return true; }
+  };
+
+  /*!
+   * @brief Field list, unrolled at compile time.
+   * Fields are serialized in reverse order, as the descriptor loops always did
+   */
+  template<class First, class... Others> struct List<First, Others...>
+  {
+    static constexpr int Count = 1 + List<Others...>::Count;
+
+    static void Deserialize(MetadataDescriptor& metadata, const XmlNode from, const Path& relativeTo)
+    {
+      First::Deserialize(metadata, from, relativeTo);
+      List<Others...>::Deserialize(metadata, from, relativeTo);
+    }
+
+    static void Serialize(const MetadataDescriptor& metadata, XmlNode node, const Path& relativeTo)
+    {
+      List<Others...>::Serialize(metadata, node, relativeTo);
+      First::Serialize(metadata, node, relativeTo);
+    }
+
+    static bool Match(const MetadataDescriptor& probe, const MetadataFieldDescriptor* fields)
+    {
+      return First::Match(probe, *fields) && List<Others...>::Match(probe, fields + 1);
+    }
+  };
+
+  //! Game fields
+  typedef List<
+    Field<StringCodec , std::string       , &MetadataDescriptor::mName       , sKeyName       , sDefaultEmpty    , &MetadataDescriptor::IsDefaultName           >,
+    Field<FloatCodec  , float             , &MetadataDescriptor::mRating     , sKeyRating     , sDefaultRating   , &MetadataDescriptor::IsDefaultRating         >,
+    Field<BoolCodec   , bool              , &MetadataDescriptor::mFavorite   , sKeyFavorite   , sDefaultFalse    , &MetadataDescriptor::IsDefaultFavorite       >,
+    Field<BoolCodec   , bool              , &MetadataDescriptor::mHidden     , sKeyHidden     , sDefaultFalse    , &MetadataDescriptor::IsDefaultHidden         >,
+    Field<PStringCodec, const std::string*, &MetadataDescriptor::mEmulator   , sKeyEmulator   , sDefaultEmpty    , &MetadataDescriptor::IsDefaultEmulator       >,
+    Field<PStringCodec, const std::string*, &MetadataDescriptor::mCore       , sKeyCore       , sDefaultEmpty    , &MetadataDescriptor::IsDefaultCore           >,
+    Field<PStringCodec, const std::string*, &MetadataDescriptor::mRatio      , sKeyRatio      , sDefaultRatio    , &MetadataDescriptor::IsDefaultRatio          >,
+    Field<StringCodec , std::string       , &MetadataDescriptor::mDescription, sKeyDescription, sDefaultEmpty    , &MetadataDescriptor::IsDefaultDescription    >,
+    Field<PathCodec   , Path              , &MetadataDescriptor::mImage      , sKeyImage      , sDefaultEmpty    , &MetadataDescriptor::IsDefaultImage          >,
+    Field<PPathCodec  , Path*             , &MetadataDescriptor::mThumbnail  , sKeyThumbnail  , sDefaultEmpty    , &MetadataDescriptor::IsDefaultThumbnail      >,
+    Field<PPathCodec  , Path*             , &MetadataDescriptor::mVideo      , sKeyVideo      , sDefaultEmpty    , &MetadataDescriptor::IsDefaultVideo          >,
+    Field<DateCodec   , int               , &MetadataDescriptor::mReleaseDate, sKeyReleaseDate, sDefaultEmpty    , &MetadataDescriptor::IsDefaultReleaseDateEpoc>,
+    Field<PStringCodec, const std::string*, &MetadataDescriptor::mDeveloper  , sKeyDeveloper  , sDefaultEmpty    , &MetadataDescriptor::IsDefaultDeveloper      >,
+    Field<PStringCodec, const std::string*, &MetadataDescriptor::mPublisher  , sKeyPublisher  , sDefaultEmpty    , &MetadataDescriptor::IsDefaultPublisher      >,
+    Field<PStringCodec, const std::string*, &MetadataDescriptor::mGenre      , sKeyGenre      , sDefaultEmpty    , &MetadataDescriptor::IsDefaultGenre          >,
+    Field<IntCodec    , GameGenres        , &MetadataDescriptor::mGenreId    , sKeyGenreId    , sDefaultEmpty    , &MetadataDescriptor::IsDefaultGenreId        >,
+    Field<BoolCodec   , bool              , &MetadataDescriptor::mAdult      , sKeyAdult      , sDefaultEmpty    , &MetadataDescriptor::IsDefaultAdult          >,
+    Field<RangeCodec  , int               , &MetadataDescriptor::mPlayers    , sKeyPlayers    , sDefaultPlayers  , &MetadataDescriptor::IsDefaultPlayerRange    >,
+    Field<IntCodec    , int               , &MetadataDescriptor::mRegion     , sKeyRegion     , sDefaultEmpty    , &MetadataDescriptor::IsDefaultRegion         >,
+    Field<IntCodec    , int               , &MetadataDescriptor::mPlaycount  , sKeyPlayCount  , sDefaultPlayCount, &MetadataDescriptor::IsDefaultPlayCount      >,
+    Field<DateCodec   , unsigned int      , &MetadataDescriptor::mLastPlayed , sKeyLastPlayed , sDefaultEmpty    , &MetadataDescriptor::IsDefaultLastPlayedEpoc >,
+    Field<Crc32Codec  , int               , &MetadataDescriptor::mRomCrc32   , sKeyRomCrc32   , sDefaultEmpty    , &MetadataDescriptor::IsDefaultRomCrc32       >
+  > Game;
+
+  //! Folder fields
+  typedef List<
+    Field<StringCodec , std::string       , &MetadataDescriptor::mName       , sKeyName       , sDefaultEmpty    , &MetadataDescriptor::IsDefaultName           >,
+    Field<BoolCodec   , bool              , &MetadataDescriptor::mHidden     , sKeyHidden     , sDefaultFalse    , &MetadataDescriptor::IsDefaultHidden         >,
+    Field<StringCodec , std::string       , &MetadataDescriptor::mDescription, sKeyDescription, sDefaultEmpty    , &MetadataDescriptor::IsDefaultDescription    >,
+    Field<PathCodec   , Path              , &MetadataDescriptor::mImage      , sKeyImage      , sDefaultEmpty    , &MetadataDescriptor::IsDefaultImage          >,
+    Field<PPathCodec  , Path*             , &MetadataDescriptor::mThumbnail  , sKeyThumbnail  , sDefaultEmpty    , &MetadataDescriptor::IsDefaultThumbnail      >
+  > Folder;
+};
+
+bool MetadataDescriptor::Deserialize(const XmlNode from, const Path& relativeTo)
+{
+  #ifdef _METADATA_STATS_
+    if (_Type == ItemType::Game) LivingGames--;
+    if (_Type == ItemType::Folder) LivingFolders--;
+  #endif
+
+  const char* name = from.name();
+  if (strcmp(name, GameNodeIdentifier.c_str()) == 0) mType = ItemType::Game;
+  else if (strcmp(name, FolderNodeIdentifier.c_str()) == 0) mType = ItemType::Folder;
+  else return false; // Unidentified node
+
+  #ifdef _METADATA_STATS_
+    if (_Type == ItemType::Game) LivingGames++;
+    if (_Type == ItemType::Folder) LivingFolders++;
+  #endif
+
+  // Extract default name
+  std::string defaultName = std::move(mName);
+
+  // Convert & store
+  if (mType == ItemType::Game) FieldTable::Game::Deserialize(*this, from, relativeTo);
+  else FieldTable::Folder::Deserialize(*this, from, relativeTo);
 
   // Control name
   if (mName.empty())
@@ -383,15 +546,14 @@ bool MetadataDescriptor::Deserialize(const XmlNode from, const Path& relativeTo)
     mDirty = true;
   }
   else mDirty = false;
+  UpdateNameKeys();
 
+  InvalidateText();
   return true;
 }
 
 void MetadataDescriptor::Serialize(XmlNode parentNode, const Path& filePath, const Path& relativeTo) const
 {
-  int count = 0;
-  const MetadataFieldDescriptor* fields = GetMetadataFieldDescriptors(mType, count);
-
   // Add empty node game/folder
   XmlNode node = parentNode.append_child(mType == ItemType::Game ? GameNodeIdentifier.c_str() : FolderNodeIdentifier.c_str());
 
@@ -401,80 +563,33 @@ void MetadataDescriptor::Serialize(XmlNode parentNode, const Path& filePath, con
   Xml::AddAsString(node, "path", relative.ToChars());
 
   // Metadata
-  for (; --count >= 0; )
-  {
-    // Get field descriptor
-    const MetadataFieldDescriptor& field = fields[count];
-
-    // Default value?
-    if ((this->*field.IsDefaultValueMethod())()) continue;
-
-    // Get neutral source
-    void* source = ((unsigned char*)this) + field.Offset();
+  if (mType == ItemType::Game) FieldTable::Game::Serialize(*this, node, relativeTo);
+  else if (mType == ItemType::Folder) FieldTable::Folder::Serialize(*this, node, relativeTo);
+}
 
-    // Convert & store
-    // As for Deserialize, we do not use field.GetValues, because we need
-    // to do additional tasks regarding each different type
-    switch(field.Type())
-    {
-      case MetadataFieldDescriptor::DataType::String:
-      case MetadataFieldDescriptor::DataType::Text:
-      {
-        Xml::AddAsString(node, field.Key(), *((std::string*)source));
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::PString:
-      case MetadataFieldDescriptor::DataType::PList:
-      {
-        Xml::AddAsString(node, field.Key(), ReadPString(*((std::string**)source), DefaultValueEmpty));
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::PPath:
-      {
-        Xml::AddAsString(node, field.Key(), ReadPPath(*((Path**)source), Path()).MakeRelative(relativeTo, dummy).ToString());
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Path:
-      {
-        Xml::AddAsString(node, field.Key(), (*((Path*)source)).MakeRelative(relativeTo, dummy).ToString());
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Int:
-      {
-        Xml::AddAsString(node, field.Key(), *((int*)source)); // Autoboxing std::string(int)
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Bool:
-      {
-        Xml::AddAsString(node, field.Key(), *((bool*)source) ? "true" : "false");
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Float:
-      case MetadataFieldDescriptor::DataType::Rating:
-      {
-        Xml::AddAsString(node, field.Key(), *((float*)source)); // Autoboxing std::string(float)
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Date:
-      {
-        Xml::AddAsString(node, field.Key(), DateTime((long long)*((int*)source)).ToUtc().ToCompactISO8601());
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Range:
-      {
-        Xml::AddAsString(node, field.Key(), IntToRange(*((int*)source)));
-        break;
-      }
-      case MetadataFieldDescriptor::DataType::Crc32:
-      {
-        std::string value;
-        IntToHex(*((int*)source), value);
-        Xml::AddAsString(node, field.Key(), value);
-        break;
-      }
-      default: throw std::logic_error("Unknown field type");
-    }
+bool MetadataDescriptor::FieldTableMatchesDescriptors(ItemType type)
+{
+  int count = 0;
+  const MetadataFieldDescriptor* fields = GetMetadataFieldDescriptors(type, count);
+  MetadataDescriptor probe(std::string(), type);
+  switch(type)
+  {
+    case ItemType::Game: return count == FieldTable::Game::Count && FieldTable::Game::Match(probe, fields);
+    case ItemType::Folder: return count == FieldTable::Folder::Count && FieldTable::Folder::Match(probe, fields);
+    case ItemType::Root:
+    case ItemType::Empty:
+    default: break;
   }
+  return false;
+}
+
+void MetadataDescriptor::AddMemoryUsage(size_t& strings, size_t& paths) const
+{
+  strings += Strings::HeapSize(mName) + Strings::HeapSize(mSearchKey) + Strings::HeapSize(mSortKey) +
+             Strings::HeapSize(mDescription);
+  paths += Strings::HeapSize(mImage.ToString());
+  if (mThumbnail != nullptr) paths += sizeof(Path) + Strings::HeapSize(mThumbnail->ToString());
+  if (mVideo != nullptr) paths += sizeof(Path) + Strings::HeapSize(mVideo->ToString());
 }
 
 void MetadataDescriptor::Merge(const MetadataDescriptor& sourceMetadata)
@@ -505,10 +620,15 @@ void MetadataDescriptor::Merge(const MetadataDescriptor& sourceMetadata)
         break;
       }
       case MetadataFieldDescriptor::DataType::PList:
-      case MetadataFieldDescriptor::DataType::PPath:
       case MetadataFieldDescriptor::DataType::PString:
       {
-        *((std::string**)destination) = *((std::string**)source);
+        // Interned strings are shared
+        *((const std::string**)destination) = *((const std::string**)source);
+        break;
+      }
+      case MetadataFieldDescriptor::DataType::PPath:
+      {
+        AssignPPath(*((Path**)destination), ReadPPath(*((Path**)source), DefaultEmptyPath));
         break;
       }
       case MetadataFieldDescriptor::DataType::Date:
@@ -536,6 +656,8 @@ void MetadataDescriptor::Merge(const MetadataDescriptor& sourceMetadata)
     // A field has been copied. Set the dirty flag
     mDirty = true;
   }
+  UpdateNameKeys();
+  InvalidateText();
 }
 
 void MetadataDescriptor::FreeAll()
@@ -560,13 +682,13 @@ void MetadataDescriptor::FreeAll()
     // Convert & store
     switch(field.Type())
     {
-      case MetadataFieldDescriptor::DataType::PList:
       case MetadataFieldDescriptor::DataType::PPath:
-      case MetadataFieldDescriptor::DataType::PString:
       {
-        FreePString(*((std::string**)source));
+        FreePPath(*((Path**)source));
         break;
       }
+      case MetadataFieldDescriptor::DataType::PList:
+      case MetadataFieldDescriptor::DataType::PString:
       case MetadataFieldDescriptor::DataType::Rating:
       case MetadataFieldDescriptor::DataType::String:
       case MetadataFieldDescriptor::DataType::Int:
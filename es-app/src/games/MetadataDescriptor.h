@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <utils/os/fs/Path.h>
 #include <utils/Xml.h>
 #include <utils/datetime/DateTime.h>
 #include <utils/Strings.h>
+#include <utils/storage/StringPool.h>
 #include <games/classifications/Regions.h>
 #include "ItemType.h"
 #include "games/classifications/Genres.h"
@@ -16,9 +18,26 @@ class MetadataFieldDescriptor;
 class MetadataDescriptor
 {
   private:
+    // Allow snapshots & journals to read/write fields in bulk
+    friend class GamelistSnapshot;
+    friend class PlayStatsJournal;
+
     //! Default value storage for fast default detection
     static MetadataDescriptor sDefault;
 
+    //! Searchable text revision, bumped on any name, description, developer or publisher modification
+    static std::atomic<int> sTextRevision;
+
+    //! Record a searchable text modification
+    static void InvalidateText() { sTextRevision.fetch_add(1, std::memory_order_relaxed); }
+
+    //! Rebuild keys computed from the name
+    void UpdateNameKeys()
+    {
+      mSearchKey = Strings::ToSearchKey(mName);
+      mSortKey = Strings::ToSortKey(mName);
+    }
+
     #ifdef _METADATA_STATS_
     static int LivingClasses;
     static int LivingFolders;
@@ -42,15 +61,18 @@ class MetadataDescriptor
     static const std::string FolderNodeIdentifier;
 
     // Please keep field ordered by type size to reduce alignment padding
+    // Values shared by many games are interned (see StringPool)
     std::string  mName;         //!< Name as simple string
+    std::string  mSearchKey;    //!< Name search key (see Strings::ToSearchKey)
+    std::string  mSortKey;      //!< Name sort key (see Strings::ToSortKey)
     std::string  mDescription;  //!< Description, multiline text
     Path         mImage;        //!< Image path
-    std::string  mDeveloper;    //!< Developer name
-    std::string  mPublisher;    //!< Publisher name
-    std::string* mGenre;        //!< Genres, comma separated
-    std::string* mEmulator;     //!< Specific emulator
-    std::string* mCore;         //!< Specific core
-    std::string* mRatio;        //!< Specific screen ratio
+    const std::string* mDeveloper; //!< Developer name, interned
+    const std::string* mPublisher; //!< Publisher name, interned
+    const std::string* mGenre;     //!< Genres, comma separated, interned
+    const std::string* mEmulator;  //!< Specific emulator, interned
+    const std::string* mCore;      //!< Specific core, interned
+    const std::string* mRatio;     //!< Specific screen ratio, interned
     Path*        mThumbnail;    //!< Thumbnail path
     Path*        mVideo;        //!< Video path
     float        mRating;       //!< Rating from 0.0 to 1.0
@@ -74,19 +96,6 @@ class MetadataDescriptor
      */
     static MetadataDescriptor BuildDefaultValueMetadataDescriptor();
 
-    /*!
-     * Free the PString if non null
-     * @param string Pointer to std::string
-     */
-    static void FreePString(std::string*& string)
-    {
-      if (string != nullptr)
-      {
-        delete string;
-        string = nullptr;
-      }
-    }
-
     /*!
      * Free the PPath if non null
      * @param path Pointer to Path
@@ -102,18 +111,13 @@ class MetadataDescriptor
 
     /*!
      * Assign a value to the given PString.
-     * the PString is created/destroyed if required
+     * The value is interned, empty values are stored as null
      * @param string PString to assign value to
      * @param value Value to assign
      */
-    static void AssignPString(std::string*& string, const std::string& value)
+    static void AssignPString(const std::string*& string, const std::string& value)
     {
-      if (value.empty()) FreePString(string);
-      else
-      {
-        if (string == nullptr) string = new std::string();
-        *string = value;
-      }
+      string = StringPool::Intern(value);
     }
 
     /*!
@@ -174,7 +178,8 @@ class MetadataDescriptor
      * @param to destination int
      * @return True if the operation is successful. False otherwise.
      */
-    static bool RangeToInt(const std::string& range, int& to);
+    static bool RangeToInt(const char* range, int& to);
+    static bool RangeToInt(const std::string& range, int& to) { return RangeToInt(range.c_str(), to); }
     /*!
      * Convert int32 to Hexadecimal string
      * @param from Int32 value to convert to string
@@ -188,30 +193,29 @@ class MetadataDescriptor
      * @param to Target int32
      * @return True if the operation is successful. False otherwise.
      */
-    static bool HexToInt(const std::string& from, int& to);
+    static bool HexToInt(const char* from, int& to);
+    static bool HexToInt(const std::string& from, int& to) { return HexToInt(from.c_str(), to); }
     /*!
      * Fast string to int conversion
      * @param from source string
      * @param to destination int
-     * @param offset offset in source string
      * @param stop Stop char
      * @return True if the operation is successful. False otherwise.
      */
-    static bool StringToInt(const std::string& from, int& to, int offset, char stop);
-    /*!
-     * Fast string to int conversion
-     * @param from source string
-     * @param to destination int
-     * @return True if the operation is successful. False otherwise.
-     */
-    static bool StringToInt(const std::string& from, int& to);
+    static bool StringToInt(const char* from, int& to, char stop = 0);
+    static bool StringToInt(const std::string& from, int& to, int offset, char stop) { return StringToInt(from.c_str() + offset, to, stop); }
+    static bool StringToInt(const std::string& from, int& to) { return StringToInt(from.c_str(), to); }
     /*!
      * Fast string to float conversion
      * @param from source string
      * @param to destination float
      * @return True if the operation is successful. False otherwise.
      */
-    static bool StringToFloat(const std::string& from, float& to);
+    static bool StringToFloat(const char* from, float& to);
+    static bool StringToFloat(const std::string& from, float& to) { return StringToFloat(from.c_str(), to); }
+
+    //! Compile-time field tables & codecs used by Deserialize/Serialize (see MetadataDescriptor.cpp)
+    struct FieldTable;
 
     /*!
      * Free all allocated objects and return thoses objects to uninitialized state
@@ -229,11 +233,13 @@ class MetadataDescriptor
      */
     explicit MetadataDescriptor(const std::string& defaultName, ItemType type)
       : mName(defaultName),
+        mSearchKey(Strings::ToSearchKey(defaultName)),
+        mSortKey(Strings::ToSortKey(defaultName)),
         mDescription(),
         mImage(),
-        mDeveloper(),
-        mPublisher(),
-        mGenre(),
+        mDeveloper(nullptr),
+        mPublisher(nullptr),
+        mGenre(nullptr),
         mEmulator(nullptr),
         mCore(nullptr),
         mRatio(nullptr),
@@ -303,10 +309,12 @@ class MetadataDescriptor
      */
     MetadataDescriptor(MetadataDescriptor&& source) noexcept
       : mName(std::move(source.mName)),
+        mSearchKey(std::move(source.mSearchKey)),
+        mSortKey(std::move(source.mSortKey)),
         mDescription(std::move(source.mDescription)),
         mImage(std::move(source.mImage)),
-        mDeveloper(std::move(source.mDeveloper)),
-        mPublisher(std::move(source.mPublisher)),
+        mDeveloper(source.mDeveloper),
+        mPublisher(source.mPublisher),
         mGenre(source.mGenre),
         mEmulator(source.mEmulator),
         mCore(source.mCore),
@@ -332,12 +340,8 @@ class MetadataDescriptor
       if (_Type == ItemType::Game) LivingGames++;
       if (_Type == ItemType::Folder) LivingFolders++;
       #endif
-      source.mEmulator  = nullptr;
-      source.mCore      = nullptr;
-      source.mRatio     = nullptr;
       source.mThumbnail = nullptr;
       source.mVideo     = nullptr;
-      source.mGenre     = nullptr;
     }
 
     /*!
@@ -354,13 +358,15 @@ class MetadataDescriptor
       #endif
 
       FreeAll();
-      if (source.mEmulator != nullptr)  mEmulator  = new std::string(*source.mEmulator);
-      if (source.mCore != nullptr)      mCore      = new std::string(*source.mCore);
-      if (source.mRatio != nullptr)     mRatio     = new std::string(*source.mRatio);
       if (source.mThumbnail != nullptr) mThumbnail = new Path(*source.mThumbnail);
       if (source.mVideo != nullptr)     mVideo     = new Path(*source.mVideo);
-      if (source.mGenre != nullptr)     mGenre     = new std::string(*source.mGenre);
+      mEmulator    = source.mEmulator   ;
+      mCore        = source.mCore       ;
+      mRatio       = source.mRatio      ;
+      mGenre       = source.mGenre      ;
       mName        = source.mName       ;
+      mSearchKey   = source.mSearchKey  ;
+      mSortKey     = source.mSortKey    ;
       mDescription = source.mDescription;
       mImage       = source.mImage      ;
       mDeveloper   = source.mDeveloper  ;
@@ -384,6 +390,7 @@ class MetadataDescriptor
       if (_Type == ItemType::Folder) LivingFolders++;
       #endif
 
+      InvalidateText();
       return *this;
     }
 
@@ -400,16 +407,18 @@ class MetadataDescriptor
 
       FreeAll();
       mName        = std::move(source.mName);
-      mEmulator    = source.mEmulator   ; source.mEmulator  = nullptr;
-      mCore        = source.mCore       ; source.mCore      = nullptr;
-      mRatio       = source.mRatio      ; source.mRatio     = nullptr;
+      mSearchKey   = std::move(source.mSearchKey);
+      mSortKey     = std::move(source.mSortKey);
+      mEmulator    = source.mEmulator   ;
+      mCore        = source.mCore       ;
+      mRatio       = source.mRatio      ;
       mThumbnail   = source.mThumbnail  ; source.mThumbnail = nullptr;
       mVideo       = source.mVideo      ; source.mVideo     = nullptr;
-      mGenre       = source.mGenre      ; source.mGenre     = nullptr;
+      mGenre       = source.mGenre      ;
       mDescription = std::move(source.mDescription);
       mImage       = std::move(source.mImage);
-      mDeveloper   = std::move(source.mDeveloper);
-      mPublisher   = std::move(source.mPublisher);
+      mDeveloper   = source.mDeveloper  ;
+      mPublisher   = source.mPublisher  ;
       mRating      = source.mRating     ;
       mGenreId     = source.mGenreId    ;
       mPlayers     = source.mPlayers    ;
@@ -428,6 +437,7 @@ class MetadataDescriptor
       if (_Type == ItemType::Folder) LivingFolders++;
       #endif
 
+      InvalidateText();
       return *this;
     }
 
@@ -453,6 +463,19 @@ class MetadataDescriptor
      */
     void Merge(const MetadataDescriptor& source);
 
+    /*!
+     * @brief Get the searchable text revision, bumped on any name, description, developer or publisher modification
+     * @return Text revision
+     */
+    static int TextRevision() { return sTextRevision.load(std::memory_order_relaxed); }
+
+    /*!
+     * @brief Add the heap memory used by this object. Interned strings are shared and not counted
+     * @param strings Text field size to update
+     * @param paths Media path size to update
+     */
+    void AddMemoryUsage(size_t& strings, size_t& paths) const;
+
     /*
      * Accessors
      */
@@ -460,6 +483,8 @@ class MetadataDescriptor
     ItemType Type() const { return mType; }
 
     const std::string& Name()        const { return mName;                                        }
+    const std::string& SearchKey()   const { return mSearchKey;                                   }
+    const std::string& SortKey()     const { return mSortKey;                                     }
     const std::string& Emulator()    const { return ReadPString(mEmulator, DefaultValueEmpty);    }
     const std::string& Core()        const { return ReadPString(mCore, DefaultValueEmpty);        }
     const std::string& Ratio()       const { return ReadPString(mRatio, DefaultValueRatio);       }
@@ -467,8 +492,8 @@ class MetadataDescriptor
     const Path&        Image()       const { return mImage;                                       }
     const Path&        Thumbnail()   const { return ReadPPath(mThumbnail, DefaultEmptyPath);    }
     const Path&        Video()       const { return ReadPPath(mVideo, DefaultEmptyPath);        }
-    const std::string& Developer()   const { return mDeveloper;                                   }
-    const std::string& Publisher()   const { return mPublisher;                                   }
+    const std::string& Developer()   const { return ReadPString(mDeveloper, DefaultValueEmpty);   }
+    const std::string& Publisher()   const { return ReadPString(mPublisher, DefaultValueEmpty);   }
     const std::string& Genre()       const { return ReadPString(mGenre, DefaultValueEmpty);       }
 
     float              Rating()          const { return mRating;                           }
@@ -499,8 +524,8 @@ class MetadataDescriptor
     std::string ImageAsString()       const { return mImage.ToString();                            }
     std::string ThumbnailAsString()   const { return ReadPPath(mThumbnail, Path::Empty).ToString(); }
     std::string VideoAsString()       const { return ReadPPath(mVideo, Path::Empty).ToString();  }
-    std::string DeveloperAsString()   const { return mDeveloper;                                   }
-    std::string PublisherAsString()   const { return mPublisher;                                   }
+    std::string DeveloperAsString()   const { return ReadPString(mDeveloper, DefaultValueEmpty);   }
+    std::string PublisherAsString()   const { return ReadPString(mPublisher, DefaultValueEmpty);   }
     std::string GenreAsString()       const { return ReadPString(mGenre, DefaultValueEmpty);       }
     std::string RegionAsString()      const { return Regions::Serialize4Regions(mRegion);          }
 
@@ -519,17 +544,17 @@ class MetadataDescriptor
      * Setters
      */
 
-    void SetName(const std::string& name)               { mName = name; mDirty = true;                                  }
+    void SetName(const std::string& name)               { mName = name; UpdateNameKeys(); mDirty = true; InvalidateText(); }
     void SetEmulator(const std::string& emulator)       { AssignPString(mEmulator, emulator); mDirty = true;            }
     void SetCore(const std::string& core)               { AssignPString(mCore, core); mDirty = true;                    }
     void SetRatio(const std::string& ratio)             { AssignPString(mRatio, ratio); mDirty = true;                  }
-    void SetDescription(const std::string& description) { mDescription = description; mDirty = true;                    }
+    void SetDescription(const std::string& description) { mDescription = description; mDirty = true; InvalidateText();  }
     void SetImagePath(const Path& image)                { mImage = image; mDirty = true;                                }
     void SetThumbnailPath(const Path& thumbnail)        { AssignPPath(mThumbnail, thumbnail); mDirty = true;            }
     void SetVideoPath(const Path& video)                { AssignPPath(mVideo, video); mDirty = true;                    }
     void SetReleaseDate(const DateTime& releasedate)    { mReleaseDate = (int)releasedate.ToEpochTime(); mDirty = true; }
-    void SetDeveloper(const std::string& developer)     { mDeveloper = developer; mDirty = true;                        }
-    void SetPublisher(const std::string& publisher)     { mPublisher = publisher; mDirty = true;                        }
+    void SetDeveloper(const std::string& developer)     { AssignPString(mDeveloper, developer); mDirty = true; InvalidateText(); }
+    void SetPublisher(const std::string& publisher)     { AssignPString(mPublisher, publisher); mDirty = true; InvalidateText(); }
     void SetGenre(const std::string& genre)             { AssignPString(mGenre, genre); mDirty = true;                  }
     void SetRating(float rating)                        { mRating = rating; mDirty = true;                              }
     void SetPlayers(int min, int max)
@@ -546,12 +571,14 @@ class MetadataDescriptor
 
     // Special setter to force dirty
     void SetDirty() { mDirty = true; }
+    // Special setter to reset dirty, once written
+    void SetClean() { mDirty = false; }
 
     /*
      * Volatile setters - do not set the Dirty flag for auto-saving
      */
 
-    void SetVolatileDescription(const std::string& description) { mDescription = description; }
+    void SetVolatileDescription(const std::string& description) { mDescription = description; InvalidateText(); }
     void SetVolatileImagePath(const Path& image) { mImage = image; }
 
     /*
@@ -588,8 +615,8 @@ class MetadataDescriptor
      */
 
     bool IsDefaultName()            const { return sDefault.mName == mName;        }
-    bool IsDefaultEmulator()        const { return sDefault.Emulator() == Emulator();   }
-    bool IsDefaultCore()            const { return sDefault.Core() == Core();       }
+    bool IsDefaultEmulator()        const { return sDefault.mEmulator == mEmulator;    }
+    bool IsDefaultCore()            const { return sDefault.mCore == mCore;        }
     bool IsDefaultRatio()           const { return sDefault.Ratio() == Ratio();      }
     bool IsDefaultDescription()     const { return sDefault.mDescription == mDescription; }
     bool IsDefaultImage()           const { return sDefault.mImage == mImage;       }
@@ -642,5 +669,13 @@ class MetadataDescriptor
      * @return first static internal field descriptor reference
      */
     const MetadataFieldDescriptor* GetMetadataFieldDescriptors(int& count) { return GetMetadataFieldDescriptors(mType, count); }
+
+    /*!
+     * @brief Check that compile-time field tables used by Deserialize/Serialize match field descriptors:
+     * same keys, default values, members and order
+     * @param type Item type
+     * @return True if both tables match
+     */
+    static bool FieldTableMatchesDescriptors(ItemType type);
 };
 
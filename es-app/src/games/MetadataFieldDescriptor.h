@@ -31,14 +31,14 @@ class MetadataFieldDescriptor
     {
         // Simple types
         String,  //!< std::string
-        PString, //!< Pointer to std::string
+        PString, //!< Pointer to an interned std::string
         Int,     //!< int
         Bool,    //!< bool
         Float,   //!< float
 
         // Derived types
         Text,    //!< Multiline text (std::string)
-        PList,   //!< Pointer to String list, space separated (std::string)
+        PList,   //!< Pointer to an interned String list, space separated (std::string)
         Path,    //!< File path (std::string)
         PPath,   //!< Pointer to File path (std::string)
         Rating,  //!< Floating point value between 0.0 and 1.0 (float)
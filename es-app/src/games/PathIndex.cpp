@@ -0,0 +1,54 @@
+#include "PathIndex.h"
+#include "FileData.h"
+#include <utils/Strings.h>
+
+std::atomic<size_t> PathIndex::sPeakMemoryUsage(0);
+
+FileData* PathIndex::Lookup(Hash hash, const char* path, size_t length) const
+{
+  FileData* const* item = mItems.try_get(hash);
+  if (item == nullptr) return nullptr;
+  if ((*item)->hasPath(path, length)) return *item;
+
+  // Collision
+  if (mCollisions.empty()) return nullptr;
+  FileData* const* collision = mCollisions.try_get(std::string(path, length));
+  return collision != nullptr ? *collision : nullptr;
+}
+
+void PathIndex::Set(Hash hash, const char* path, size_t length, FileData* item)
+{
+  FileData** existing = mItems.try_get(hash);
+  if (existing == nullptr || (*existing)->hasPath(path, length)) mItems[hash] = item;
+  else mCollisions[std::string(path, length)] = item;
+}
+
+void PathIndex::Set(FileData* item)
+{
+  Hash hash = item->getPathHash();
+  FileData** existing = mItems.try_get(hash);
+  if (existing == nullptr || *existing == item) mItems[hash] = item;
+  else
+  {
+    // Same path or collision: the path is required
+    std::string path = item->getPath().ToString();
+    Set(hash, path.data(), path.size(), item);
+  }
+}
+
+size_t PathIndex::MemoryUsage() const
+{
+  // Open addressing: one pair and one state byte per bucket
+  size_t size = (size_t)mItems.bucket_count() * (sizeof(std::pair<Hash, FileData*>) + 1) +
+                (size_t)mCollisions.bucket_count() * (sizeof(std::pair<std::string, FileData*>) + 1);
+  for (const auto& collision : mCollisions)
+    size += Strings::HeapSize(collision.first);
+  return size;
+}
+
+void PathIndex::RecordPeakMemoryUsage() const
+{
+  size_t usage = MemoryUsage();
+  size_t peak = sPeakMemoryUsage.load(std::memory_order_relaxed);
+  while (usage > peak && !sPeakMemoryUsage.compare_exchange_weak(peak, usage, std::memory_order_relaxed));
+}
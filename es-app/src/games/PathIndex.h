@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <utils/storage/HashMap.h>
+#include <utils/os/fs/Path.h>
+
+// Forward declaration
+class FileData;
+
+/*!
+ * @brief Item lookup by full path, keyed by 64bit hashes of normalized paths
+ *
+ * Paths are never copied: keys are FNV-1a hashes, which can be computed incrementally
+ * while walking a path, and hits are verified against the item path itself.
+ * Items whose hash collides with another path are stored aside, keyed by their path string.
+ */
+class PathIndex
+{
+  public:
+    //! Path hash
+    typedef unsigned long long Hash;
+
+    //! Hash of an empty path, to start incremental hashes from
+    static constexpr Hash sEmptyHash = 0xcbf29ce484222325ULL;
+
+    //! Destructor - Record memory usage peak
+    ~PathIndex() { RecordPeakMemoryUsage(); }
+
+    /*!
+     * @brief Hash a path or continue hashing a path
+     * @param path Path characters
+     * @param length Path length
+     * @param hash Hash of the preceding characters
+     * @return Hash
+     */
+    static Hash HashPath(const char* path, size_t length, Hash hash = sEmptyHash)
+    {
+      for (const char* end = path + length; path < end; ++path)
+        hash = (hash ^ (unsigned char)*path) * 0x100000001b3ULL;
+      return hash;
+    }
+
+    /*!
+     * @brief Lookup an item
+     * @param hash Path hash
+     * @param path Path characters
+     * @param length Path length
+     * @return Item or null if not found
+     */
+    FileData* Lookup(Hash hash, const char* path, size_t length) const;
+
+    /*!
+     * @brief Lookup an item
+     * @param path Item path
+     * @return Item or null if not found
+     */
+    FileData* Lookup(const Path& path) const
+    {
+      const std::string& string = path.ToString();
+      return Lookup(HashPath(string.data(), string.size()), string.data(), string.size());
+    }
+
+    /*!
+     * @brief Check if an item is known
+     * @param path Item path
+     * @return True if an item has the given path
+     */
+    bool Contains(const Path& path) const { return Lookup(path) != nullptr; }
+
+    /*!
+     * @brief Add or replace an item
+     * @param hash Path hash
+     * @param path Path characters
+     * @param length Path length
+     * @param item Item
+     */
+    void Set(Hash hash, const char* path, size_t length, FileData* item);
+
+    /*!
+     * @brief Add or replace an item, using its own path
+     * @param item Item
+     */
+    void Set(FileData* item);
+
+    //! Remove all items
+    void Clear() { RecordPeakMemoryUsage(); mItems.clear(); mCollisions.clear(); }
+
+    //! Get item count
+    int Count() const { return (int)(mItems.size() + mCollisions.size()); }
+
+    //! Get the memory used by this index, in bytes
+    size_t MemoryUsage() const;
+
+    //! Get the largest memory usage of all indexes so far, in bytes. Indexes are short-lived
+    static size_t PeakMemoryUsage() { return sPeakMemoryUsage.load(std::memory_order_relaxed); }
+
+  private:
+    //! Largest memory usage of all indexes so far
+    static std::atomic<size_t> sPeakMemoryUsage;
+
+    //! Items by path hash
+    HashMap<Hash, FileData*> mItems;
+    //! Items whose hash collides with another path, by path
+    HashMap<std::string, FileData*> mCollisions;
+
+    //! Update the global memory usage peak with the current usage
+    void RecordPeakMemoryUsage() const;
+};
@@ -0,0 +1,131 @@
+#include "PlayStatsJournal.h"
+#include "RootFolderData.h"
+#include <systems/SystemData.h>
+#include <utils/Log.h>
+#include <utils/Files.h>
+#include <utils/Strings.h>
+#include <Settings.h>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+Path PlayStatsJournal::BuildJournalPath(const Path& root)
+{
+  // '%' and '_' are escaped, so that mapping '/' to '_' cannot make "/a_b" and "/a/b" collide
+  std::string name;
+  for (char c : root.ToString())
+    switch(c)
+    {
+      case '%': name.append("%25"); break;
+      case '_': name.append("%5F"); break;
+      case '/': name.append(1, '_'); break;
+      default: name.append(1, c); break;
+    }
+  return Path(sJournalFolder) / name.append(".playstats");
+}
+
+bool PlayStatsJournal::Exists(const RootFolderData& root)
+{
+  return BuildJournalPath(root.getPath()).Exists();
+}
+
+void PlayStatsJournal::Delete(const RootFolderData& root)
+{
+  BuildJournalPath(root.getPath()).Delete();
+}
+
+bool PlayStatsJournal::Append(const FileData& game)
+{
+  if (Settings::Instance().IgnoreGamelist()) return false;
+  const RootFolderData& root = game.getTopAncestor();
+  if (root.ReadOnly() || root.Virtual()) return false;
+
+  bool ok = false;
+  std::string path = game.getPath().MakeRelative(root.getPath(), ok).ToString();
+  if (path.empty() || path.size() > sMaxPathLength) return false;
+
+  const MetadataDescriptor& metadata = game.Metadata();
+  Record record = {};
+  record.Magic = sMagic;
+  record.PathHash = Strings::ToHash(path);
+  record.Playcount = metadata.mPlaycount;
+  record.LastPlayed = metadata.mLastPlayed;
+  record.PathLength = (unsigned short)path.size();
+  record.Flags = (unsigned char)((metadata.mFavorite ? FlagFavorite : 0) |
+                                 (metadata.mHidden ? FlagHidden : 0));
+
+  std::string content;
+  content.reserve(sizeof(Record) + path.size());
+  content.append((const char*)&record, sizeof(record)).append(path);
+
+  // Single write, so that a record is either complete or detected as torn
+  Path journal = BuildJournalPath(root.getPath());
+  int fd = open(journal.ToChars(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+  if (fd < 0)
+  {
+    Path(sJournalFolder).CreatePath();
+    fd = open(journal.ToChars(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+  }
+  if (fd < 0)
+  {
+    LOG(LogError) << "[PlayStats] Cannot open " << journal.ToString();
+    return false;
+  }
+  ok = (write(fd, content.data(), content.size()) == (ssize_t)content.size());
+  close(fd);
+
+  if (!ok) LOG(LogError) << "[PlayStats] Cannot write " << journal.ToString();
+  return ok;
+}
+
+int PlayStatsJournal::Replay(RootFolderData& root)
+{
+  Path journal = BuildJournalPath(root.getPath());
+  if (!journal.Exists()) return 0;
+
+  // Keep the last record of each game
+  std::string content = Files::LoadFile(journal);
+  HashMap<std::string, Record> records;
+  for (size_t offset = 0; offset + sizeof(Record) <= content.size(); )
+  {
+    Record record = {};
+    memcpy(&record, content.data() + offset, sizeof(record));
+    offset += sizeof(record);
+    if (record.Magic != sMagic || offset + record.PathLength > content.size())
+    {
+      LOG(LogWarning) << "[PlayStats] Torn record in " << journal.ToString() << ". Ignoring the rest of the journal";
+      break;
+    }
+    std::string path(content.data() + offset, record.PathLength);
+    offset += record.PathLength;
+    if (Strings::ToHash(path) != record.PathHash)
+    {
+      LOG(LogWarning) << "[PlayStats] Torn record in " << journal.ToString() << ". Ignoring the rest of the journal";
+      break;
+    }
+    records[(root.getPath() / path).ToString()] = record;
+  }
+  if (records.empty()) return 0;
+
+  PathIndex games;
+  root.BuildDoppelgangerMap(games, false);
+  int count = 0;
+  for (const auto& record : records)
+  {
+    const std::string& path = record.first;
+    FileData* game = games.Lookup(PathIndex::HashPath(path.data(), path.size()), path.data(), path.size());
+    if (game == nullptr) continue; // Removed game
+
+    MetadataDescriptor& metadata = game->Metadata();
+    metadata.mPlaycount = record.second.Playcount;
+    metadata.mLastPlayed = record.second.LastPlayed;
+    metadata.mFavorite = (record.second.Flags & FlagFavorite) != 0;
+    metadata.mHidden = (record.second.Flags & FlagHidden) != 0;
+    metadata.mDirty = true;
+    count++;
+  }
+  root.System().HotIndex().Invalidate();
+
+  LOG(LogDebug) << "[PlayStats] " << count << " games updated from " << journal.ToString();
+  return count;
+}
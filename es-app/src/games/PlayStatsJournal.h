@@ -0,0 +1,82 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+
+// Forward declarations
+class RootFolderData;
+class FileData;
+
+/*!
+ * @brief Append-only binary journal of the most frequently modified metadata
+ *
+ * Play count, last played date, favorite & hidden flags change each time a game is run or toggled.
+ * Instead of waiting for the next gamelist write, each change is appended to a small per-root journal
+ * as a single fixed-size record, so that it is never lost whatever happens next.
+ * The journal is replayed after the root is loaded, and dropped once the gamelist has been written.
+ */
+class PlayStatsJournal
+{
+  public:
+    /*!
+     * @brief Append the current statistics of the given game to the journal of its root.
+     * Nothing is written for read-only roots or when gamelists are ignored
+     * @param game Game
+     * @return True if the record has been written
+     */
+    static bool Append(const FileData& game);
+
+    /*!
+     * @brief Apply journaled statistics to the given root. Updated items are marked dirty
+     * @param root Loaded root folder
+     * @return Number of updated items
+     */
+    static int Replay(RootFolderData& root);
+
+    /*!
+     * @brief Check if the given root has pending statistics
+     * @param root Root folder
+     * @return True if the journal exists
+     */
+    static bool Exists(const RootFolderData& root);
+
+    /*!
+     * @brief Drop the journal of the given root, once its gamelist is up to date
+     * @param root Root folder
+     */
+    static void Delete(const RootFolderData& root);
+
+  private:
+    //! Journal folder, next to the gamelist snapshots
+    static constexpr const char* sJournalFolder = "/recalbox/share/system/.emulationstation/playstats";
+    //! Record magic: 'ESPS'
+    static constexpr unsigned int sMagic = 0x53505345;
+    //! Maximum path length
+    static constexpr int sMaxPathLength = 4096;
+
+    //! Record flags
+    enum Flags
+    {
+      FlagFavorite = 1, //!< Favorite game
+      FlagHidden   = 2, //!< Hidden game
+    };
+
+    //! Journal record, immediately followed by the game path, relative to the root
+    struct Record
+    {
+      unsigned int   Magic;      //!< Record magic
+      int            PathHash;   //!< Relative path hash, to detect torn records
+      int            Playcount;  //!< Metadata play count
+      unsigned int   LastPlayed; //!< Metadata last played
+      unsigned short PathLength; //!< Relative path length in bytes
+      unsigned char  Flags;      //!< Favorite/Hidden
+      unsigned char  Reserved;   //!< Alignment
+    };
+
+    /*!
+     * @brief Build the journal file path from the root folder path.
+     * '/' are mapped to '_', after '%' and '_' have been escaped
+     * @param root Root folder path
+     * @return Journal file path
+     */
+    static Path BuildJournalPath(const Path& root);
+};
@@ -0,0 +1,21 @@
+#include "PooledList.h"
+
+thread_local std::vector<FileData::List> PooledList::sPool;
+
+PooledList::PooledList()
+{
+  if (!sPool.empty())
+  {
+    mList.swap(sPool.back());
+    sPool.pop_back();
+  }
+}
+
+PooledList::~PooledList()
+{
+  if ((int)sPool.size() < sMaxPooledLists && mList.capacity() <= sMaxPooledCapacity)
+  {
+    mList.clear();
+    sPool.push_back(std::move(mList));
+  }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <utils/cplusplus/INoCopy.h>
+#include "FileData.h"
+
+/*!
+ * @brief Temporary item list borrowed from a per-thread pool
+ *
+ * Lists keep their capacity when they go back to the pool, so that temporary lists
+ * built on UI paths stop allocating once the pool is warm.
+ * Use it as a scoped local: the list is cleared and returned to the pool on destruction.
+ */
+class PooledList : private INoCopy
+{
+  public:
+    //! Constructor - Borrow a list from the pool
+    PooledList();
+
+    //! Destructor - Give the list back to the pool
+    ~PooledList();
+
+    //! Get the list
+    FileData::List& List() { return mList; }
+
+  private:
+    //! Maximum lists kept per thread
+    static constexpr int sMaxPooledLists = 8;
+    //! Lists with a larger capacity are not kept
+    static constexpr size_t sMaxPooledCapacity = 1 << 16;
+
+    //! Free lists of the current thread
+    static thread_local std::vector<FileData::List> sPool;
+
+    //! Borrowed list
+    FileData::List mList;
+};
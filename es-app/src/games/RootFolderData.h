@@ -62,6 +62,19 @@ class RootFolderData : public FolderData
     //! Get type
     Types Type() const { return mType; }
 
+    //! Get child ownership
+    Ownership ChildOwnership() const { return mChildOwnership; }
+
+    /*!
+     * @brief Add the heap memory used by this tree, ignoring items owned by other trees
+     * @param usage Memory usage to update
+     */
+    void AddTreeMemoryUsage(MemoryUsage& usage) const
+    {
+      AddMemoryUsage(usage);
+      addMemoryUsageRecursively(usage, mChildOwnership != Ownership::None, mChildOwnership == Ownership::All);
+    }
+
     //! Normal folder?
     bool Normal() const { return (mType == Types::None); }
 
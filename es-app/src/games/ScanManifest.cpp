@@ -0,0 +1,155 @@
+#include "ScanManifest.h"
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <cstring>
+
+ScanManifest::ScanManifest(const Path& root, const Path& folder)
+  : mManifestPath(folder / Strings::Replace(root.ToString(), "/", "_").append(".manifest")),
+    mChanged(false)
+{
+}
+
+static void WriteInt(std::string& to, unsigned int value)
+{
+  to.append((const char*)&value, sizeof(value));
+}
+
+static void WriteLong(std::string& to, long long value)
+{
+  to.append((const char*)&value, sizeof(value));
+}
+
+static void WriteString(std::string& to, const std::string& value)
+{
+  WriteInt(to, (unsigned int)value.size());
+  to.append(value);
+}
+
+static bool ReadInt(const char*& from, const char* end, unsigned int& value)
+{
+  if (from + sizeof(value) > end) return false;
+  memcpy(&value, from, sizeof(value));
+  from += sizeof(value);
+  return true;
+}
+
+static bool ReadLong(const char*& from, const char* end, long long& value)
+{
+  if (from + sizeof(value) > end) return false;
+  memcpy(&value, from, sizeof(value));
+  from += sizeof(value);
+  return true;
+}
+
+static bool ReadString(const char*& from, const char* end, std::string& value)
+{
+  unsigned int length = 0;
+  if (!ReadInt(from, end, length)) return false;
+  if (from + length > end) return false;
+  value.assign(from, length);
+  from += length;
+  return true;
+}
+
+static bool ReadStrings(const char*& from, const char* end, Strings::Vector& values)
+{
+  unsigned int count = 0;
+  if (!ReadInt(from, end, count)) return false;
+  values.resize(count);
+  for (std::string& value : values)
+    if (!ReadString(from, end, value)) return false;
+  return true;
+}
+
+bool ScanManifest::Load()
+{
+  mPrevious.clear();
+  if (!mManifestPath.Exists()) return false;
+
+  std::string content = Files::LoadFile(mManifestPath);
+  const char* p = content.data();
+  const char* end = p + content.size();
+
+  unsigned int magic = 0, version = 0, count = 0;
+  if (!ReadInt(p, end, magic) || magic != sMagic) return false;
+  if (!ReadInt(p, end, version) || version != sVersion) return false;
+  if (!ReadInt(p, end, count)) return false;
+
+  mPrevious.reserve(count);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    std::string path;
+    Folder folder;
+    unsigned int entryCount = 0;
+    unsigned int systemConfig = 0;
+    if (!ReadString(p, end, path) ||
+        !ReadLong(p, end, folder.Time) ||
+        !ReadInt(p, end, folder.Extensions) ||
+        !ReadInt(p, end, entryCount) ||
+        !ReadInt(p, end, systemConfig) ||
+        !ReadStrings(p, end, folder.Games) ||
+        !ReadStrings(p, end, folder.SubFolders) ||
+        !ReadStrings(p, end, folder.SymLinks))
+    {
+      LOG(LogWarning) << "[Manifest] Corrupted manifest " << mManifestPath.ToString() << ". Ignored.";
+      mPrevious.clear();
+      return false;
+    }
+    folder.EntryCount = (int)entryCount;
+    folder.SystemConfig = systemConfig != 0;
+    mPrevious[path] = std::move(folder);
+  }
+
+  return true;
+}
+
+bool ScanManifest::Save()
+{
+  // Nothing rescanned and no folder removed?
+  if (!mChanged && mCurrent.size() == mPrevious.size()) return true;
+
+  std::string content;
+  WriteInt(content, sMagic);
+  WriteInt(content, sVersion);
+  WriteInt(content, mCurrent.size());
+  for (const auto& item : mCurrent)
+  {
+    const Folder& folder = item.second;
+    WriteString(content, item.first);
+    WriteLong(content, folder.Time);
+    WriteInt(content, folder.Extensions);
+    WriteInt(content, (unsigned int)folder.EntryCount);
+    WriteInt(content, folder.SystemConfig ? 1 : 0);
+    WriteInt(content, (unsigned int)folder.Games.size());
+    for (const std::string& game : folder.Games) WriteString(content, game);
+    WriteInt(content, (unsigned int)folder.SubFolders.size());
+    for (const std::string& subFolder : folder.SubFolders) WriteString(content, subFolder);
+    WriteInt(content, (unsigned int)folder.SymLinks.size());
+    for (const std::string& symLink : folder.SymLinks) WriteString(content, symLink);
+  }
+
+  // Write aside and rename, so that an interrupted save never leaves a partial manifest
+  mManifestPath.Directory().CreatePath();
+  Path temporary(mManifestPath.ToString() + ".tmp");
+  if (Files::SaveFile(temporary, content) && Path::Rename(temporary, mManifestPath))
+    return true;
+
+  temporary.Delete();
+  LOG(LogError) << "[Manifest] Cannot save " << mManifestPath.ToString();
+  return false;
+}
+
+const ScanManifest::Folder* ScanManifest::Lookup(const Path& folder, long long time) const
+{
+  const Folder* previous = mPrevious.try_get(folder.ToString());
+  if (previous == nullptr) return nullptr;
+  if (previous->Time != time) return nullptr;
+  return previous;
+}
+
+void ScanManifest::Store(const Path& folder, const Folder& result, bool fresh)
+{
+  Mutex::AutoLock locker(mLocker);
+  mCurrent[folder.ToString()] = result;
+  if (fresh) mChanged = true;
+}
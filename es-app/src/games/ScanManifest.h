@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string>
+#include <utils/os/fs/Path.h>
+#include <utils/storage/HashMap.h>
+#include <utils/Strings.h>
+#include <utils/os/system/Mutex.h>
+
+/*!
+ * @brief Persistent per-directory manifest of a rom root folder
+ *
+ * For each directory scanned, the manifest keeps the directory modification time, the extension
+ * filter in use, the number of entries and the names of matching games and sub-folders.
+ * Adding, removing or renaming an entry always updates its directory mtime, so when the mtime
+ * is unchanged, the previous scan result is still accurate and the directory does not need
+ * to be listed again, nor its entries stat'ed.
+ *
+ * The manifest only reflects the file system state. It does not depend on gamelists so that
+ * it remains valid whatever emulationstation.gamelistonly is set or not.
+ */
+class ScanManifest
+{
+  public:
+    //! Scan result of a single directory
+    struct Folder
+    {
+      long long Time;             //!< Directory modification time (ns)
+      unsigned int Extensions;    //!< Hash of the extension filter used to scan the directory
+      int EntryCount;             //!< Number of entries in the directory
+      Strings::Vector Games;      //!< Matching game entries
+      Strings::Vector SubFolders; //!< Sub-folders to recurse in
+      Strings::Vector SymLinks;   //!< Sub-folders that are symbolic links
+      bool SystemConfig;          //!< The directory has a .system.cfg overriding extensions
+
+      Folder()
+        : Time(0),
+          Extensions(0),
+          EntryCount(0),
+          SystemConfig(false)
+      {
+      }
+
+      /*!
+       * @brief Hash an extension filter
+       * @param extensions Extension filter
+       * @return Hash to store in Extensions
+       */
+      static unsigned int HashExtensions(const std::string& extensions) { return (unsigned int)Strings::ToHash(extensions); }
+
+      /*!
+       * @brief Check if the directory has been scanned with the given extension filter
+       * @param extensions Current extension filter
+       * @return True if the filter has not changed since
+       */
+      bool MatchExtensions(const std::string& extensions) const { return Extensions == HashExtensions(extensions); }
+    };
+
+    /*!
+     * @brief Constructor
+     * @param root Root rom folder
+     */
+    explicit ScanManifest(const Path& root) : ScanManifest(root, Path(sManifestFolder)) {}
+
+    /*!
+     * @brief Constructor
+     * @param root Root rom folder
+     * @param folder Folder the manifest is stored in
+     */
+    ScanManifest(const Path& root, const Path& folder);
+
+    /*!
+     * @brief Load the manifest from disk
+     * @return True if the manifest has been loaded
+     */
+    bool Load();
+
+    /*!
+     * @brief Save the manifest, if it has changed since it has been loaded
+     * @return True if the manifest is saved or does not need to be
+     */
+    bool Save();
+
+    /*!
+     * @brief Lookup the previous scan result of the given directory
+     * @param folder Directory path
+     * @param time Current modification time of the directory
+     * @return Previous scan result or nullptr if the directory must be scanned again.
+     * Caller must still check the extension filter using MatchExtensions
+     */
+    const Folder* Lookup(const Path& folder, long long time) const;
+
+    /*!
+     * @brief Get the previous scan result of the given directory, whatever its current modification time
+     * @param folder Directory path
+     * @return Previous scan result or nullptr if the directory is not in the manifest
+     */
+    const Folder* Previous(const Path& folder) const { return mPrevious.try_get(folder.ToString()); }
+
+    /*!
+     * @brief Store the scan result of a directory. Only stored directories are saved.
+     * Thread safe: directories may be scanned in parallel
+     * @param folder Directory path
+     * @param result Scan result
+     * @param fresh True if the result comes from an actual scan, false if it is a previous result
+     */
+    void Store(const Path& folder, const Folder& result, bool fresh);
+
+    /*!
+     * @brief Get the modification time of the manifest file. It changes each time a scan modifies the manifest
+     * @return Modification time (ns) or 0 if there is no manifest file
+     */
+    long long FileTime() const { return mManifestPath.Exists() ? mManifestPath.LastModificationTime() : 0; }
+
+  private:
+    //! Manifest folder, next to the system weight file
+    static constexpr const char* sManifestFolder = "/recalbox/share/system/.emulationstation/manifests";
+    //! Manifest file magic: 'ESSM'
+    static constexpr unsigned int sMagic = 0x4D535345;
+    //! Manifest format version
+    static constexpr unsigned int sVersion = 2;
+
+    //! Manifest path
+    Path mManifestPath;
+    //! Folders loaded from disk. Read-only while scanning
+    HashMap<std::string, Folder> mPrevious;
+    //! Folders stored during the current scan
+    HashMap<std::string, Folder> mCurrent;
+    //! Current folder protection
+    Mutex mLocker;
+    //! At least one folder has been rescanned
+    bool mChanged;
+};
@@ -0,0 +1,243 @@
+#include "SearchIndex.h"
+#include "RootFolderData.h"
+#include <utils/Log.h>
+#include <algorithm>
+#include <iterator>
+
+bool SearchIndex::Ready()
+{
+  // Pick the last built content
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (mBuilt) mContent = std::move(mBuilt);
+  }
+  if (!mContent) return false;
+
+  // Items may have been destroyed: the content must not be used anymore
+  if (mContent->TreeRevision != mTreeRevision.load(std::memory_order_relaxed))
+  {
+    mContent.reset();
+    return false;
+  }
+
+  // Reindex modified games, unless too many games have been reindexed already
+  if (mContent->TextRevision != MetadataDescriptor::TextRevision())
+  {
+    Update(*mContent);
+    if (mContent->Obsolete * sObsoleteRatio > (int)mContent->Documents.size())
+    {
+      mContent.reset();
+      return false;
+    }
+  }
+  return true;
+}
+
+void SearchIndex::Prepare()
+{
+  if (Ready() || mBuilding) return;
+  mBuilding = true;
+  Thread::Start("SearchIndex");
+}
+
+const std::string& SearchIndex::Text(const FileData& game, Field field, std::string& storage)
+{
+  switch(field)
+  {
+    case Field::Name       : return game.Metadata().SearchKey();
+    case Field::Path       : return game.getPathString(storage);
+    case Field::Description: return game.Metadata().Description();
+    case Field::Developer  : return game.Metadata().Developer();
+    case Field::Publisher  : return game.Metadata().Publisher();
+    case Field::FieldCount :
+    default: break;
+  }
+  return game.getName();
+}
+
+unsigned int SearchIndex::Fingerprint(const FileData& game)
+{
+  // FNV-1a over all fields, separated by their length
+  unsigned int hash = 0x811c9dc5u;
+  static thread_local std::string storage;
+  for (int field = 0; field < Field::FieldCount; ++field)
+  {
+    const std::string& text = Text(game, (Field)field, storage);
+    for (unsigned char c : text) hash = (hash ^ c) * 0x01000193u;
+    hash = (hash ^ (unsigned int)text.size()) * 0x01000193u;
+  }
+  return hash;
+}
+
+void SearchIndex::Add(Content& content, FileData& game)
+{
+  int document = (int)content.Documents.size();
+  content.Documents.push_back(&game);
+  content.Fingerprints.push_back(Fingerprint(game));
+
+  static thread_local std::string storage;
+  for (int field = 0; field < Field::FieldCount; ++field)
+  {
+    // Same case folding as FolderData::FastSearchText. Name keys are already folded
+    unsigned char fold = field == Field::Name ? 0 : 0x20;
+    const std::string& text = Text(game, (Field)field, storage);
+    HashMap<unsigned int, PostingList>& postings = content.Postings[field];
+    const unsigned char* p = (const unsigned char*)text.data();
+    for (int i = (int)text.size() - 2; --i >= 0; ++p)
+    {
+      unsigned int trigram = ((unsigned int)(p[0] | fold) << 16) | ((unsigned int)(p[1] | fold) << 8) | (unsigned int)(p[2] | fold);
+      PostingList& list = postings[trigram];
+      // Documents are added in ascending order: lists stay sorted
+      if (list.empty() || list.back() != document) list.push_back(document);
+    }
+  }
+}
+
+void SearchIndex::Update(Content& content)
+{
+  // Read the revision first, so that concurrent modifications trigger a new update
+  content.TextRevision = MetadataDescriptor::TextRevision();
+
+  // Modified games get a new identifier, former ones are ignored by queries
+  for (int i = (int)content.Documents.size(); --i >= 0; )
+  {
+    FileData* game = content.Documents[i];
+    if (game != nullptr && content.Fingerprints[i] != Fingerprint(*game))
+    {
+      content.Documents[i] = nullptr;
+      content.Obsolete++;
+      Add(content, *game);
+    }
+  }
+}
+
+void SearchIndex::Run()
+{
+  class Collector : public IVisitor
+  {
+    private:
+      std::vector<FileData*>& mGames;
+    public:
+      explicit Collector(std::vector<FileData*>& games) : mGames(games) {}
+      bool Visit(FileData& game) override { mGames.push_back(&game); return true; }
+  };
+
+  while (IsRunning())
+  {
+    std::unique_ptr<Content> content(new Content);
+    std::vector<FileData*> games;
+    {
+      // Collect games first: a single walk, without reading any text
+      Mutex::AutoLock treeLocker(mTreeLocker);
+      content->TreeRevision = mTreeRevision.load(std::memory_order_relaxed);
+      content->TextRevision = MetadataDescriptor::TextRevision();
+      Collector collector(games);
+      for (const RootFolderData* root : mRoot.SubRoots())
+        root->visitGamesRecursively(collector, FileData::Filter::All, true);
+    }
+
+    // Index by chunks, releasing the tree lock in between. Start again as soon as the tree is modified
+    bool modified = false;
+    for (int i = 0; i < (int)games.size() && !modified && IsRunning(); )
+    {
+      Mutex::AutoLock treeLocker(mTreeLocker);
+      modified = content->TreeRevision != mTreeRevision.load(std::memory_order_relaxed);
+      if (!modified)
+        for (int end = std::min(i + sGamesPerLock, (int)games.size()); i < end; ++i)
+          SearchIndex::Add(*content, *games[i]);
+    }
+    if (modified) continue;
+
+    if (IsRunning())
+    {
+      LOG(LogDebug) << "[SearchIndex] " << content->Documents.size() << " games indexed";
+      Mutex::AutoLock locker(mLocker);
+      mBuilt = std::move(content);
+    }
+    break;
+  }
+  mBuilding = false;
+}
+
+void SearchIndex::Candidates(const Content& content, Field field, const std::vector<unsigned int>& trigrams, PostingList& to)
+{
+  // Get all posting lists, smallest first
+  std::vector<const PostingList*> lists;
+  lists.reserve(trigrams.size());
+  for (unsigned int trigram : trigrams)
+  {
+    const PostingList* list = content.Postings[field].try_get(trigram);
+    if (list == nullptr) return; // Trigram not found anywhere
+    lists.push_back(list);
+  }
+  std::sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+
+  // Intersect
+  to = *lists[0];
+  PostingList intersection;
+  for (int i = 1; i < (int)lists.size() && !to.empty(); ++i)
+  {
+    intersection.clear();
+    std::set_intersection(to.begin(), to.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(intersection));
+    to.swap(intersection);
+  }
+}
+
+bool SearchIndex::Search(FolderData::FastSearchContext context, const std::string& text, FolderData::ResultList& results, int& remaining)
+{
+  // Shorter texts have no trigram
+  if (text.size() < 3) return false;
+  if (!Ready())
+  {
+    Prepare();
+    return false;
+  }
+
+  // Distinct trigrams of the searched text
+  std::vector<unsigned int> trigrams;
+  const unsigned char* p = (const unsigned char*)text.data();
+  for (int i = (int)text.size() - 2; --i >= 0; ++p)
+    trigrams.push_back(((unsigned int)p[0] << 16) | ((unsigned int)p[1] << 8) | (unsigned int)p[2]);
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+  // Candidates, in tree order
+  PostingList candidates;
+  Field field = Field::Name;
+  switch(context)
+  {
+    case FolderData::FastSearchContext::Name       : field = Field::Name; break;
+    case FolderData::FastSearchContext::Path       : field = Field::Path; break;
+    case FolderData::FastSearchContext::Description: field = Field::Description; break;
+    case FolderData::FastSearchContext::Developer  : field = Field::Developer; break;
+    case FolderData::FastSearchContext::Publisher  : field = Field::Publisher; break;
+    case FolderData::FastSearchContext::All        : field = Field::FieldCount; break;
+  }
+  if (field != Field::FieldCount) Candidates(*mContent, field, trigrams, candidates);
+  else
+  {
+    PostingList fieldCandidates;
+    PostingList merged;
+    for (int i = 0; i < Field::FieldCount; ++i)
+    {
+      fieldCandidates.clear();
+      Candidates(*mContent, (Field)i, trigrams, fieldCandidates);
+      merged.clear();
+      std::set_union(candidates.begin(), candidates.end(), fieldCandidates.begin(), fieldCandidates.end(), std::back_inserter(merged));
+      candidates.swap(merged);
+    }
+  }
+
+  // Check candidates and compute distances, as a full scan would do
+  for (int document : candidates)
+  {
+    if (remaining <= 0) break;
+    FileData* game = mContent->Documents[document];
+    if (game == nullptr || game->Metadata().Hidden()) continue;
+    int distance = FolderData::FastSearchGame(context, text, *game);
+    if (distance >= 0)
+      if (--remaining > 0)
+        results.push_back(FolderData::FastSearchItem(distance, game));
+  }
+  return true;
+}
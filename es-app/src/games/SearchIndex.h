@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/HashMap.h>
+#include <utils/cplusplus/INoCopy.h>
+#include "FolderData.h"
+
+// Forward declaration
+class RootFolderData;
+
+/*!
+ * @brief Trigram index of the searchable texts of a single system
+ *
+ * Each searchable field has its own posting lists: for each 3-byte sequence, the sorted list of
+ * games whose text contains it. Queries intersect the posting lists of their trigrams, then check
+ * remaining candidates with FolderData::FastSearchGame, so that distances and result order are
+ * exactly the same as a full scan.
+ * The index is built in background, holding the tree lock for bounded chunks of games only, so that the main
+ * thread never waits for a whole build. Until it is ready, searches fall back to full scans.
+ * Tree modifications trigger a full rebuild, while text modifications only reindex modified games.
+ */
+class SearchIndex : private INoCopy
+                  , private Thread
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param root Master root of the indexed system
+     * @param treeRevision Tree revision of the indexed system, bumped on any item addition or removal
+     * @param treeLocker Tree lock, held by the main thread while adding or removing items
+     */
+    SearchIndex(const RootFolderData& root, const std::atomic<int>& treeRevision, Mutex& treeLocker)
+      : mRoot(root)
+      , mTreeRevision(treeRevision)
+      , mTreeLocker(treeLocker)
+      , mBuilding(false)
+    {
+    }
+
+    //! Destructor - Wait for the background build, if any
+    ~SearchIndex() override { Thread::Stop(); }
+
+    /*!
+     * @brief Start building the index in background, if it is not ready and not being built already
+     * Must be called from the searching thread, holding the tree lock
+     */
+    void Prepare();
+
+    /*!
+     * @brief Search text in games, using the index
+     * @param context Fields to search in
+     * @param text Text to search for, as a search key
+     * @param results Result list to fill
+     * @param remaining Maximum results
+     * @return False if the index is not ready: nothing has been searched, and a background build is started
+     */
+    bool Search(FolderData::FastSearchContext context, const std::string& text, FolderData::ResultList& results, int& remaining);
+
+  private:
+    //! Indexed fields, in FastSearchContext::All search order
+    enum Field
+    {
+      Name,
+      Path,
+      Description,
+      Developer,
+      Publisher,
+      FieldCount,
+    };
+
+    //! Sorted document identifiers
+    typedef std::vector<int> PostingList;
+
+    //! Index content
+    struct Content
+    {
+      std::vector<FileData*> Documents;                 //!< Indexed games by identifier, null once reindexed
+      std::vector<unsigned int> Fingerprints;           //!< Text fingerprints by identifier
+      HashMap<unsigned int, PostingList> Postings[FieldCount]; //!< Posting lists by trigram, for each field
+      int Obsolete = 0;                                 //!< Reindexed documents
+      int TreeRevision = 0;                             //!< Tree revision the content has been built from
+      int TextRevision = 0;                             //!< Text revision the content is up to date with
+    };
+
+    //! Obsolete documents ratio (1/n) triggering a full rebuild
+    static constexpr int sObsoleteRatio = 4;
+    //! Games indexed per tree lock
+    static constexpr int sGamesPerLock = 256;
+
+    //! Master root
+    const RootFolderData& mRoot;
+    //! System tree revision
+    const std::atomic<int>& mTreeRevision;
+    //! Tree lock
+    Mutex& mTreeLocker;
+    //! Ready content - searching thread only
+    std::unique_ptr<Content> mContent;
+    //! Content built in background, waiting to be picked
+    std::unique_ptr<Content> mBuilt;
+    //! Built content lock
+    Mutex mLocker;
+    //! True while a background build is running
+    std::atomic<bool> mBuilding;
+
+    /*!
+     * @brief Pick the built content, if any, and check the current content is still valid
+     * @return True if the index is ready
+     */
+    bool Ready();
+
+    /*!
+     * @brief Reindex games whose texts have been modified
+     * @param content Content to update
+     */
+    static void Update(Content& content);
+
+    /*!
+     * @brief Add a game to the index
+     * @param content Content to update
+     * @param game Game to add
+     */
+    static void Add(Content& content, FileData& game);
+
+    /*!
+     * @brief Get a searchable text of a game
+     * @param game Game
+     * @param field Field to get
+     * @param storage Storage of texts built on demand, like absolute paths
+     * @return Text, from the game or from the storage
+     */
+    static const std::string& Text(const FileData& game, Field field, std::string& storage);
+
+    /*!
+     * @brief Compute a fingerprint of all searchable texts of a game
+     * @param game Game
+     * @return Fingerprint
+     */
+    static unsigned int Fingerprint(const FileData& game);
+
+    /*!
+     * @brief Get candidate documents of a single field, sorted by identifier
+     * @param content Index content
+     * @param field Field to search in
+     * @param trigrams Trigrams of the searched text
+     * @param to Candidate list to fill
+     */
+    static void Candidates(const Content& content, Field field, const std::vector<unsigned int>& trigrams, PostingList& to);
+
+    /*
+     * Thread implementation
+     */
+
+    //! Build the whole index in background
+    void Run() override;
+};
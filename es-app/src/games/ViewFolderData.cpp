@@ -0,0 +1,207 @@
+#include "ViewFolderData.h"
+#include <systems/SystemData.h>
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+  //! Append visited games to a list
+  class Collector : public IVisitor
+  {
+    private:
+      FileData::List& mList;
+    public:
+      explicit Collector(FileData::List& list) : mList(list) {}
+      bool Visit(FileData& file) override { mList.push_back(&file); return true; }
+  };
+
+  //! Stop at the first visited game
+  class Finder : public IVisitor
+  {
+    public:
+      bool Visit(FileData&) override { return false; }
+  };
+}
+
+void ViewFolderData::BuildFromSources()
+{
+  FileData::List games;
+  Collector collector(games);
+  for (const SystemData* source : mSources)
+    for (const RootFolderData* root : source->MasterRoot().SubRoots())
+      if (!root->Virtual())
+        root->visitIndexedGames(collector, *mFilter, source->IncludeAdultGames());
+  // Limit
+  if (mLimit > 0 && mLimit < (int)games.size())
+  {
+    if (mComparer != nullptr)
+      FolderData::Sort(games, mComparer, true);
+    games.resize(mLimit);
+  }
+
+  std::sort(games.begin(), games.end());
+  games.erase(std::unique(games.begin(), games.end()), games.end());
+  Games().swap(games);
+  mBuilt = true;
+  GamesChanged();
+}
+
+ViewFolderData::~ViewFolderData()
+{
+  // Children are source games or view folders: detach them, then destroy view folders only
+  ClearChildList();
+  for (auto& item : mFolders)
+  {
+    item.second->Clear();
+    delete item.second;
+  }
+}
+
+void ViewFolderData::GamesChanged()
+{
+  if (!mFlat)
+  {
+    for (auto& item : mFolders) item.second->Clear();
+    ClearChildList();
+    HashMap<const FolderData*, bool> attached;
+    for (FileData* game : mGames)
+      ViewFolder(game->getParent(), attached).addChild(game, false);
+  }
+  treeChanged();
+}
+
+FolderData& ViewFolderData::ViewFolder(const FolderData* source, HashMap<const FolderData*, bool>& attached)
+{
+  if (source == nullptr || source->isRoot()) return *this;
+
+  Folder** existing = mFolders.try_get(source);
+  Folder* folder = existing != nullptr ? *existing : nullptr;
+  if (folder == nullptr)
+  {
+    folder = new (System().ItemArena()) Folder(source->getPath(), *this);
+    mFolders[source] = folder;
+  }
+  if (!attached.contains(source))
+  {
+    attached[source] = true;
+    folder->setParent(nullptr);
+    ViewFolder(source->getParent(), attached).addChild(folder, true);
+  }
+  return *folder;
+}
+
+bool ViewFolderData::HasGame(bool visibleOnly) const
+{
+  if (mBuilt)
+    return visibleOnly ? hasVisibleGame() : hasGame();
+
+  class Filter : public IFilter
+  {
+    private:
+      const IFilter& mViewFilter;
+      bool mVisibleOnly;
+    public:
+      Filter(const IFilter& viewFilter, bool visibleOnly) : mViewFilter(viewFilter), mVisibleOnly(visibleOnly) {}
+      bool ApplyFilter(const FileData& file) const override { return !(mVisibleOnly && file.Metadata().Hidden()) && mViewFilter.ApplyFilter(file); }
+      bool ApplyIndexFilter(const GameIndex& index, int slot) const override
+      {
+        return !(mVisibleOnly && (index.Flags()[slot] & GameIndex::FlagHidden) != 0) && mViewFilter.ApplyIndexFilter(index, slot);
+      }
+  }
+  filter(*mFilter, visibleOnly);
+
+  Finder finder;
+  for (const SystemData* source : mSources)
+    for (const RootFolderData* root : source->MasterRoot().SubRoots())
+      if (!root->Virtual())
+        if (!root->visitIndexedGames(finder, filter, source->IncludeAdultGames()))
+          return true;
+  return false;
+}
+
+bool ViewFolderData::Has(const FileData& game) const
+{
+  const FileData::List& games = Games();
+  return std::binary_search(games.begin(), games.end(), (FileData*)&game);
+}
+
+bool ViewFolderData::Add(FileData& game)
+{
+  if (!mBuilt) return false;
+  FileData::List& games = Games();
+  auto it = std::lower_bound(games.begin(), games.end(), &game);
+  if (it != games.end() && *it == &game) return false;
+  games.insert(it, &game);
+  GamesChanged();
+  return true;
+}
+
+bool ViewFolderData::Remove(FileData& game)
+{
+  if (!mBuilt) return false;
+  FileData::List& games = Games();
+  auto it = std::lower_bound(games.begin(), games.end(), &game);
+  if (it == games.end() || *it != &game) return false;
+  games.erase(it);
+  GamesChanged();
+  return true;
+}
+
+bool ViewFolderData::RemoveFiltered(IFilter& filter)
+{
+  if (!mBuilt) return false;
+  // Order-preserving: games remain sorted
+  FileData::List& games = Games();
+  auto end = std::remove_if(games.begin(), games.end(), [&filter](const FileData* game) { return filter.ApplyFilter(*game); });
+  if (end == games.end()) return false;
+  games.erase(end, games.end());
+  GamesChanged();
+  return true;
+}
+
+bool ViewFolderData::Refresh(const SystemData& source)
+{
+  if (!mBuilt) return false;
+
+  class Filter : public IFilter
+  {
+    private:
+      const SystemData* mSystem;
+      const IFilter& mViewFilter;
+    public:
+      Filter(const SystemData* system, const IFilter& viewFilter) : mSystem(system), mViewFilter(viewFilter) {}
+      bool ApplyFilter(const FileData& file) const override { return file.getSystem() == mSystem && !mViewFilter.ApplyFilter(file); }
+  }
+  formerGames(&source, *mFilter);
+  bool changed = RemoveFiltered(formerGames);
+
+  FileData::List games;
+  GetSourceGames(source, games);
+  return Merge(games) || changed;
+}
+
+void ViewFolderData::GetSourceGames(const SystemData& source, FileData::List& to) const
+{
+  Collector collector(to);
+  for (const RootFolderData* root : source.MasterRoot().SubRoots())
+    if (!root->Virtual())
+      root->visitIndexedGames(collector, *mFilter, source.IncludeAdultGames());
+  std::sort(to.begin(), to.end());
+}
+
+bool ViewFolderData::Merge(const FileData::List& games)
+{
+  // Keep only missing games
+  FileData::List& current = Games();
+  FileData::List missing;
+  std::set_difference(games.begin(), games.end(), current.begin(), current.end(), std::back_inserter(missing));
+  missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+  if (missing.empty()) return false;
+
+  // Append & merge sorted ranges
+  int middle = (int)current.size();
+  current.insert(current.end(), missing.begin(), missing.end());
+  std::inplace_merge(current.begin(), current.begin() + middle, current.end());
+  GamesChanged();
+  return true;
+}
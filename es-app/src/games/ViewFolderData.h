@@ -0,0 +1,157 @@
+#pragma once
+
+#include <memory>
+#include <utils/storage/HashMap.h>
+#include "RootFolderData.h"
+
+/*!
+ * @brief Root folder of view systems: a sorted array of games owned by other systems
+ *
+ * Views do not copy games and use no doppelganger map. Games are kept sorted by address,
+ * so that lookups and incremental updates are binary searches and merges.
+ * Views of always-flat systems use this array as their child list. Other views rebuild the
+ * sub-folder hierarchy of source games on each update, as collections always did: source
+ * folders holding at least one game of the view get a view folder, created once and reused.
+ * The content is computed on first use only: until then, updates cost nothing.
+ */
+class ViewFolderData : public RootFolderData
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param topAncestor Master root of the view system
+     * @param system View system
+     * @param sources Systems providing games
+     * @param filter Game filter
+     * @param comparer Comparer used to select games to keep when the limit is reached, or null to keep them in source order
+     * @param limit Maximum game count, applied when the view is built. 0 = no limit
+     * @param flat True to list games only, false to keep the sub-folder hierarchy of source games
+     */
+    ViewFolderData(RootFolderData& topAncestor, SystemData& system, const std::vector<SystemData*>& sources,
+                   const std::shared_ptr<IFilter>& filter, FileData::Comparer comparer, int limit, bool flat)
+      : RootFolderData(topAncestor, Ownership::None, Types::Virtual, Path(), system)
+      , mSources(sources)
+      , mFilter(filter)
+      , mComparer(comparer)
+      , mLimit(limit)
+      , mBuilt(false)
+      , mFlat(flat)
+    {
+    }
+
+    //! Destructor - Destroy view folders, but not source games
+    ~ViewFolderData() override;
+
+    /*!
+     * @brief Compute the view content if not already done
+     */
+    void Build() { if (!mBuilt) BuildFromSources(); }
+
+    //! Is the content computed?
+    bool IsBuilt() const { return mBuilt; }
+
+    /*!
+     * @brief Check if the view has games, without computing it. Stop at the first matching game
+     * @param visibleOnly Ignore hidden games
+     * @return True if at least one game is in the view
+     */
+    bool HasGame(bool visibleOnly) const;
+
+    /*!
+     * @brief Check if the given game is in the view
+     * @param game Game to look for
+     * @return True if the game is in the view
+     */
+    bool Has(const FileData& game) const;
+
+    /*!
+     * @brief Add a game. Does nothing if the view is not computed yet
+     * @param game Game to add
+     * @return True if the game has been added
+     */
+    bool Add(FileData& game);
+
+    /*!
+     * @brief Remove a game. Does nothing if the view is not computed yet
+     * @param game Game to remove
+     * @return True if the game has been removed
+     */
+    bool Remove(FileData& game);
+
+    /*!
+     * @brief Remove games matching the given filter. Does nothing if the view is not computed yet
+     * @param filter Filter to apply
+     * @return True if at least one game has been removed
+     */
+    bool RemoveFiltered(IFilter& filter);
+
+    /*!
+     * @brief Refresh games of the given system. Does nothing if the view is not computed yet
+     * @param source Updated system
+     * @return True if the view has been modified
+     */
+    bool Refresh(const SystemData& source);
+
+  private:
+    //! Sub-folder of a view, holding source games without owning them
+    class Folder : public FolderData
+    {
+      public:
+        Folder(const Path& path, RootFolderData& topAncestor) : FolderData(path, topAncestor) {}
+        //! Detach all children
+        void Clear() { ClearChildList(); }
+    };
+
+    //! Source systems
+    std::vector<SystemData*> mSources;
+    //! Game filter
+    std::shared_ptr<IFilter> mFilter;
+    //! Limit comparer
+    FileData::Comparer mComparer;
+    //! Maximum game count
+    int mLimit;
+    //! Content computed
+    bool mBuilt;
+    //! Games only, no sub-folder
+    bool mFlat;
+    //! Games sorted by address, when the view is not flat. Flat views use their child list
+    FileData::List mGames;
+    //! View folders by source folder, kept across updates
+    HashMap<const FolderData*, Folder*> mFolders;
+
+    //! Get games sorted by address
+    FileData::List& Games() { return mFlat ? mChildren : mGames; }
+    const FileData::List& Games() const { return mFlat ? mChildren : mGames; }
+
+    /*!
+     * @brief Record a game list update: rebuild the sub-folder hierarchy of non-flat views
+     */
+    void GamesChanged();
+
+    /*!
+     * @brief Get the view folder of a source folder, attaching it to the hierarchy if required
+     * @param source Source folder, or null
+     * @param attached Source folders whose view folder is already attached
+     * @return View folder, or the view itself for source roots
+     */
+    FolderData& ViewFolder(const FolderData* source, HashMap<const FolderData*, bool>& attached);
+
+    /*!
+     * @brief Compute the view content from all sources
+     */
+    void BuildFromSources();
+
+    /*!
+     * @brief Get matching games of the given system, sorted by address
+     * @param source Source system
+     * @param to Game list to fill
+     */
+    void GetSourceGames(const SystemData& source, FileData::List& to) const;
+
+    /*!
+     * @brief Merge new games into the sorted child list
+     * @param games Games sorted by address
+     * @return True if at least one game has been added
+     */
+    bool Merge(const FileData::List& games);
+};
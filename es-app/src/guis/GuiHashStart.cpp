@@ -148,9 +148,10 @@ FileData* GuiHashStart::ThreadPoolRunJob(FileData*& feed)
   if (mState == State::Hashing)
   {
     bool done = false;
-    if (Strings::ToLowerASCII(feed->getPath().Extension()) == ".zip")
+    const Path path(feed->getPath());
+    if (Strings::ToLowerASCII(path.Extension()) == ".zip")
     {
-      Zip zip(feed->getPath());
+      Zip zip(path);
       if (zip.Count() == 1)
       {
         feed->Metadata().SetRomCrc32(zip.Crc32(0));
@@ -162,7 +163,7 @@ FileData* GuiHashStart::ThreadPoolRunJob(FileData*& feed)
     {
       // Hash file
       unsigned int result = 0;
-      if (Crc32File(feed->getPath()).Crc32(result))
+      if (Crc32File(path).Crc32(result))
         feed->Metadata().SetRomCrc32((int) result);
     }
 
@@ -14,6 +14,7 @@
 
 #include "games/MetadataDescriptor.h"
 #include "games/MetadataFieldDescriptor.h"
+#include "games/PlayStatsJournal.h"
 #include "GuiScraperSingleGameRun.h"
 
 GuiMetaDataEd::GuiMetaDataEd(WindowManager& window,
@@ -347,6 +348,8 @@ void GuiMetaDataEd::onSizeChanged()
 
 void GuiMetaDataEd::save()
 {
+  bool favorite = mMetaData.Favorite();
+  bool hidden = mMetaData.Hidden();
   for (int i = 0; i < (int)mEditors.size(); i++)
   {
     if (mMetaDataEditable[i]->Type() != MetadataFieldDescriptor::DataType::PList)
@@ -383,6 +386,11 @@ void GuiMetaDataEd::save()
       else (mMetaData.*(mMetaDataEditable[i]->SetValueMethod()))(list->getSelected());
     }
   }
+  // Update index & game counts in place
+  mGame.HotMetadataChanged();
+  // Flags are journaled like toggles from the gamelist, so that they survive until the next gamelist write
+  if (mGame.isGame() && (favorite != mMetaData.Favorite() || hidden != mMetaData.Hidden()))
+    PlayStatsJournal::Append(mGame);
 
   if (mActions != nullptr)
     mActions->Modified(mGameListView, mGame);
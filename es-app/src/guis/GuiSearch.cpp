@@ -12,6 +12,7 @@
 #include "components/ScrollableContainer.h"
 #include "GuiSearch.h"
 #include "GuiNetPlayHostPasswords.h"
+#include <games/PlayStatsJournal.h>
 
 #define BUTTON_GRID_VERT_PADDING Renderer::Instance().DisplayHeightAsFloat() * 0.025f
 #define BUTTON_GRID_HORIZ_PADDING 10
@@ -24,7 +25,8 @@ GuiSearch::GuiSearch(WindowManager& window, SystemManager& systemManager)
 		  mBackground(window, Path(":/frame.png")),
 		  mGrid(window, Vector2i(3, 3)),
 		  mList(nullptr),
-		  mJustOpen(true)
+		  mJustOpen(true),
+		  mSearcher(*this, systemManager, 100, 500)
 {
 	addChild(&mBackground);
 	addChild(&mGrid);
@@ -205,12 +207,13 @@ bool GuiSearch::ProcessInput(const class InputCompactEvent & event)
         MetadataDescriptor& md = cursor->Metadata();
         SystemData* favoriteSystem = mSystemManager.FavoriteSystem();
 
-        md.SetFavorite(!md.Favorite());
+        cursor->SetFavorite(!md.Favorite());
+        PlayStatsJournal::Append(*cursor);
 
         if (favoriteSystem != nullptr)
         {
-          if (md.Favorite()) favoriteSystem->GetFavoriteRoot().addChild(cursor, false);
-          else favoriteSystem->GetFavoriteRoot().removeChild(cursor);
+          if (md.Favorite()) favoriteSystem->GetFavoriteRoot().Add(*cursor);
+          else favoriteSystem->GetFavoriteRoot().Remove(*cursor);
 
           ViewController::Instance().setInvalidGamesList(cursor->getSystem());
           ViewController::Instance().setInvalidGamesList(favoriteSystem);
@@ -291,53 +294,61 @@ void GuiSearch::Render(const Transform4x4f& parentTrans)
 }
 
 void GuiSearch::PopulateGrid(const std::string& search)
+{
+	if (search.length()>2)
+	{
+		// Current results stay displayed until new ones are available
+		mSearcher.Search(mSearchChoices->getSelected(), search);
+	}
+	else
+	{
+		mSearcher.Cancel();
+		mSearchResults.clear();
+		mText->setValue(_("TYPE AT LEAST 3 CHARACTERS"));
+		clear();
+		if (mList) mList->clear();
+		mGrid.getCellAt(0, 2)->canFocus = false;
+	}
+}
+
+void GuiSearch::GameSearchCompleted(const FileData::List& results)
 {
 	if (mList) {
 		mList->clear();
 	}
 
-	if (search.length()>2)
+	mSearchResults = results;
+	if (!mSearchResults.empty())
 	{
-		mSearchResults =  mSystemManager.searchTextInGames(mSearchChoices->getSelected(), search, 100, 500);
-		if (!mSearchResults.empty())
-		{
-			mText->setValue("");
-			ComponentListRow row;
-			std::shared_ptr<Component> ed;
-			for (auto *game : mSearchResults) {
-				row.elements.clear();
-				std::string gameName;
-
-				const char* icon = SystemIcons::GetIcon(game->getSystem()->getName());
-				if (icon != nullptr) gameName.append(icon);
-				gameName.append(game->Metadata().Name());
-
-				ed = std::make_shared<TextComponent>(mWindow, gameName, mMenuTheme->menuText.font,
-				                                     mMenuTheme->menuText.color,
-				                                     TextAlignment::Left);
-				row.addElement(ed, true);
-				row.makeAcceptInputHandler([this] { launch(); });
-				mList->addRow(row, false, true);
-			}
-
-			clear();
-			mGrid.getCellAt(0, 2)->canFocus = true;
-			populateGridMeta(0);
-		}
-		else
-		{
-			mText->setValue(_("NO RESULTS"));
-			clear();
-			if (mList) mList->clear();
-			//so we can jump to button if list is empty
-			mGrid.getCellAt(0, 2)->canFocus = false;
+		mText->setValue("");
+		ComponentListRow row;
+		std::shared_ptr<Component> ed;
+		for (auto *game : mSearchResults) {
+			row.elements.clear();
+			std::string gameName;
+
+			const char* icon = SystemIcons::GetIcon(game->getSystem()->getName());
+			if (icon != nullptr) gameName.append(icon);
+			gameName.append(game->Metadata().Name());
+
+			ed = std::make_shared<TextComponent>(mWindow, gameName, mMenuTheme->menuText.font,
+			                                     mMenuTheme->menuText.color,
+			                                     TextAlignment::Left);
+			row.addElement(ed, true);
+			row.makeAcceptInputHandler([this] { launch(); });
+			mList->addRow(row, false, true);
 		}
+
+		clear();
+		mGrid.getCellAt(0, 2)->canFocus = true;
+		populateGridMeta(0);
 	}
 	else
 	{
-		mText->setValue(_("TYPE AT LEAST 3 CHARACTERS"));
+		mText->setValue(_("NO RESULTS"));
 		clear();
 		if (mList) mList->clear();
+		//so we can jump to button if list is empty
 		mGrid.getCellAt(0, 2)->canFocus = false;
 	}
 }
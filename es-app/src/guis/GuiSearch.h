@@ -14,8 +14,9 @@
 #include <components/VideoComponent.h>
 #include <themes/MenuThemeData.h>
 #include "systems/SystemManager.h"
+#include "systems/GameSearcher.h"
 
-class GuiSearch : public Gui, public IGuiArcadeVirtualKeyboardInterface
+class GuiSearch : public Gui, public IGuiArcadeVirtualKeyboardInterface, public IGameSearchNotification
 {
   public:
     GuiSearch(WindowManager& window, SystemManager& systemManager);
@@ -82,6 +83,9 @@ class GuiSearch : public Gui, public IGuiArcadeVirtualKeyboardInterface
     //! Just-open flag
     bool mJustOpen;
 
+    //! Background searcher - must be destroyed first
+    GameSearcher mSearcher;
+
     /*!
      * @brief Called when the edited text change.
      * Current text is available from the Text() method.
@@ -98,6 +102,16 @@ class GuiSearch : public Gui, public IGuiArcadeVirtualKeyboardInterface
      * @brief Called when the edited text is cancelled.
      */
     void ArcadeVirtualKeyboardCanceled(GuiArcadeVirtualKeyboard& vk) final;
+
+    /*
+     * IGameSearchNotification implementation
+     */
+
+    /*!
+     * @brief Fill the result list
+     * @param results Sorted game list
+     */
+    void GameSearchCompleted(const FileData::List& results) final;
 };
 
 
@@ -103,6 +103,9 @@ void ScraperFactory::ExtractRegionFromFilename(FileData& game)
 {
   Regions::GameRegions region = Regions::ExtractRegionsFromFileName(game.getPath());
   if (region != Regions::GameRegions::Unknown)
+  {
     game.Metadata().SetRegion((int)region);
+    game.HotMetadataChanged();
+  }
 }
 
@@ -493,8 +493,9 @@ std::string ScreenScraperEngine::Engine::ComputeMD5(const Path& path)
 ScrapeResult ScreenScraperEngine::Engine::RequestGameInfo(ScreenScraperApis::Game& result, const FileData& game, long long size)
 {
   // Get MD5
-  std::string md5 = (size < sMaxMd5Calculation) ? ComputeMD5(game.getPath()) : std::string();
-  LOG(LogDebug) << "MD5 of " << game.getPath().ToString() << " : " << md5;
+  const Path gamePath(game.getPath());
+  std::string md5 = (size < sMaxMd5Calculation) ? ComputeMD5(gamePath) : std::string();
+  LOG(LogDebug) << "MD5 of " << gamePath.ToString() << " : " << md5;
 
   // Get crc32
   std::string crc32;
@@ -512,7 +513,7 @@ ScrapeResult ScreenScraperEngine::Engine::RequestGameInfo(ScreenScraperApis::Gam
     if (sssysid == nullptr) return result.mResult;
 
     // Call!
-    result = mCaller.GetGameInformation(*sssysid, game.getPath(), crc32, md5, size);
+    result = mCaller.GetGameInformation(*sssysid, gamePath, crc32, md5, size);
     switch(result.mResult)
     {
       case ScrapeResult::NotFound: continue;
@@ -529,9 +530,10 @@ ScrapeResult ScreenScraperEngine::Engine::RequestGameInfo(ScreenScraperApis::Gam
 
 ScrapeResult ScreenScraperEngine::Engine::RequestZipGameInfo(ScreenScraperApis::Game& result, const FileData& game, long long size)
 {
-  if (Strings::ToLowerASCII(game.getPath().Extension()) == ".zip")
+  const Path gamePath(game.getPath());
+  if (Strings::ToLowerASCII(gamePath.Extension()) == ".zip")
   {
-    Zip zip(game.getPath());
+    Zip zip(gamePath);
     if (zip.Count() == 1) // Ignore multi-file archives
     {
       // Get real name
@@ -539,7 +541,7 @@ ScrapeResult ScreenScraperEngine::Engine::RequestZipGameInfo(ScreenScraperApis::
 
       // Get MD5
       std::string md5 = zip.Md5(0);
-      LOG(LogDebug) << "MD5 of " << filePath.ToString() << " [" << game.getPath().ToString() << "] : " << md5;
+      LOG(LogDebug) << "MD5 of " << filePath.ToString() << " [" << gamePath.ToString() << "] : " << md5;
 
       // Get crc32
       int crc32i = zip.Crc32(0);
@@ -711,6 +713,7 @@ ScreenScraperEngine::Engine::StoreTextData(ScrappingMethod method, const ScreenS
     game.Metadata().SetRomCrc32AsString(sourceData.mCrc);
     mTextInfo++;
   }
+  game.HotMetadataChanged();
 
   // Store P2k file
   if (!sourceData.mP2k.empty())
@@ -758,9 +761,10 @@ ScreenScraperEngine::Engine::DownloadAndStoreMedia(ScrappingMethod method, const
 {
   bool ok = false;
   const Path rootFolder(game.getTopAncestor().getPath());
-  const Path relativePath = game.getPath().MakeRelative(rootFolder, ok);
-  const std::string gameName = ok ? (relativePath.Directory() / game.getPath().FilenameWithoutExtension()).ToString()
-                                  : game.getPath().FilenameWithoutExtension();
+  const Path gamePath(game.getPath());
+  const Path relativePath = gamePath.MakeRelative(rootFolder, ok);
+  const std::string gameName = ok ? (relativePath.Directory() / gamePath.FilenameWithoutExtension()).ToString()
+                                  : gamePath.FilenameWithoutExtension();
   const Path mediaFolder = rootFolder / "media";
 
   // Main image
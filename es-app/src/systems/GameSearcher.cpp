@@ -0,0 +1,173 @@
+#include "GameSearcher.h"
+#include "SystemManager.h"
+#include <utils/Strings.h>
+#include <algorithm>
+
+GameSearcher::GameSearcher(IGameSearchNotification& notification, SystemManager& systemManager, int maxPerSystem, int maxGlobal)
+  : mNotification(notification),
+    mSender(this),
+    mSystemManager(systemManager),
+    mSystems(systemManager.GetSearchableSystemList()),
+    mMaxPerSystem(maxPerSystem),
+    mMaxGlobal(maxGlobal),
+    mRequestContext(FolderData::FastSearchContext::Name),
+    mGeneration(0),
+    mResultGeneration(0),
+    mResultTreeRevision(0),
+    mLastContext(FolderData::FastSearchContext::Name),
+    mLastNarrowable(false),
+    mLastTreeRevision(0)
+{
+  Thread::Start("GameSearch");
+}
+
+GameSearcher::~GameSearcher()
+{
+  Cancel();
+  Thread::Stop();
+}
+
+void GameSearcher::Search(FolderData::FastSearchContext context, const std::string& text)
+{
+  std::string key = Strings::ToSearchKey(text);
+  {
+    Mutex::AutoLock locker(mLocker);
+    mRequestText = key;
+    mRequestContext = context;
+    mGeneration++;
+  }
+  mSignal.Signal();
+}
+
+void GameSearcher::Cancel()
+{
+  Mutex::AutoLock locker(mLocker);
+  mRequestText.clear();
+  mGeneration++;
+}
+
+int GameSearcher::TreeRevision() const
+{
+  int revision = 0;
+  for (const SystemData* system : mSystems)
+    revision += system->TreeRevision();
+  return revision;
+}
+
+bool GameSearcher::Search(FolderData::FastSearchContext context, const std::string& text, int generation, FolderData::ResultList& results)
+{
+  // Previous results may have been removed from the trees since the last search
+  bool narrow = mLastNarrowable && context == mLastContext && text.size() > mLastText.size() &&
+                text.compare(0, mLastText.size(), mLastText) == 0 && TreeRevision() == mLastTreeRevision;
+  bool narrowable = true;
+  if (narrow)
+  {
+    // Games matching the new text are among previous results
+    for (int i = 0; i < (int)mLast.size() && narrow; )
+    {
+      if (generation != mGeneration) return false; // Canceled
+      Mutex::AutoLock treeLocker(mSystemManager.TreeLocker());
+      narrow = TreeRevision() == mLastTreeRevision;
+      if (narrow)
+        for (int end = std::min(i + sGamesPerLock, (int)mLast.size()); i < end; ++i)
+        {
+          FileData* game = mLast[i].Data;
+          if (game->Metadata().Hidden()) continue;
+          int distance = FolderData::FastSearchGame(context, text, *game);
+          if (distance >= 0)
+            results.push_back(FolderData::FastSearchItem(distance, game));
+        }
+    }
+    if (!narrow) results.clear(); // Trees modified meanwhile
+  }
+
+  if (!narrow)
+  {
+    int treeRevision = 0;
+    do
+    {
+      results.clear();
+      narrowable = true;
+      treeRevision = TreeRevision();
+      for (SystemData* system : mSystems)
+      {
+        if (generation != mGeneration) return false; // Canceled
+        Mutex::AutoLock treeLocker(mSystemManager.TreeLocker());
+        int remaining = mMaxPerSystem;
+        system->FastSearch(context, text, results, remaining);
+        if (remaining <= 0) narrowable = false; // Some games have been ignored
+      }
+    }
+    while (TreeRevision() != treeRevision); // Results of previous systems may have been removed meanwhile
+    mLastTreeRevision = treeRevision;
+  }
+
+  mLast = results;
+  mLastText = text;
+  mLastContext = context;
+  mLastNarrowable = narrowable;
+  return true;
+}
+
+void GameSearcher::Run()
+{
+  // Build indexes while the user types the first characters
+  for (SystemData* system : mSystems)
+  {
+    Mutex::AutoLock treeLocker(mSystemManager.TreeLocker());
+    system->PrepareFastSearch();
+  }
+
+  int processed = 0;
+  while (IsRunning())
+  {
+    if (mGeneration == processed)
+    {
+      mSignal.WaitSignal(100); // Timeout guards against lost signals
+      continue;
+    }
+
+    // Get the last request
+    mLocker.Lock();
+    std::string text = mRequestText;
+    FolderData::FastSearchContext context = mRequestContext;
+    int generation = mGeneration;
+    mLocker.UnLock();
+    processed = generation;
+    if (text.empty()) continue; // Canceled
+
+    FolderData::ResultList results;
+    if (!Search(context, text, generation, results)) continue;
+    if (results.size() > 1)
+      SystemManager::SearchResultQuickSortAscending(results, 0, (int)results.size() - 1);
+
+    // Hand back results
+    mLocker.Lock();
+    mResults.clear();
+    for (int i = 0; i < (int)results.size() && i < mMaxGlobal; ++i)
+      mResults.push_back(results[i].Data);
+    mResultGeneration = generation;
+    mResultTreeRevision = mLastTreeRevision;
+    mLocker.UnLock();
+    mSender.Call();
+  }
+}
+
+void GameSearcher::ReceiveSyncCallback(const SDL_Event& event)
+{
+  (void)event;
+
+  mLocker.Lock();
+  bool last = (mResultGeneration == mGeneration);
+  // Trees are only modified by the main thread: results are valid as long as the revision is unchanged
+  bool modified = last && mResultTreeRevision != TreeRevision();
+  if (modified) mGeneration++; // Search again
+  FileData::List results;
+  if (last && !modified) results.swap(mResults);
+  mLocker.UnLock();
+
+  // Results of canceled searches are dropped
+  if (modified) mSignal.Signal();
+  else if (last)
+    mNotification.GameSearchCompleted(results);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/sdl2/ISynchronousEvent.h>
+#include <utils/sdl2/SyncronousEvent.h>
+#include <utils/cplusplus/INoCopy.h>
+#include <games/FolderData.h>
+#include "IGameSearchNotification.h"
+
+class SystemData;
+class SystemManager;
+
+/*!
+ * @brief Type-ahead game search, running in background
+ *
+ * Each new request cancels the one in progress, if any. Results of the last request only are
+ * handed back in the main thread.
+ * When a request extends the previous text, previous results are narrowed instead of searching
+ * all systems again, as long as no system limit has been reached.
+ * The tree lock is held for a single system or a bounded chunk of previous results at once. Searches start over
+ * when trees are modified meanwhile, and results are searched again if trees are modified before they are handed back.
+ */
+class GameSearcher : private INoCopy
+                   , private Thread
+                   , public ISynchronousEvent
+{
+  public:
+    /*!
+     * @brief Constructor - Start the search thread
+     * @param notification Result receiver
+     * @param systemManager System manager, providing searchable systems and the tree lock
+     * @param maxPerSystem Maximum results per system
+     * @param maxGlobal Maximum results
+     */
+    GameSearcher(IGameSearchNotification& notification, SystemManager& systemManager, int maxPerSystem, int maxGlobal);
+
+    //! Destructor - Cancel any search and stop the thread
+    ~GameSearcher() override;
+
+    /*!
+     * @brief Request a new search. Any search in progress is canceled
+     * @param context Field in which to search text for
+     * @param text Text to search for
+     */
+    void Search(FolderData::FastSearchContext context, const std::string& text);
+
+    /*!
+     * @brief Cancel any search in progress. Results will not be notified
+     */
+    void Cancel();
+
+  private:
+    //! Result receiver
+    IGameSearchNotification& mNotification;
+    //! Sync'ed event sender
+    SyncronousEvent mSender;
+    //! System manager
+    SystemManager& mSystemManager;
+    //! Systems to search in
+    std::vector<SystemData*> mSystems;
+    //! Maximum results per system
+    int mMaxPerSystem;
+    //! Maximum results
+    int mMaxGlobal;
+
+    //! Request & result protection
+    Mutex mLocker;
+    //! New request signal
+    Mutex mSignal;
+    //! Requested text, as a search key
+    std::string mRequestText;
+    //! Requested context
+    FolderData::FastSearchContext mRequestContext;
+    //! Request generation, bumped on each request or cancellation
+    std::atomic<int> mGeneration;
+    //! Results of the last search
+    FileData::List mResults;
+    //! Generation of the last results
+    int mResultGeneration;
+    //! Tree revision of the last results
+    int mResultTreeRevision;
+
+    /*
+     * Search thread only
+     */
+
+    //! Unsorted results of the last complete search
+    FolderData::ResultList mLast;
+    //! Text of the last complete search
+    std::string mLastText;
+    //! Context of the last complete search
+    FolderData::FastSearchContext mLastContext;
+    //! True if the last search reached no limit, so that it can be narrowed
+    bool mLastNarrowable;
+    //! Tree revision of the last complete search
+    int mLastTreeRevision;
+
+    //! Previous results narrowed per tree lock
+    static constexpr int sGamesPerLock = 256;
+
+    /*!
+     * @brief Get the sum of the tree revisions of all searched systems.
+     * Revisions only grow, so any item addition or removal changes the sum
+     * @return Tree revision
+     */
+    int TreeRevision() const;
+
+    /*!
+     * @brief Run a search, taking the tree lock as required
+     * @param context Field in which to search text for
+     * @param text Text to search for, as a search key
+     * @param generation Request generation
+     * @param results Result list to fill
+     * @return False if the search has been canceled
+     */
+    bool Search(FolderData::FastSearchContext context, const std::string& text, int generation, FolderData::ResultList& results);
+
+    /*
+     * Thread implementation
+     */
+
+    void Run() override;
+
+    void Break() override { mSignal.Signal(); }
+
+    /*
+     * ISynchronousEvent implementation
+     */
+
+    void ReceiveSyncCallback(const SDL_Event& event) override;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <games/FileData.h>
+
+class IGameSearchNotification
+{
+  public:
+    /*!
+     * @brief Called from the main thread when the last requested search is complete
+     * @param results Games found, sorted by distance
+     */
+    virtual void GameSearchCompleted(const FileData::List& results) = 0;
+};
@@ -0,0 +1,98 @@
+#include "LazySystemLoader.h"
+#include "SystemManager.h"
+#include <utils/Log.h>
+#include <algorithm>
+
+LazySystemLoader::LazySystemLoader(SystemManager& systemManager)
+  : mSystemManager(systemManager),
+    mSender(this),
+    mPrioritized(nullptr)
+{
+}
+
+LazySystemLoader::~LazySystemLoader()
+{
+  // Wait for the system being loaded, if any
+  Thread::Stop();
+
+  // Drop trees never handed back
+  for(const Result& result : mLoaded)
+    for(RootFolderData* root : result.Roots)
+      delete root;
+}
+
+void LazySystemLoader::Push(SystemData* system)
+{
+  Mutex::AutoLock locker(mLocker);
+  mPending.push_back(system);
+}
+
+void LazySystemLoader::Prioritize(SystemData* system)
+{
+  Mutex::AutoLock locker(mLocker);
+  auto it = std::find(mPending.begin(), mPending.end(), system);
+  if (it == mPending.end()) return; // Being loaded or already loaded
+
+  LOG(LogInfo) << "[LazyLoad] Prioritize " << system->getFullName();
+  mPending.erase(it);
+  mPending.push_front(system);
+  mPrioritized = system;
+}
+
+SystemData* LazySystemLoader::Next(bool& prioritized)
+{
+  Mutex::AutoLock locker(mLocker);
+  if (mPending.empty()) return nullptr;
+  SystemData* system = mPending.front();
+  mPending.pop_front();
+  prioritized = (system == mPrioritized);
+  return system;
+}
+
+void LazySystemLoader::Run()
+{
+  // Only created when the user is waiting for a system
+  WorkStealingScheduler* scheduler = nullptr;
+
+  while(IsRunning())
+  {
+    bool prioritized = false;
+    SystemData* system = Next(prioritized);
+    if (system == nullptr) break;
+
+    // Use all cores when the user is waiting, keep a low profile otherwise
+    if (prioritized && scheduler == nullptr)
+      scheduler = new WorkStealingScheduler("Lazy-Scan", 0);
+
+    LOG(LogInfo) << "[LazyLoad] Loading " << system->getFullName();
+    Result result { system, {} };
+    try
+    {
+      result.Roots = mSystemManager.LoadRootFolders(*system, false, prioritized ? scheduler : nullptr);
+    }
+    catch(std::exception& ex)
+    {
+      LOG(LogError) << "[LazyLoad] System \"" << system->getFullName() << "\" has raised an error: " << ex.what();
+    }
+
+    mLocker.Lock();
+    mLoaded.push_back(std::move(result));
+    mLocker.UnLock();
+    mSender.Call();
+  }
+
+  delete scheduler;
+}
+
+void LazySystemLoader::ReceiveSyncCallback(const SDL_Event& event)
+{
+  (void)event;
+
+  mLocker.Lock();
+  std::vector<Result> loaded;
+  loaded.swap(mLoaded);
+  mLocker.UnLock();
+
+  for(const Result& result : loaded)
+    mSystemManager.LazySystemLoaded(*result.System, result.Roots);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/sdl2/ISynchronousEvent.h>
+#include <utils/sdl2/SyncronousEvent.h>
+#include <utils/cplusplus/INoCopy.h>
+
+class SystemManager;
+class SystemData;
+class RootFolderData;
+
+/*!
+ * @brief Background loader of systems not required at startup
+ *
+ * Systems are loaded one at a time, in the order they are pushed, unless one of them
+ * is prioritized because the user wants to browse it.
+ * Game trees are built apart from the system and handed back to the SystemManager
+ * in the main thread, so that views never see a partial tree.
+ */
+class LazySystemLoader : private INoCopy
+                       , private Thread
+                       , public ISynchronousEvent
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param systemManager Parent system manager
+     */
+    explicit LazySystemLoader(SystemManager& systemManager);
+
+    /*!
+     * @brief Destructor. Stop loading and drop trees not handed back yet
+     */
+    ~LazySystemLoader() override;
+
+    /*!
+     * @brief Add a system to load
+     * @param system System in loading state
+     */
+    void Push(SystemData* system);
+
+    /*!
+     * @brief Start loading pushed systems
+     */
+    void StartLoading() { Thread::Start("Lazy-Load"); }
+
+    /*!
+     * @brief Load the given system next
+     * @param system System to load as soon as possible
+     */
+    void Prioritize(SystemData* system);
+
+  private:
+    //! Loaded system & its root folders
+    struct Result
+    {
+      SystemData* System;                 //!< Loaded system
+      std::vector<RootFolderData*> Roots; //!< Detached root folders
+    };
+
+    //! Parent system manager
+    SystemManager& mSystemManager;
+    //! Sync'ed event sender
+    SyncronousEvent mSender;
+    //! Pending & loaded lists protection
+    Mutex mLocker;
+    //! Systems to load
+    std::deque<SystemData*> mPending;
+    //! Systems loaded, to hand back in the main thread
+    std::vector<Result> mLoaded;
+    //! System the user is waiting for, if any
+    SystemData* mPrioritized;
+
+    /*!
+     * @brief Get the next system to load
+     * @param prioritized Set to true if the user is waiting for the returned system
+     * @return Next system or nullptr if there is no more system to load
+     */
+    SystemData* Next(bool& prioritized);
+
+    /*
+     * Thread implementation
+     */
+
+    void Run() override;
+
+    /*
+     * ISynchronousEvent implementation
+     */
+
+    void ReceiveSyncCallback(const SDL_Event& event) override;
+};
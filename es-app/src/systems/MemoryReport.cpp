@@ -0,0 +1,81 @@
+#include "MemoryReport.h"
+#include <systems/SystemManager.h>
+#include <games/PathIndex.h>
+#include <utils/storage/StringPool.h>
+#include <utils/Strings.h>
+#include <utils/Log.h>
+
+bool MemoryReport::Refresh()
+{
+  int revision = GameIndex::SharedRevision();
+  const SystemManager::SystemList& systems = mSystemManager.GetAllSystemList();
+  if (revision == mRevision && systems.size() == mSystems.size()) return false;
+
+  mSystems.clear();
+  mSystems.reserve(systems.size());
+  for (const SystemData* system : systems)
+  {
+    System current;
+    current.Name = system->getName();
+    current.Virtual = system->IsVirtual();
+    current.Nodes = system->NodeMemoryUsage();
+    system->AddMemoryUsage(current.Usage);
+    mSystems.push_back(current);
+  }
+  mInternedStrings = StringPool::Size();
+  mDoppelgangerPeak = PathIndex::PeakMemoryUsage();
+  mRevision = revision;
+  return true;
+}
+
+size_t MemoryReport::Sum(size_t& nodes, FileData::MemoryUsage& usage, bool virtualSystems) const
+{
+  size_t total = 0;
+  for (const System& system : mSystems)
+    if (system.Virtual == virtualSystems)
+    {
+      nodes += system.Nodes;
+      usage.Lists += system.Usage.Lists;
+      usage.Strings += system.Usage.Strings;
+      usage.Paths += system.Usage.Paths;
+      usage.Indexes += system.Usage.Indexes;
+      total += system.Total();
+    }
+  return total;
+}
+
+void MemoryReport::LogReport() const
+{
+  size_t nodes = 0;
+  FileData::MemoryUsage usage;
+  size_t trees = Sum(nodes, usage, false);
+  size_t metaSystems = Sum(nodes, usage, true);
+
+  LOG(LogInfo) << "[Memory] Game database: " << Format(trees + metaSystems + mInternedStrings);
+  LOG(LogInfo) << "[Memory]   Nodes: " << Format(nodes) << " - Lists: " << Format(usage.Lists) << " - Indexes: " << Format(usage.Indexes);
+  LOG(LogInfo) << "[Memory]   Strings: " << Format(usage.Strings) << " - Interned: " << Format(mInternedStrings) << " - Paths: " << Format(usage.Paths);
+  LOG(LogInfo) << "[Memory]   Systems: " << Format(trees) << " - Meta-systems: " << Format(metaSystems) << " - Doppelganger peak: " << Format(mDoppelgangerPeak);
+  for (const System& system : mSystems)
+    LOG(LogDebug) << "[Memory]   " << (system.Virtual ? "Meta-system " : "System ") << system.Name << ": " << Format(system.Total())
+                  << " (nodes " << Format(system.Nodes) << ", strings " << Format(system.Usage.Strings) << ", paths " << Format(system.Usage.Paths)
+                  << ", lists " << Format(system.Usage.Lists) << ", indexes " << Format(system.Usage.Indexes) << ')';
+}
+
+std::string MemoryReport::Summary() const
+{
+  size_t nodes = 0;
+  FileData::MemoryUsage usage;
+  size_t trees = Sum(nodes, usage, false);
+  size_t metaSystems = Sum(nodes, usage, true);
+
+  return "Games DB: " + Format(trees + metaSystems + mInternedStrings) +
+         " Nodes: " + Format(nodes) + " Str: " + Format(usage.Strings + mInternedStrings) + " Paths: " + Format(usage.Paths) +
+         "\nLists: " + Format(usage.Lists) + " Idx: " + Format(usage.Indexes) + " Meta: " + Format(metaSystems) +
+         " Dopp: " + Format(mDoppelgangerPeak);
+}
+
+std::string MemoryReport::Format(size_t size)
+{
+  if (size < (1 << 20)) return Strings::ToString((float)size / 1024.0f, 1) + "Kb";
+  return Strings::ToString((float)size / (1024.0f * 1024.0f), 2) + "Mb";
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <games/FileData.h>
+
+class SystemManager;
+
+/*!
+ * @brief Memory accounting of the game database
+ *
+ * Breaks down memory used by item nodes, metadata strings, paths, child lists, indexes
+ * and doppelganger maps, for regular systems and meta-systems.
+ * Views are never computed by the report: views not built yet cost nothing.
+ */
+class MemoryReport
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param systemManager System manager to report
+     */
+    explicit MemoryReport(SystemManager& systemManager)
+      : mSystemManager(systemManager)
+      , mRevision(-1)
+      , mInternedStrings(0)
+      , mDoppelgangerPeak(0)
+    {
+    }
+
+    /*!
+     * @brief Compute the report again if the game database changed since the last computation
+     * @return True if the report has been computed
+     */
+    bool Refresh();
+
+    /*!
+     * @brief Log the full report: totals, then systems
+     */
+    void LogReport() const;
+
+    /*!
+     * @brief Get a short report for the framerate overlay
+     * @return Short report
+     */
+    std::string Summary() const;
+
+  private:
+    //! Memory used by a single system
+    struct System
+    {
+      std::string Name;            //!< System name
+      bool Virtual;                //!< Meta-system
+      size_t Nodes;                //!< Item nodes
+      FileData::MemoryUsage Usage; //!< Heap memory
+      //! Total size
+      size_t Total() const { return Nodes + Usage.Lists + Usage.Strings + Usage.Paths + Usage.Indexes; }
+    };
+
+    //! System manager
+    SystemManager& mSystemManager;
+    //! Systems
+    std::vector<System> mSystems;
+    //! Game database revision of the last computation
+    int mRevision;
+    //! Interned strings, shared by all systems
+    size_t mInternedStrings;
+    //! Largest doppelganger map
+    size_t mDoppelgangerPeak;
+
+    /*!
+     * @brief Sum system usages
+     * @param nodes Item node size to update
+     * @param usage Heap memory to update
+     * @param virtualSystems True to sum meta-systems, false to sum regular systems
+     * @return Total size
+     */
+    size_t Sum(size_t& nodes, FileData::MemoryUsage& usage, bool virtualSystems) const;
+
+    /*!
+     * @brief Format a size for humans
+     * @param size Size in bytes
+     * @return Size in Kb or Mb
+     */
+    static std::string Format(size_t size);
+};
@@ -0,0 +1,37 @@
+#include "PlayStatsCompactor.h"
+#include "SystemManager.h"
+#include <utils/datetime/DateTime.h>
+#include <utils/Log.h>
+
+PlayStatsCompactor::PlayStatsCompactor(SystemManager& systemManager)
+  : mSystemManager(systemManager),
+    mCompacting(false)
+{
+}
+
+void PlayStatsCompactor::Start()
+{
+  mCompacting = true;
+  Thread::Start("PlayStats");
+}
+
+void PlayStatsCompactor::Run()
+{
+  DateTime start;
+  int written = 0;
+  for (int i = 0; IsRunning(); ++i)
+  {
+    // Release the tree between two systems, so that the main thread is never held for long
+    Mutex::AutoLock locker(mSystemManager.TreeLocker());
+    const SystemManager::SystemList& systems = mSystemManager.GetAllSystemList();
+    if (i >= (int)systems.size()) break;
+    SystemData* system = systems[i];
+    if (system->IsVirtual() || system->IsLoading()) continue;
+    system->UpdateGamelistXml(true);
+    written++;
+  }
+  DateTime stop;
+  LOG(LogDebug) << "Play statistics compaction time: " << std::to_string((stop-start).TotalMilliseconds()) << "ms, "
+                << written << " systems" << (IsRunning() ? "" : " (cancelled)");
+  mCompacting = false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <utils/os/system/Thread.h>
+#include <utils/cplusplus/INoCopy.h>
+
+class SystemManager;
+
+/*!
+ * @brief Background writer folding journaled play statistics into gamelists while the user is idle
+ *
+ * Systems are written one at a time, holding the tree lock of the system manager.
+ * Compaction is cancelled between two systems as soon as the user is back.
+ */
+class PlayStatsCompactor : private INoCopy
+                         , private Thread
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param systemManager Parent system manager
+     */
+    explicit PlayStatsCompactor(SystemManager& systemManager);
+
+    /*!
+     * @brief Destructor. Wait for the system being written, if any
+     */
+    ~PlayStatsCompactor() override { Cancel(); }
+
+    /*!
+     * @brief Start compacting all systems
+     */
+    void Start();
+
+    /*!
+     * @brief Stop compacting, once the system being written is complete
+     */
+    void Cancel() { Thread::Stop(); }
+
+    /*!
+     * @brief Check if compaction is still in progress
+     * @return True if some systems are still to be written
+     */
+    bool Compacting() const { return mCompacting; }
+
+  private:
+    //! Parent system manager
+    SystemManager& mSystemManager;
+    //! True until all systems have been written or the compaction is cancelled
+    volatile bool mCompacting;
+
+    /*
+     * Thread implementation
+     */
+
+    void Run() override;
+};
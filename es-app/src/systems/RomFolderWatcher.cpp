@@ -0,0 +1,124 @@
+#include "RomFolderWatcher.h"
+#include <games/RootFolderData.h>
+#include <utils/Log.h>
+#include <utils/Strings.h>
+#include <SDL_timer.h>
+#include <algorithm>
+
+RomFolderWatcher::RomFolderWatcher(int maxWatches, int delay)
+  : mMaxWatches(maxWatches),
+    mDelay(delay),
+    mLastEvent(0),
+    mCapped(false)
+{
+  // Entry events only: file contents are not our business
+  mWatcher.SetEventMask(EventType::Create | EventType::Remove | EventType::MovedFrom | EventType::MovedTo | EventType::CloseWrite);
+}
+
+void RomFolderWatcher::Watch(const RootFolderData& root)
+{
+  const Path& rootPath = root.getPath();
+  mRoots.push_back(rootPath);
+
+  // Folders recorded by the last scan, including empty ones, are watched without listing the rom tree again
+  ScanManifest manifest(rootPath);
+  if (manifest.Load() && manifest.Previous(rootPath) != nullptr) WatchManifestFolders(rootPath, manifest);
+  else WatchTreeFolders(root);
+  LOG(LogDebug) << "[RomWatch] " << mWatcher.WatchCount() << " folders watched after " << rootPath.ToString();
+}
+
+bool RomFolderWatcher::WatchFolder(const Path& folder)
+{
+  if (mWatcher.WatchCount() >= mMaxWatches)
+  {
+    if (!mCapped)
+      LOG(LogWarning) << "[RomWatch] Maximum watch count (" << mMaxWatches << ") reached. Remaining folders are not watched.";
+    mCapped = true;
+    return false;
+  }
+
+  mWatcher.WatchFile(folder);
+  return true;
+}
+
+void RomFolderWatcher::WatchRecursively(const Path& folder)
+{
+  if (!WatchFolder(folder)) return;
+  for (const Path::DirectoryEntry& entry : folder.GetDirectoryEntries())
+    if (entry.IsDirectory() && !entry.IsHidden() && !entry.SymLink && entry.Name != "media")
+      WatchRecursively(folder / entry.Name);
+}
+
+void RomFolderWatcher::WatchManifestFolders(const Path& folder, const ScanManifest& manifest)
+{
+  // Not scanned yet, like folders skipped by the scanner: list it
+  const ScanManifest::Folder* known = manifest.Previous(folder);
+  if (known == nullptr)
+  {
+    WatchRecursively(folder);
+    return;
+  }
+
+  if (!WatchFolder(folder)) return;
+  for (const std::string& subFolder : known->SubFolders)
+    if (std::find(known->SymLinks.begin(), known->SymLinks.end(), subFolder) == known->SymLinks.end())
+      WatchManifestFolders(folder / subFolder, manifest);
+}
+
+void RomFolderWatcher::WatchTreeFolders(const FolderData& root)
+{
+  if (!WatchFolder(root.getPath())) return;
+  // Fallback only: folders without games are not in the tree, so they are not watched
+  FileData::List folders;
+  root.getFoldersRecursivelyTo(folders);
+  for (const FileData* folder : folders)
+    if (!WatchFolder(folder->getPath())) return;
+}
+
+void RomFolderWatcher::AddModified(const Path& folder)
+{
+  if (std::find(mModified.begin(), mModified.end(), folder) == mModified.end())
+    mModified.push_back(folder);
+}
+
+bool RomFolderWatcher::GetModifiedFolders(Path::PathList& folders)
+{
+  FileSystemEvent event;
+  while (mWatcher.GetNextEvent(event))
+  {
+    mLastEvent = SDL_GetTicks();
+    if (hasFlag(event.mMask, EventType::QOverflow))
+    {
+      // Events have been lost: at least refresh top level folders
+      LOG(LogWarning) << "[RomWatch] Event queue overflow!";
+      for (const Path& root : mRoots)
+        AddModified(root);
+      continue;
+    }
+
+    // Gamelists & hidden files are not scanned: ignore them, as gamelist writes would trigger useless rescans
+    std::string name = event.mPath.Filename();
+    if (name.empty() || name[0] == '.' || Strings::StartsWith(name, LEGACY_STRING("gamelist."))) continue;
+
+    AddModified(event.mPath.Directory());
+    if (hasFlag(event.mMask, EventType::IsDir))
+    {
+      // Gone folders no longer count in the cap
+      if (hasFlag(event.mMask, EventType::Remove | EventType::MovedFrom))
+      {
+        mWatcher.UnwatchDirectoryRecursively(event.mPath);
+        mCapped = false;
+      }
+      // New folders must be watched as soon as possible, to catch their content
+      if (hasFlag(event.mMask, EventType::Create | EventType::MovedTo))
+        WatchRecursively(event.mPath);
+    }
+  }
+
+  // Wait for the storm to calm down
+  if (mModified.empty() || (int)(SDL_GetTicks() - mLastEvent) < mDelay) return false;
+
+  folders.swap(mModified);
+  mModified.clear();
+  return true;
+}
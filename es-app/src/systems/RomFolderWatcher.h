@@ -0,0 +1,91 @@
+#pragma once
+
+#include <utils/os/fs/watching/FileSystemWatcher.h>
+#include <utils/cplusplus/INoCopy.h>
+#include <games/ScanManifest.h>
+
+// Forward declaration
+class RootFolderData;
+class FolderData;
+
+/*!
+ * @brief Recursive inotify watch of rom folders
+ *
+ * Only directories are watched, since they receive events for all their entries.
+ * Known directories are taken from the scan manifest, or from the loaded tree when there is no manifest,
+ * so that rom folders are never listed again. Only new directories are listed when they appear.
+ * Events are coalesced by folder and reported once no more event has been received
+ * for a while, so that copying a whole rom set results in a single tree update.
+ * The number of watches is capped: folders beyond the cap are simply not watched.
+ */
+class RomFolderWatcher : private INoCopy
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param maxWatches Maximum number of watched folders
+     * @param delay Quiet delay (ms) before reporting modified folders
+     */
+    RomFolderWatcher(int maxWatches, int delay);
+
+    /*!
+     * @brief Watch the given root folder and all its known sub-folders
+     * @param root Root rom folder
+     */
+    void Watch(const RootFolderData& root);
+
+    /*!
+     * @brief Read pending events and get modified folders once the quiet delay has elapsed
+     * @param folders List to fill with modified folders
+     * @return True if the list has been filled
+     */
+    bool GetModifiedFolders(Path::PathList& folders);
+
+  private:
+    //! Underlying watcher
+    FileSystemWatcher mWatcher;
+    //! Watched roots, to rescan when events have been lost
+    Path::PathList mRoots;
+    //! Modified folders, in event order
+    Path::PathList mModified;
+    //! Maximum number of watched folders
+    int mMaxWatches;
+    //! Quiet delay (ms)
+    int mDelay;
+    //! Last event time (ms)
+    unsigned int mLastEvent;
+    //! Watch cap reached
+    bool mCapped;
+
+    /*!
+     * @brief Watch a single folder, unless the cap is reached
+     * @param folder Folder to watch
+     * @return True if the folder is watched
+     */
+    bool WatchFolder(const Path& folder);
+
+    /*!
+     * @brief Watch the given folder and its sub-folders listed from disk, until the cap is reached
+     * @param folder Folder to watch
+     */
+    void WatchRecursively(const Path& folder);
+
+    /*!
+     * @brief Watch the given folder and its sub-folders recorded in the scan manifest, until the cap is reached
+     * @param folder Folder to watch
+     * @param manifest Scan manifest of the root folder
+     */
+    void WatchManifestFolders(const Path& folder, const ScanManifest& manifest);
+
+    /*!
+     * @brief Watch the given root folder and its sub-folders from the loaded tree, until the cap is reached
+     * @param root Root folder to watch
+     */
+    void WatchTreeFolders(const FolderData& root);
+
+    /*!
+     * @brief Record a modified folder, once
+     * @param folder Modified folder
+     */
+    void AddModified(const Path& folder);
+};
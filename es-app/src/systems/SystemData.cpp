@@ -14,6 +14,10 @@
 #include <themes/ThemeException.h>
 #include <padtokeyboard/PadToKeyboardManager.h>
 #include <utils/Zip.h>
+#include <utils/XmlStream.h>
+#include <games/GamelistSnapshot.h>
+#include <games/ScanManifest.h>
+#include <games/PlayStatsJournal.h>
 
 bool SystemData::sIsGameRunning = false;
 Path SystemData::sGovernancePath(SystemData::sGovernanceFile);
@@ -21,10 +25,16 @@ Path SystemData::sGovernancePath(SystemData::sGovernanceFile);
 SystemData::SystemData(SystemManager& systemManager, const SystemDescriptor& descriptor, Properties properties, FileSorts::Sorts fixedSort)
   : mSystemManager(systemManager),
     mDescriptor(descriptor),
+    mTreeRevision(0),
+    mGameIndex(hasFlag(properties, Properties::Virtual)),
     mRootOfRoot(mRootOfRoot, RootFolderData::Ownership::None, RootFolderData::Types::None, Path(), *this),
+    mSearchIndex(mRootOfRoot, mTreeRevision, systemManager.TreeLocker()),
+    mView(nullptr),
     mSortId(RecalboxConf::Instance().AsInt(mDescriptor.Name() + ".sort")),
     mProperties(properties),
-    mFixedSort(fixedSort)
+    mFixedSort(fixedSort),
+    mLoading(false),
+    mEstimatedCount(0)
 {
 }
 
@@ -198,6 +208,10 @@ void SystemData::RunGame(WindowManager& window,
   // Update last played time
   systemManager.UpdateLastPlayedSystem(game);
   game.Metadata().SetLastplayedNow();
+  game.HotMetadataChanged();
+
+  // Keep statistics safe right now, without rewriting the gamelist
+  PlayStatsJournal::Append(game);
 }
 
 std::string SystemData::demoInitialize(WindowManager&)
@@ -280,13 +294,16 @@ SystemData::DemoRunGame(const FileData& game, const EmulatorData& emulator, int
   return false;
 }
 
-void SystemData::populateFolder(RootFolderData& root, FileData::StringMap& doppelgangerWatcher)
+void SystemData::populateFolder(RootFolderData& root, PathIndex& doppelgangerWatcher, WorkStealingScheduler* scheduler)
 {
   LOG(LogInfo) << root.getSystem()->getFullName() << ": Searching games/roms in " << root.getPath().ToString() << "...";
 
   try
   {
-    root.populateRecursiveFolder(root, Strings::ToLowerASCII(mDescriptor.Extension()), doppelgangerWatcher);
+    ScanManifest manifest(root.getPath());
+    manifest.Load();
+    root.populateRecursiveFolder(root, Strings::ToLowerASCII(mDescriptor.Extension()), doppelgangerWatcher, manifest, scheduler);
+    manifest.Save();
   }
   catch (std::exception& ex)
   {
@@ -295,6 +312,12 @@ void SystemData::populateFolder(RootFolderData& root, FileData::StringMap& doppe
   }
 }
 
+bool SystemData::IsScanUpToDate(const RootFolderData& root) const
+{
+  ScanManifest manifest(root.getPath());
+  return manifest.Load() && root.isScanUpToDate(Strings::ToLowerASCII(mDescriptor.Extension()), manifest);
+}
+
 Path SystemData::getGamelistPath(const RootFolderData& root, bool forWrite)
 {
   bool zip = RecalboxConf::Instance().AsBool("emulationstation.zippedgamelist", false);
@@ -430,7 +453,7 @@ void SystemData::overrideFolderInformation(FileData* folderdata)
   }
 }
 
-FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path& rootPath, const Path& path, ItemType type, FileData::StringMap& doppelgangerWatcher) const
+FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path& rootPath, const Path& path, ItemType type, PathIndex& doppelgangerWatcher, FileData* source) const
 {
   if (!path.StartWidth(rootPath))
   {
@@ -444,11 +467,18 @@ FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path
   int itemStart = rootPath.ItemCount();
   int itemLast = path.ItemCount() - 1;
   FolderData* treeNode = &topAncestor;
+  // Keys are full path prefixes. Their hashes are grown one component at a time, and strings are only built for new folders
+  const std::string& fullPath = path.ToString();
+  size_t keyEnd = rootPath.ToString().size();
+  PathIndex::Hash hash = PathIndex::HashPath(fullPath.data(), keyEnd);
   for (int itemIndex = itemStart; itemIndex <= itemLast; ++itemIndex)
   {
     // Get the key for duplicate detection. MUST MATCH KEYS USED IN populateRecursiveFolder.populateRecursiveFolder - Always fullpath
-    std::string key = path.UptoItem(itemIndex);
-    FileData* item = (doppelgangerWatcher.find(key) != doppelgangerWatcher.end()) ? doppelgangerWatcher[key] : nullptr;
+    size_t keyStart = keyEnd;
+    keyEnd = fullPath.find('/', keyEnd + 1);
+    if (keyEnd == std::string::npos) keyEnd = fullPath.size();
+    hash = PathIndex::HashPath(fullPath.data() + keyStart, keyEnd - keyStart, hash);
+    FileData* item = doppelgangerWatcher.Lookup(hash, fullPath.data(), keyEnd);
 
     // Some ScummVM folder/games may create inconsistent folders
     if (!treeNode->isFolder()) return nullptr;
@@ -462,18 +492,16 @@ FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path
         if (game == nullptr && !isVirtual)
         {
           // Add final game
-          game = new FileData(path, topAncestor);
-          doppelgangerWatcher[key] = game;
+          game = new (topAncestor.System().ItemArena()) FileData(path, topAncestor);
+          doppelgangerWatcher.Set(hash, fullPath.data(), keyEnd, game);
           treeNode->addChild(game, true);
         }
-        // Virtual systems use the doppleganger map in a reverse way:
-        // Game to insert are already in the map
-        // and are added as parent-less game in the virtual system
-        else if (game != nullptr && isVirtual)
+        // Virtual systems add the source game as a parent-less game, once
+        else if (game == nullptr && source != nullptr)
         {
-          // Add existing game & remove from doppleganger
+          game = source;
+          doppelgangerWatcher.Set(hash, fullPath.data(), keyEnd, game);
           treeNode->addChild(game, false);
-          doppelgangerWatcher.erase(key);
         }
         return game;
       }
@@ -483,8 +511,8 @@ FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path
         if (folder == nullptr)
         {
           // Create missing folder in both case, virtual or not
-          folder = new FolderData(Path(key), topAncestor);
-          doppelgangerWatcher[key] = folder;
+          folder = new (topAncestor.System().ItemArena()) FolderData(Path(fullPath.substr(0, keyEnd)), topAncestor);
+          doppelgangerWatcher.Set(hash, fullPath.data(), keyEnd, folder);
           treeNode->addChild(folder, true);
         }
         return folder;
@@ -496,8 +524,8 @@ FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path
       if (folder == nullptr)
       {
         // Create missing folder in both case, virtual or not
-        folder = new FolderData(Path(key), topAncestor);
-        doppelgangerWatcher[key] = folder;
+        folder = new (topAncestor.System().ItemArena()) FolderData(Path(fullPath.substr(0, keyEnd)), topAncestor);
+        doppelgangerWatcher.Set(hash, fullPath.data(), keyEnd, folder);
         treeNode->addChild(folder, true);
       }
       treeNode = folder;
@@ -507,14 +535,111 @@ FileData* SystemData::LookupOrCreateGame(RootFolderData& topAncestor, const Path
   return nullptr;
 }
 
-void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& doppelgangerWatcher, bool forceCheckFile)
+void SystemData::ParseGamelistXml(RootFolderData& root, PathIndex& doppelgangerWatcher, bool forceCheckFile, WorkStealingScheduler* scheduler, bool replace)
 {
+  /*!
+   * @brief Receive gamelist nodes by batches.
+   * Items are looked up/created first, since it builds the tree. Then metadata, the costliest part,
+   * are deserialized, possibly in parallel. Duplicate nodes are kept aside and deserialized last, in order.
+   * In replace mode (journal replay, external changes), metadata are reset before being deserialized,
+   * since default values are not stored. In dirty mode, loaded items are marked dirty so that they are written
+   * in the next gamelist
+   */
+  class Receiver : public XmlStream::IReceiver
+  {
+    private:
+      const SystemData& mSystem;
+      RootFolderData& mRoot;
+      PathIndex& mDoppelgangerWatcher;
+      WorkStealingScheduler* mScheduler;
+      bool mForceCheckFile;
+      bool mReplace;
+      bool mDirty;
+
+      void Load(FileData& file, const XmlNode node, const Path& relativeTo) const
+      {
+        if (mReplace) file.Metadata() = MetadataDescriptor(file.getDisplayName(), file.getType());
+        file.Metadata().Deserialize(node, relativeTo);
+        if (mDirty) file.Metadata().SetDirty();
+      }
+
+    public:
+      Receiver(const SystemData& system, RootFolderData& root, PathIndex& doppelgangerWatcher, WorkStealingScheduler* scheduler,
+               bool forceCheckFile, bool replace, bool dirty)
+        : mSystem(system),
+          mRoot(root),
+          mDoppelgangerWatcher(doppelgangerWatcher),
+          mScheduler(scheduler),
+          mForceCheckFile(forceCheckFile),
+          mReplace(replace),
+          mDirty(dirty)
+      {
+      }
+
+      bool ReceiveElements(XmlNode elements) override
+      {
+        const Path& relativeTo = mRoot.getPath();
+        std::vector<std::pair<FileData*, XmlNode>> nodes;
+        std::vector<std::pair<FileData*, XmlNode>> duplicates;
+        HashMap<FileData*, bool> found;
+        for (const XmlNode fileNode : elements.children())
+        {
+          ItemType type;
+          std::string name = fileNode.name();
+          if (name == "game") type = ItemType::Game;
+          else if (name == "folder") type = ItemType::Folder;
+          else continue; // Unknown node
+
+          Path path = relativeTo / Xml::AsString(fileNode, "path", "");
+          if (mForceCheckFile)
+            if (!path.Exists())
+              continue;
+
+          FileData* file = mSystem.LookupOrCreateGame(mRoot, relativeTo, path, type, mDoppelgangerWatcher);
+          if (file == nullptr)
+          {
+            LOG(LogError) << "Error finding/creating FileData for \"" << path.ToString() << "\", skipping.";
+            continue;
+          }
+
+          if (found.insert(file, true).second) nodes.push_back({ file, fileNode });
+          else duplicates.push_back({ file, fileNode });
+        }
+
+        // load the metadata
+        static constexpr int sChunkSize = 256;
+        int count = (int)nodes.size();
+        if (mScheduler != nullptr && count > sChunkSize)
+        {
+          WorkStealingScheduler::Group chunks;
+          for (int start = 0; start < count; start += sChunkSize)
+            mScheduler->Push(chunks, [this, &nodes, &relativeTo, start, count]
+            {
+              for (int i = start, end = std::min(start + sChunkSize, count); i < end; ++i)
+                Load(*nodes[i].first, nodes[i].second, relativeTo);
+            });
+          mScheduler->Wait(chunks);
+        }
+        else
+          for (const auto& node : nodes)
+            Load(*node.first, node.second, relativeTo);
+        for (const auto& node : duplicates)
+          Load(*node.first, node.second, relativeTo);
+
+        return true;
+      }
+  };
+
   try
   {
     Path xmlpath = getGamelistPath(root, false);
     if (!xmlpath.Exists()) return;
 
-    XmlDocument gameList;
+    // Stream the gamelist so that neither the whole file nor its whole DOM are kept in memory
+    static constexpr int sBatchSize = 1024;
+    Receiver receiver(*this, root, doppelgangerWatcher, scheduler, forceCheckFile, replace, false);
+    XmlStream stream(receiver, "gameList", sBatchSize);
+    bool parsed = false;
     if (Strings::ToLowerASCII(xmlpath.Extension()) == ".zip")
     {
       Zip zip(xmlpath);
@@ -529,50 +654,29 @@ void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& dop
         LOG(LogError) << "Invalid zipped gamelist: No gamelist.xml found!";
         return;
       }
-      std::string content = zip.Content(0);
-      XmlResult result = gameList.load_string(content.data());
-      if (!result)
-      {
-        LOG(LogError) << "Could not parse " << xmlpath.ToString() << " file!";
-        return;
-      }
+      parsed = zip.Content(0, stream) && stream.Complete();
     }
-    else
+    else parsed = stream.ParseFile(xmlpath);
+
+    if (!parsed)
+      LOG(LogError) << "Could not parse " << xmlpath.ToString() << " file!";
+
+    // Replay changes journaled since our last gamelist rewrite, which always deletes the journal.
+    // A gamelist newer than the journal has been rewritten externally: journaled items are kept over it,
+    // and marked dirty so that the next save folds them into a full rewrite
+    Path journalPath = getGamelistJournalPath(root);
+    if (journalPath.Exists())
     {
-      XmlResult result = gameList.load_file(xmlpath.ToChars());
-      if (!result)
+      bool external = journalPath.LastModificationTime() < xmlpath.LastModificationTime();
+      if (external)
       {
-        LOG(LogError) << "Could not parse " << xmlpath.ToString() << " file!";
-        return;
+        LOG(LogInfo) << xmlpath.ToString() << " modified externally. Journaled changes are merged into it";
       }
+      Receiver journalReceiver(*this, root, doppelgangerWatcher, scheduler, forceCheckFile, true, external);
+      XmlStream journal(journalReceiver, std::string(), sBatchSize);
+      if (!journal.ParseFile(journalPath))
+        LOG(LogError) << "Could not parse " << journalPath.ToString() << " file!";
     }
-
-    const Path& relativeTo = root.getPath();
-    XmlNode games = gameList.child("gameList");
-    if (games != nullptr)
-      for (const XmlNode fileNode : games.children())
-      {
-        ItemType type;
-        std::string name = fileNode.name();
-        if (name == "game") type = ItemType::Game;
-        else if (name == "folder") type = ItemType::Folder;
-        else continue; // Unknown node
-
-        Path path = relativeTo / Xml::AsString(fileNode, "path", "");
-        if (forceCheckFile)
-          if (!path.Exists())
-            continue;
-
-        FileData* file = LookupOrCreateGame(root, relativeTo, path, type, doppelgangerWatcher);
-        if (file == nullptr)
-        {
-          LOG(LogError) << "Error finding/creating FileData for \"" << path.ToString() << "\", skipping.";
-          continue;
-        }
-
-        // load the metadata
-        file->Metadata().Deserialize(fileNode, relativeTo);
-      }
   }
   catch (std::exception& ex)
   {
@@ -581,7 +685,43 @@ void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& dop
   }
 }
 
-void SystemData::UpdateGamelistXml()
+void SystemData::RefreshGamelist(RootFolderData& root)
+{
+  // Existing items must be found, not created again
+  PathIndex doppelgangerWatcher;
+  root.BuildDoppelgangerMap(doppelgangerWatcher, true);
+  ParseGamelistXml(root, doppelgangerWatcher, false, nullptr, true);
+
+  // Keep play statistics not written in the gamelist yet
+  PlayStatsJournal::Replay(root);
+
+  // Metadata have been modified in bulk
+  mGameIndex.Invalidate();
+}
+
+bool SystemData::RefreshRomFolder(RootFolderData& root, const Path& folder, FileData::List& removed)
+{
+  // Lookup the deepest known folder. New folders are found by scanning their first known ancestor
+  PathIndex items;
+  root.BuildDoppelgangerMap(items, true);
+  FolderData* target = &root;
+  for (Path path = folder; path.StartWidth(root.getPath()) && path != root.getPath(); path = path.Directory())
+  {
+    FileData* item = items.Lookup(path);
+    if (item != nullptr && item->isFolder())
+    {
+      target = (FolderData*)item;
+      break;
+    }
+  }
+
+  std::string extensions = FolderData::GetFolderExtensions(root, target->getPath(), Strings::ToLowerASCII(mDescriptor.Extension()));
+  bool changed = target->refreshFolder(root, extensions, removed);
+  LOG(LogDebug) << "[RomWatch] " << target->getPath().ToString() << (changed ? " updated" : " unchanged");
+  return changed;
+}
+
+void SystemData::UpdateGamelistXml(bool journalOnly)
 {
   //We do this by reading the XML again, adding changes and then writing it back,
   //because there might be information missing in our systemdata which would then miss in the new XML.
@@ -593,70 +733,108 @@ void SystemData::UpdateGamelistXml()
     if (!root->ReadOnly() && root->IsDirty())
       try
       {
+        // Nothing to fold?
+        if (journalOnly && !PlayStatsJournal::Exists(*root)) continue;
+
         /*
          * Get all folder & games in a flat storage
          */
         FileData::List fileList = root->getAllItemsRecursively(true, true);
         FileData::List folderList = root->getAllFolders();
         // Nothing to process?
-        if (fileList.empty()) return;
+        if (fileList.empty()) continue;
 
         /*
-         * Create gamelist
+         * Get modified items
          */
-        Path xmlReadPath = getGamelistPath(*root, false);
-        XmlDocument document;
-        XmlNode gameList = document.append_child("gameList");
+        FileData::List dirtyList;
+        for (FileData* folder : folderList)
+          if (folder->Metadata().IsDirty()) dirtyList.push_back(folder);
+        for (FileData* file : fileList)
+          if (file->Metadata().IsDirty()) dirtyList.push_back(file);
 
         /*
-         * Serialize folder and game nodes
+         * Serialize items one by one, straight into the output file
          */
-        for (const FileData* folder : folderList)
-          folder->Metadata().Serialize(gameList, folder->getPath(), root->getPath());
-        for (const FileData* file : fileList)
-          file->Metadata().Serialize(gameList, file->getPath(), root->getPath());
+        auto write = [root](XmlStreamWriter& writer, const FileData::List& list)
+        {
+          XmlDocument document;
+          for (const FileData* item : list)
+          {
+            item->Metadata().Serialize(document, item->getPath(), root->getPath());
+            XmlNode node = document.first_child();
+            writer.Write(node);
+            document.remove_child(node);
+          }
+        };
+
+        Path xmlReadPath = getGamelistPath(*root, false);
+        Path xmlWritePath = getGamelistPath(*root, true);
+        Path journalPath = getGamelistJournalPath(*root);
 
         /*
-         * Custom thread-safe writer
+         * Few changes on an up-to-date gamelist: append them to the journal
          */
-        struct XmlWriter : public pugi::xml_writer
+        bool journalValid = !journalPath.Exists() ||
+                            (journalPath.Size() <= sJournalMaxSize && journalPath.LastModificationTime() >= xmlReadPath.LastModificationTime());
+        bool saved = false;
+        if (xmlReadPath == xmlWritePath && xmlReadPath.Exists() && journalValid && (int)dirtyList.size() <= sJournalMaxItems)
         {
-          std::string mOutput;
-          void write(const void* data, size_t size) override { mOutput.append((const char*)data, size); }
+          XmlStreamWriter writer(journalPath, std::string(), true);
+          write(writer, dirtyList);
+          saved = writer.Commit();
+          if (saved)
+          {
+            LOG(LogInfo) << "Journaled gamelist changes for system " << getFullName() << ". Updated items: " << dirtyList.size()
+                         << "/" << fileList.size();
+          }
+          else
+          {
+            LOG(LogWarning) << "Failed to append to " << journalPath.ToString();
+          }
         }
-        Writer;
 
         /*
-         * Write the list.
-         * At this point, we're sure at least one node has been updated (or added and updated).
+         * Rewrite the list. Zipped gamelists are written as xml first, then archived
          */
-        Path xmlWritePath(getGamelistPath(*root, true));
-        xmlWritePath.Directory().CreatePath();
-        document.save(Writer);
-
-        // Save
-        if (Strings::ToLowerASCII(xmlWritePath.Extension()) == ".zip")
+        if (!saved && !journalOnly)
         {
-          Zip zip(xmlWritePath, true);
-          Path xmlTruePath = xmlWritePath.ChangeExtension(".xml");
-          if (zip.Add(Writer.mOutput, xmlTruePath.Filename()))
+          bool zipped = Strings::ToLowerASCII(xmlWritePath.Extension()) == ".zip";
+          Path xmlTruePath = zipped ? xmlWritePath.ChangeExtension(".xml") : xmlWritePath;
+          XmlStreamWriter writer(xmlTruePath, "gameList", false);
+          write(writer, folderList);
+          write(writer, fileList);
+          saved = writer.Commit();
+          if (saved)
           {
-            xmlTruePath.Delete();
-            LOG(LogInfo) << "Saved gamelist.zip for system " << getFullName() << ". Updated items: " << fileList.size()
-                         << "/" << fileList.size();
+            if (zipped)
+            {
+              {
+                Zip zip(xmlWritePath, true);
+                saved = zip.Add(xmlTruePath, xmlTruePath.Directory());
+              }
+              if (saved) xmlTruePath.Delete();
+            }
+            else xmlWritePath.ChangeExtension(".zip").Delete();
           }
-          else LOG(LogError) << "Failed to save " << xmlWritePath.ToString();
-        }
-        else
-        {
-          if (Files::SaveFile(xmlWritePath, Writer.mOutput))
+
+          if (saved)
           {
-            xmlWritePath.ChangeExtension(".zip").Delete();
-            LOG(LogInfo) << "Saved gamelist.xml for system " << getFullName() << ". Updated items: " << fileList.size()
+            // The new gamelist contains all changes
+            journalPath.Delete();
+            LOG(LogInfo) << "Saved " << xmlWritePath.Filename() << " for system " << getFullName() << ". Updated items: " << dirtyList.size()
                          << "/" << fileList.size();
           }
           else LOG(LogError) << "Failed to save " << xmlWritePath.ToString();
         }
+
+        // Written changes are no more pending
+        if (saved)
+        {
+          for (FileData* item : dirtyList)
+            item->Metadata().SetClean();
+          PlayStatsJournal::Delete(*root);
+        }
       }
       catch (std::exception& e)
       {
@@ -664,6 +842,29 @@ void SystemData::UpdateGamelistXml()
       }
 }
 
+unsigned int SystemData::SnapshotConfiguration() const
+{
+  std::string key(mDescriptor.Extension());
+  key.append(RecalboxConf::Instance().AsBool("emulationstation.gamelistonly", false) ? "|gamelistonly" : "|scan")
+     .append(Settings::Instance().IgnoreGamelist() ? "|nogamelist" : "|gamelist");
+  return (unsigned int)Strings::ToHash(key);
+}
+
+void SystemData::UpdateSnapshots()
+{
+  unsigned int configuration = SnapshotConfiguration();
+  // Gamelists have just been written from the current trees, except for read-only roots
+  bool gamelistWritten = !Settings::Instance().IgnoreGamelist();
+
+  for(RootFolderData* root : mRootOfRoot.SubRoots())
+    if (!root->Virtual())
+    {
+      GamelistSnapshot snapshot(*root, configuration);
+      if (root->IsDirty() || !snapshot.IsUpToDate())
+        snapshot.Save(gamelistWritten && !root->ReadOnly());
+    }
+}
+
 bool SystemData::IsFavorite() const
 {
   return (mProperties & Properties::Favorite) != 0;
@@ -694,8 +895,9 @@ bool SystemData::IsSearchable() const
   return (mProperties & Properties::Searchable) != 0;
 }
 
-void SystemData::BuildDoppelgangerMap(FileData::StringMap& doppelganger, bool includefolder) const
+void SystemData::BuildDoppelgangerMap(PathIndex& doppelganger, bool includefolder) const
 {
+  BuildView();
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     root->BuildDoppelgangerMap(doppelganger, includefolder);
 }
@@ -705,19 +907,9 @@ void SystemData::UpdateLastPlayedGame(FileData& updated)
   // Update game
   updated.Metadata().SetLastplayedNow();
 
-  // Build the doppelganger map
-  FileData::StringMap map;
-  BuildDoppelgangerMap(map, false);
-  // If the game is already here, exit
-  if (map.contains(updated.getPath().ToString())) return;
-
-  // Prepare a one game map
-  map.clear();
-  map[updated.getPath().ToString()] = &updated;
-  // Add the virtual game
-  RootFolderData* root = GetRootFolder(RootFolderData::Types::Virtual);
-  if (root != nullptr)
-    LookupOrCreateGame(*root, updated.getTopAncestor().getPath(), updated.getPath(), ItemType::Game, map);
+  // Add the game, unless the view is not computed yet
+  if (mView != nullptr)
+    mView->Add(updated);
 }
 
 IBoardInterface::CPUGovernance SystemData::GetGovernance(const std::string& core)
@@ -744,11 +936,31 @@ RootFolderData* SystemData::GetRootFolder(RootFolderData::Types type)
 
 RootFolderData& SystemData::CreateRootFolder(const Path& startpath, RootFolderData::Ownership childownership, RootFolderData::Types type)
 {
-  RootFolderData* newRoot = new RootFolderData(mRootOfRoot, childownership, type, startpath, *this);
+  RootFolderData* newRoot = CreateDetachedRootFolder(startpath, childownership, type);
   mRootOfRoot.AddSubRoot(newRoot);
   return *newRoot;
 }
 
+RootFolderData* SystemData::CreateDetachedRootFolder(const Path& startpath, RootFolderData::Ownership childownership, RootFolderData::Types type)
+{
+  return new (mItemArena) RootFolderData(mRootOfRoot, childownership, type, startpath, *this);
+}
+
+ViewFolderData& SystemData::CreateViewRootFolder(const std::vector<SystemData*>& sources, const std::shared_ptr<IFilter>& filter,
+                                                 FileData::Comparer comparer, int limit)
+{
+  mView = new (mItemArena) ViewFolderData(mRootOfRoot, *this, sources, filter, comparer, limit, IsAlwaysFlat());
+  mRootOfRoot.AddSubRoot(mView);
+  return *mView;
+}
+
+void SystemData::AttachRootFolders(const std::vector<RootFolderData*>& roots)
+{
+  for(RootFolderData* root : roots)
+    mRootOfRoot.AddSubRoot(root);
+  mLoading = false;
+}
+
 RootFolderData& SystemData::LookupOrCreateRootFolder(const Path& startpath, RootFolderData::Ownership childownership,
                                                     RootFolderData::Types type)
 {
@@ -758,15 +970,17 @@ RootFolderData& SystemData::LookupOrCreateRootFolder(const Path& startpath, Root
   return CreateRootFolder(startpath, childownership, type);
 }
 
-FolderData& SystemData::GetFavoriteRoot()
+ViewFolderData& SystemData::GetFavoriteRoot()
 {
-  if (!IsFavorite())
+  if (!IsFavorite() || mView == nullptr)
     LOG(LogError) << "[System] Virtual Root requested on NON-FAVORITE SYSTEM!";
-  return LookupOrCreateRootFolder(Path(), RootFolderData::Ownership::None, RootFolderData::Types::Virtual);
+  return *mView;
 }
 
 bool SystemData::HasGame() const
 {
+  if (mLoading) return true;
+  if (mView != nullptr && !mView->IsBuilt()) return mView->HasGame(false);
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     if (root->hasGame())
       return true;
@@ -775,6 +989,8 @@ bool SystemData::HasGame() const
 
 int SystemData::GameCount() const
 {
+  if (mLoading) return mEstimatedCount;
+  BuildView();
   int result = 0;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     result += root->countAll(false, IncludeAdultGames());
@@ -783,6 +999,8 @@ int SystemData::GameCount() const
 
 int SystemData::GameAndFolderCount() const
 {
+  if (mLoading) return mEstimatedCount;
+  BuildView();
   int result = 0;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     result += root->countAll(true, IncludeAdultGames());
@@ -791,6 +1009,7 @@ int SystemData::GameAndFolderCount() const
 
 int SystemData::FavoritesCount() const
 {
+  BuildView();
   int result = 0;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     result += root->countAllFavorites(false, IncludeAdultGames());
@@ -799,6 +1018,7 @@ int SystemData::FavoritesCount() const
 
 int SystemData::HiddenCount() const
 {
+  BuildView();
   int result = 0;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     result += root->countAllHidden(false, IncludeAdultGames());
@@ -807,6 +1027,7 @@ int SystemData::HiddenCount() const
 
 FileData::List SystemData::getFavorites() const
 {
+  BuildView();
   FileData::Filter filter = FileData::Filter::Favorite;
   if (IncludeHiddenGames()) filter |= FileData::Filter::Hidden;
   bool adult = IncludeAdultGames();
@@ -819,6 +1040,7 @@ FileData::List SystemData::getFavorites() const
 
 FileData::List SystemData::getGames() const
 {
+  BuildView();
   FileData::Filter filter = FileData::Filter::Normal | FileData::Filter::Favorite;
   if (IncludeHiddenGames()) filter |= FileData::Filter::Hidden;
   bool adult = IncludeAdultGames();
@@ -831,6 +1053,7 @@ FileData::List SystemData::getGames() const
 
 FileData::List SystemData::getAllGames() const
 {
+  BuildView();
   FileData::List result;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     root->getItemsRecursivelyTo(result, FileData::Filter::All, false, true);
@@ -839,7 +1062,9 @@ FileData::List SystemData::getAllGames() const
 
 bool SystemData::HasVisibleGame() const
 {
+  if (mLoading) return true;
   bool displayHidden = Settings::Instance().ShowHidden();
+  if (mView != nullptr && !mView->IsBuilt()) return mView->HasGame(!displayHidden);
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     if (displayHidden) { if (root->hasGame()) return true; }
     else               { if (root->hasVisibleGame()) return true; }
@@ -849,6 +1074,9 @@ bool SystemData::HasVisibleGame() const
 
 void SystemData::FastSearch(FolderData::FastSearchContext context, const std::string& text, FolderData::ResultList& results, int& remaining)
 {
+  BuildView();
+  // Full scan until the index is ready
+  if (mSearchIndex.Search(context, text, results, remaining)) return;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     root->FastSearch(context, text, results, remaining);
 }
@@ -864,6 +1092,7 @@ Path::PathList SystemData::WritableGamelists()
 
 FileData::List SystemData::getFolders() const
 {
+  BuildView();
   FileData::List result;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     root->getFoldersRecursivelyTo(result);
@@ -872,6 +1101,7 @@ FileData::List SystemData::getFolders() const
 
 FileData::List SystemData::getTopGamesAndFolders() const
 {
+  BuildView();
   FileData::List result;
   for(const RootFolderData* root : mRootOfRoot.SubRoots())
     root->getItemsTo(result, FileData::Filter::All, true, IncludeAdultGames());
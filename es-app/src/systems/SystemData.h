@@ -4,6 +4,10 @@
 #include <utils/cplusplus/INoCopy.h>
 #include <RecalboxConf.h>
 #include "games/RootFolderData.h"
+#include "games/ViewFolderData.h"
+#include "games/GameIndex.h"
+#include "games/PathIndex.h"
+#include "games/SearchIndex.h"
 #include "WindowManager.h"
 #include "PlatformId.h"
 #include "themes/ThemeData.h"
@@ -43,6 +47,10 @@ class SystemData : private INoCopy
     static bool sIsGameRunning;
     //! Governance path
     static Path sGovernancePath;
+    //! Maximum modified items appended to a gamelist journal. Beyond, the gamelist is rewritten
+    static constexpr int sJournalMaxItems = 64;
+    //! Maximum gamelist journal size. Beyond, the gamelist is rewritten and the journal dropped
+    static constexpr long long sJournalMaxSize = 256 << 10; // 256Kb
 
     /*!
      * @brief Automatic Game running flag management
@@ -63,22 +71,45 @@ class SystemData : private INoCopy
     SystemDescriptor mDescriptor;
     //! Theme object
     ThemeData mTheme;
+    //! Storage of all items of this system. Declared before the root so that it outlives all items
+    Arena mItemArena;
+    //! Tree revision, bumped on any item addition or removal. Declared before the root so that it outlives all items
+    std::atomic<int> mTreeRevision;
+    //! Packed index of hot metadata, used by filters & counts. Declared before the root so that it outlives all items
+    GameIndex mGameIndex;
     //! Root folders - Children are top level visible game/folder of the system
     RootFolderData mRootOfRoot;
+    //! Trigram index of searchable texts. Declared after the root so that its builder stops before items are destroyed
+    SearchIndex mSearchIndex;
+    //! Content of view systems, or null for regular systems. Owned by the master root
+    ViewFolderData* mView;
     //! Sorting index
     int mSortId;
     //! Is this system the favorite system?
     Properties mProperties;
     //! Fixed sort
     FileSorts::Sorts mFixedSort;
+    //! Game tree is still loading in background
+    bool mLoading;
+    //! Estimated game count, used while loading
+    int mEstimatedCount;
 
     /*!
      * @brief Populate the system using all available folder/games by gathering recursively
      * all files mathing the extension list
      * @param folder Root folder to recurse in
      * @param doppelgangerWatcher full path map to avoid adding a game more than once
+     * @param scheduler Scheduler to scan sub-folders in parallel, or null to scan synchronously
      */
-    void populateFolder(RootFolderData& folder, FileData::StringMap& doppelgangerWatcher);
+    void populateFolder(RootFolderData& folder, PathIndex& doppelgangerWatcher, WorkStealingScheduler* scheduler);
+
+    /*!
+     * @brief Check that no rom folder of the given root has been modified since its last scan,
+     * using directory times stored in the scan manifest
+     * @param root Root folder
+     * @return True if populateFolder would build the same tree as the last time
+     */
+    bool IsScanUpToDate(const RootFolderData& root) const;
 
     /*!
      * @brief Private constructor, called from SystemManager
@@ -112,18 +143,46 @@ class SystemData : private INoCopy
      * @param root Game root path (usually system root path)
      * @param path Game path
      * @param type Type (folder/game)
-     * @param doppelgangerWatcher Maps to avoid duplicate entries
+     * @param doppelgangerWatcher Index to avoid duplicate entries
+     * @param source Virtual systems only: existing game to insert
      * @return Existing or newly created FileData
      */
-    FileData* LookupOrCreateGame(RootFolderData& topAncestor, const Path& rootPath, const Path& path, ItemType type, FileData::StringMap& doppelgangerWatcher) const;
+    FileData* LookupOrCreateGame(RootFolderData& topAncestor, const Path& rootPath, const Path& path, ItemType type, PathIndex& doppelgangerWatcher, FileData* source = nullptr) const;
 
     /*!
      * @brief Parse xml gamelist files and add games to the current system
      * @param root Root rom folder
      * @param doppelgangerWatcher Maps to avoid duplicate entries
      * @param forceCheckFile True to force to check if file exists
+     * @param scheduler Scheduler to deserialize metadata in parallel, or null to deserialize synchronously
+     * @param replace True to replace metadata of existing items, false to fill in fresh items
+     */
+    void ParseGamelistXml(RootFolderData& root, PathIndex& doppelgangerWatcher, bool forceCheckFile, WorkStealingScheduler* scheduler, bool replace);
+
+    /*!
+     * @brief Patch the live tree of the given root from its gamelist, modified by an external tool.
+     * Existing items are updated in place, new items are added. Nothing is destroyed
+     * @param root Root rom folder
+     */
+    void RefreshGamelist(RootFolderData& root);
+
+    /*!
+     * @brief Patch the live tree of the given root after an external modification of one of its folders.
+     * The deepest known folder containing the modified folder is scanned again and merged into the tree.
+     * Removed items are detached but not destroyed
+     * @param root Root rom folder
+     * @param folder Modified folder
+     * @param removed List to add detached items to
+     * @return True if the tree has been modified
      */
-    void ParseGamelistXml(RootFolderData& root, FileData::StringMap& doppelgangerWatcher, bool forceCheckFile);
+    bool RefreshRomFolder(RootFolderData& root, const Path& folder, FileData::List& removed);
+
+    /*!
+     * @brief Get the configuration key of gamelist snapshots.
+     * Any setting that changes the way the system tree is built must change the key.
+     * @return Configuration key
+     */
+    unsigned int SnapshotConfiguration() const;
 
     /*!
      * @brief Try to override command with the nearest one found in .system.cfg in folder or parent folders
@@ -155,6 +214,43 @@ class SystemData : private INoCopy
      */
     RootFolderData& CreateRootFolder(const Path& startpath, RootFolderData::Ownership childownership, RootFolderData::Types type);
 
+    /*!
+     * @brief Create new root folder, not attached to the system yet so that it can be populated out of the main thread
+     * @param startpath Path
+     * @param childownership Child ownership type
+     * @param type Type of root
+     * @return New root folder
+     */
+    RootFolderData* CreateDetachedRootFolder(const Path& startpath, RootFolderData::Ownership childownership, RootFolderData::Types type);
+
+    /*!
+     * @brief Turn this system into a view over games of the given systems
+     * @param sources Systems providing games
+     * @param filter Game filter
+     * @param comparer Comparer used to select games to keep when the limit is reached, or null
+     * @param limit Maximum game count, 0 = no limit
+     * @return View root folder
+     */
+    ViewFolderData& CreateViewRootFolder(const std::vector<SystemData*>& sources, const std::shared_ptr<IFilter>& filter,
+                                         FileData::Comparer comparer, int limit);
+
+    /*!
+     * @brief Compute the content of view systems on first use
+     */
+    void BuildView() const { if (mView != nullptr) mView->Build(); }
+
+    /*!
+     * @brief Attach populated root folders to the system. This ends the loading state
+     * @param roots Root folders created by CreateDetachedRootFolder
+     */
+    void AttachRootFolders(const std::vector<RootFolderData*>& roots);
+
+    /*!
+     * @brief Set the system in loading state until its root folders are attached
+     * @param estimatedCount Estimated game count, reported until the real tree is available
+     */
+    void SetLoading(int estimatedCount) { mLoading = true; mEstimatedCount = estimatedCount; }
+
     /*!
      * @brief Lookup an existig root folder or create a new one using the given configuration
      * @param startpath Path
@@ -184,12 +280,66 @@ class SystemData : private INoCopy
      * @brief Get master root
      * @return Master root
      */
-    RootFolderData& MasterRoot() { return mRootOfRoot; }
+    RootFolderData& MasterRoot() { BuildView(); return mRootOfRoot; }
     /*!
      * @brief Get master root - const version
      * @return Master root
      */
-    const RootFolderData& MasterRoot() const { return mRootOfRoot; }
+    const RootFolderData& MasterRoot() const { BuildView(); return mRootOfRoot; }
+
+    /*!
+     * @brief Get view content
+     * @return View root folder, or null if this system is not a view
+     */
+    ViewFolderData* View() const { return mView; }
+
+    /*!
+     * @brief Get the arena to allocate items of this system from
+     * @return Item arena
+     */
+    Arena& ItemArena() { return mItemArena; }
+
+    /*!
+     * @brief Get the packed hot metadata index of this system
+     * @return Game index
+     */
+    GameIndex& HotIndex() { return mGameIndex; }
+
+    /*!
+     * @brief Record an item addition or removal in the trees of this system
+     */
+    void TreeChanged()
+    {
+      mTreeRevision.fetch_add(1, std::memory_order_relaxed);
+      mGameIndex.Invalidate();
+    }
+
+    /*!
+     * @brief Get the tree revision of this system, bumped on any item addition or removal
+     * @return Tree revision
+     */
+    int TreeRevision() const { return mTreeRevision.load(std::memory_order_relaxed); }
+
+    /*!
+     * @brief Start building the text search index in background, if required
+     */
+    void PrepareFastSearch() { mSearchIndex.Prepare(); }
+
+    /*!
+     * @brief Add the heap memory used by the trees and the index of this system. Views are not computed
+     * @param usage Memory usage to update
+     */
+    void AddMemoryUsage(FileData::MemoryUsage& usage) const
+    {
+      mRootOfRoot.AddTreeMemoryUsage(usage);
+      usage.Indexes += mGameIndex.MemoryUsage();
+    }
+
+    /*!
+     * @brief Get the memory used by item nodes of this system
+     * @return Size in bytes
+     */
+    size_t NodeMemoryUsage() const { return mItemArena.AllocatedSize(); }
 
     const std::string& getName() const { return mDescriptor.Name(); }
     const std::string& getFullName() const { return mDescriptor.FullName(); }
@@ -211,6 +361,12 @@ class SystemData : private INoCopy
     inline const ThemeData& getTheme() const { return mTheme; }
 
     static Path getGamelistPath(const RootFolderData& root, bool forWrite);
+    /*!
+     * @brief Get the change journal of the given root's gamelist
+     * @param root Root folder
+     * @return Journal path
+     */
+    static Path getGamelistJournalPath(const RootFolderData& root) { return root.getPath() / "gamelist.journal"; }
     /*!
      * @brief Get list of writable Gamelists
      * @return List of writable gamelists
@@ -218,6 +374,13 @@ class SystemData : private INoCopy
     Path::PathList WritableGamelists();
     Path getThemePath() const;
 
+    /*!
+     * @brief Check if the game tree is still loading in background.
+     * Loading systems report an estimated game count and are considered not empty
+     * @return True if the system is loading
+     */
+    bool IsLoading() const { return mLoading; }
+
     bool HasGame() const;
     bool HasVisibleGame() const;
     int GameCount() const;
@@ -255,17 +418,24 @@ class SystemData : private INoCopy
     bool IsSearchable() const;
 
     /*!
-     * @brief Get or create pure virtual root - USE IT ONLY ON FAVORITE SYSTEM
-     * @return Virtual root
+     * @brief Get favorite view - USE IT ONLY ON FAVORITE SYSTEM
+     * @return View root
      */
-    FolderData& GetFavoriteRoot();
+    ViewFolderData& GetFavoriteRoot();
 
     FileSorts::Sorts FixedSort() const { return mFixedSort; }
 
     /*!
      * @brief Write modified games back to the gamelist xml file
+     * @param journalOnly True to only fold pending play statistics into gamelist journals,
+     * leaving gamelist files untouched. Roots requiring a full rewrite are left for later
+     */
+    void UpdateGamelistXml(bool journalOnly);
+
+    /*!
+     * @brief Write binary snapshots of modified or outdated roots, for fast loading at next startup
      */
-    void UpdateGamelistXml();
+    void UpdateSnapshots();
 
     /*!
      * @brief Update game list with a single game on top of the list
@@ -278,7 +448,7 @@ class SystemData : private INoCopy
      * @param doppelganger Map to fill in
      * @param includefolder Include folder or not
      */
-    void BuildDoppelgangerMap(FileData::StringMap& doppelganger, bool includefolder) const;
+    void BuildDoppelgangerMap(PathIndex& doppelganger, bool includefolder) const;
 
     /*!
      * @brief Get parent system manager
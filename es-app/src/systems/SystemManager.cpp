@@ -14,6 +14,10 @@
 #include <utils/Files.h>
 #include <algorithm>
 #include <utils/locale/LocaleHelper.h>
+#include <games/GamelistSnapshot.h>
+#include <games/PlayStatsJournal.h>
+#include "LazySystemLoader.h"
+#include "PlayStatsCompactor.h"
 
 
 SystemManager::RomSources SystemManager::GetRomSource(const SystemDescriptor& systemDescriptor, PortTypes port)
@@ -57,71 +61,289 @@ SystemManager::RomSources SystemManager::GetRomSource(const SystemDescriptor& sy
 
 SystemData* SystemManager::CreateRegularSystem(const SystemDescriptor& systemDescriptor, bool forceLoad)
 {
-  const Path defaultRomsPath = Path(Settings::Instance().DefaultRomsPath()).ToAbsolute();
-  Path realPath = defaultRomsPath.IsEmpty() ? systemDescriptor.RomPath() : systemDescriptor.RomPath().ToAbsolute(defaultRomsPath);
+  // Create system
+  SystemData* result = new SystemData(*this, systemDescriptor, SystemData::Properties::Searchable);
+
+  LOG(LogInfo) << "Creating & populating system: " << systemDescriptor.FullName();
+  result->AttachRootFolders(LoadRootFolders(*result, forceLoad, mLoadingScheduler));
+
+  result->loadTheme();
 
+  return result;
+}
+
+SystemData* SystemManager::CreateLazySystem(const SystemDescriptor& systemDescriptor, int estimatedCount)
+{
   // Create system
   SystemData* result = new SystemData(*this, systemDescriptor, SystemData::Properties::Searchable);
 
+  LOG(LogInfo) << "Creating system: " << systemDescriptor.FullName() << " (loaded later, about " << estimatedCount << " games)";
+  result->SetLoading(estimatedCount);
+
+  result->loadTheme();
+
+  return result;
+}
+
+bool SystemManager::MustLoadAtStartup(const SystemDescriptor& systemDescriptor)
+{
+  // Ports are merged into the Ports meta-system
+  if (systemDescriptor.PlatformCount() == 1)
+    if ((systemDescriptor.Platform(0) > PlatformIds::PlatformId::PORT_START) &&
+        (systemDescriptor.Platform(0) < PlatformIds::PlatformId::PORT_STOP))
+      return true;
+
+  // Arcade systems are merged into the Arcade meta-system
+  if (RecalboxConf::Instance().AsBool("emulationstation.arcade", false))
+  {
+    bool includeNeogeo = RecalboxConf::Instance().AsBool("emulationstation.arcade.includeneogeo", true);
+    if (systemDescriptor.HasPlatform(PlatformIds::PlatformId::ARCADE) ||
+        (systemDescriptor.HasPlatform(PlatformIds::PlatformId::NEOGEO) && includeNeogeo))
+      return true;
+  }
+
+  return false;
+}
+
+SystemManager::RootList SystemManager::LoadRootFolders(SystemData& system, bool forceLoad, WorkStealingScheduler* scheduler)
+{
+  const SystemDescriptor& systemDescriptor = system.mDescriptor;
+
   PortTypes port = PortTypes::None;
   if (systemDescriptor.IsPort())
     port = systemDescriptor.IsReadOnly() ? PortTypes::ShareInitOnly : PortTypes::ShareOnly;
 
   // Build root list
-  HashMap<std::string, bool> roots = GetRomSource(systemDescriptor, port);
+  HashMap<std::string, bool> sources = GetRomSource(systemDescriptor, port);
 
+  RootList roots;
   // Avoid files being added more than once even through symlinks
-  for(const auto& rootPath : roots)
+  for(const auto& rootPath : sources)
   {
-    RootFolderData& root = result->LookupOrCreateRootFolder(Path(rootPath.first),
-                                                            RootFolderData::Ownership::All,
-                                                            rootPath.second ? RootFolderData::Types::ReadOnly : RootFolderData::Types::None);
-    FileData::StringMap doppelgangerWatcher;
-
-    LOG(LogInfo) << "Creating & populating system: " << systemDescriptor.FullName();
+    // Sources of the same type share the same root
+    RootFolderData::Types type = rootPath.second ? RootFolderData::Types::ReadOnly : RootFolderData::Types::None;
+    RootFolderData* root = nullptr;
+    for(RootFolderData* existing : roots)
+      if (existing->Type() == type)
+      {
+        root = existing;
+        break;
+      }
+    if (root == nullptr)
+    {
+      root = system.CreateDetachedRootFolder(Path(rootPath.first), RootFolderData::Ownership::All, type);
+      roots.push_back(root);
+    }
+    PathIndex doppelgangerWatcher;
 
-    // Populate items from disk
+    // Try the binary snapshot first, unless a full reload is requested.
+    // Scanned trees are only taken from the snapshot if no rom sub-folder has changed since the last scan
     bool loadFromDisk = forceLoad || !RecalboxConf::Instance().AsBool("emulationstation.gamelistonly", false);
-    if (loadFromDisk)
-      result->populateFolder(root, doppelgangerWatcher);
+    GamelistSnapshot snapshot(*root, system.SnapshotConfiguration());
+    if (!forceLoad && (!loadFromDisk || system.IsScanUpToDate(*root)) && snapshot.Load())
+    {
+      LOG(LogInfo) << "  Loaded from snapshot: " << root->getPath().ToString();
+    }
+    else
+    {
+      // Populate items from disk
+      if (loadFromDisk)
+        system.populateFolder(*root, doppelgangerWatcher, scheduler);
 
-    // Populate items from gamelist.xml
+      // Populate items from gamelist.xml
+      if (!Settings::Instance().IgnoreGamelist())
+        system.ParseGamelistXml(*root, doppelgangerWatcher, forceLoad, scheduler, false);
+    }
+
+    // Replay play statistics not written in the gamelist yet
     if (!Settings::Instance().IgnoreGamelist())
-      result->ParseGamelistXml(root, doppelgangerWatcher, forceLoad);
+      PlayStatsJournal::Replay(*root);
 
     // Overrides?
-    FileData::List allFolders = result->getFolders();
+    FileData::List allFolders;
+    root->getFoldersRecursivelyTo(allFolders);
     for(auto* folder : allFolders)
       SystemData::overrideFolderInformation(folder);
   } // Let the doppelgangerWatcher to free its memory ASAP
 
-  result->loadTheme();
+  return roots;
+}
 
-  return result;
+void SystemManager::LazySystemLoaded(SystemData& system, const RootList& roots)
+{
+  Mutex::AutoLock locker(mTreeLocker);
+  system.AttachRootFolders(roots);
+  LOG(LogInfo) << "[LazyLoad] " << system.getFullName() << " loaded with " << system.GameCount() << " games";
+
+  std::vector<SystemData*> updated;
+  RefreshMetaSystems(system, updated);
+
+  // Collections have been kept while systems were loading: remove those that are still empty
+  bool loading = false;
+  for (const SystemData* other : mAllSystemVector)
+    loading |= other->IsLoading();
+  if (!loading) RemoveEmptyCollections();
+
+  // Add gamelist watching
+  if (mGamelistWatcher != nullptr)
+    for(const Path& path : system.WritableGamelists())
+      if (path.Exists())
+        mGamelistWatcher->WatchFile(path);
+  WatchRomFolders(system);
+
+  if (mLoadingInterface != nullptr)
+    mLoadingInterface->SystemLoaded(system, updated);
 }
 
-SystemData* SystemManager::CreateFavoriteSystem(const std::string& name, const std::string& fullName,
-                                                const std::string& themeFolder, const std::vector<SystemData*>& systems)
+void SystemManager::RemoveEmptyCollections()
 {
-  std::vector<PlatformIds::PlatformId> platformIds;
-  platformIds.push_back(PlatformIds::PlatformId::PLATFORM_IGNORE);
+  for (auto it = mManualCollections.begin(); it != mManualCollections.end(); )
+  {
+    SystemData* collection = *it;
+    if (collection->HasGame()) { ++it; continue; }
 
-  SystemDescriptor descriptor;
-  descriptor.SetInformation("", name, fullName, "", "", themeFolder, false);
-  SystemData* result = new SystemData(*this, descriptor, SystemData::Properties::Virtual | SystemData::Properties::AlwaysFlat | SystemData::Properties::Favorite);
+    LOG(LogInfo) << "[LazyLoad] Removing empty " << collection->getFullName() << " meta-system";
+    auto visible = std::find(mVisibleSystemVector.begin(), mVisibleSystemVector.end(), collection);
+    if (visible != mVisibleSystemVector.end()) mVisibleSystemVector.erase(visible);
+    it = mManualCollections.erase(it);
+  }
+}
+
+void SystemManager::WatchRomFolders(const SystemData& system)
+{
+  if (mRomWatcher == nullptr || system.IsVirtual()) return;
+  for (const RootFolderData* root : system.MasterRoot().SubRoots())
+    if (!root->Virtual())
+      mRomWatcher->Watch(*root);
+}
+
+void SystemManager::RefreshMetaSystems(SystemData& system, std::vector<SystemData*>& updated)
+{
+  // Favorites
+  SystemData* favorites = FavoriteSystem();
+  if (favorites != nullptr)
+    if (favorites->GetFavoriteRoot().Refresh(system))
+      updated.push_back(favorites);
+
+  // Manually filtered collections
+  for(SystemData* collection : mManualCollections)
+    if (collection->View()->Refresh(system))
+      updated.push_back(collection);
+}
+
+bool SystemManager::ReloadGamelist(const Path& gamelist)
+{
+  if (Settings::Instance().IgnoreGamelist()) return true;
+
+  // Lookup the root folder owning the gamelist. Systems still loading will read it anyway
+  for (SystemData* system : mAllSystemVector)
+    if (!system->IsVirtual() && !system->IsLoading())
+      for (RootFolderData* root : system->MasterRoot().SubRoots())
+        if (!root->Virtual() && root->getPath() == gamelist.Directory())
+        {
+          Mutex::AutoLock locker(mTreeLocker);
+          DateTime start;
+          system->RefreshGamelist(*root);
+          std::vector<SystemData*> updated;
+          RefreshMetaSystems(*system, updated);
+          DateTime stop;
+          LOG(LogInfo) << "[Gamelist] " << gamelist.ToString() << " reloaded in " << (stop-start).TotalMilliseconds() << "ms";
+
+          // External tools may have replaced the file
+          if (mGamelistWatcher != nullptr && gamelist.Exists())
+            mGamelistWatcher->WatchFile(gamelist);
+
+          if (mLoadingInterface != nullptr)
+            mLoadingInterface->SystemUpdated(*system, updated);
+          return true;
+        }
+
+  return false;
+}
 
-  FolderData& root = result->LookupOrCreateRootFolder(Path(), RootFolderData::Ownership::None, RootFolderData::Types::Virtual);
-  for (auto* system : systems)
+void SystemManager::RemoveFromVirtualSystems(const FileData::List& removed, std::vector<SystemData*>& updated)
+{
+  class Filter : public IFilter, private IVisitor
   {
-    FileData::List favs = system->getFavorites();
-    if (!favs.empty())
+    private:
+      HashMap<const FileData*, bool> mGames;
+      bool Visit(FileData& game) override { mGames[&game] = true; return true; }
+    public:
+      explicit Filter(const FileData::List& removed)
+      {
+        for (const FileData* item : removed)
+          if (item->isFolder()) ((const FolderData*)item)->visitGamesRecursively(*this, FileData::Filter::All, true);
+          else mGames[item] = true;
+      }
+      bool ApplyFilter(const FileData& file) const override { return mGames.contains(&file); }
+  }
+  removedGames(removed);
+
+  for (SystemData* system : mAllSystemVector)
+    if (system->IsVirtual())
     {
-      LOG(LogWarning) << " Get " << favs.size() << " favorites for " << system->getName() << "!";
-      for (auto* favorite : favs)
-        root.addChild(favorite, false);
+      // Views not computed yet do not need any update
+      bool changed = system->View() != nullptr ? system->View()->RemoveFiltered(removedGames)
+                                               : system->MasterRoot().removeFilteredGamesRecursively(&removedGames) != 0;
+      if (changed)
+        if (std::find(updated.begin(), updated.end(), system) == updated.end())
+          updated.push_back(system);
     }
+}
+
+void SystemManager::CheckRomFolders()
+{
+  Path::PathList folders;
+  if (mRomWatcher == nullptr || !mRomWatcher->GetModifiedFolders(folders)) return;
+
+  Mutex::AutoLock locker(mTreeLocker);
+  for (SystemData* system : mAllSystemVector)
+  {
+    if (system->IsVirtual() || system->IsLoading()) continue;
+
+    DateTime start;
+    bool changed = false;
+    FileData::List removed;
+    for (RootFolderData* root : system->MasterRoot().SubRoots())
+      if (!root->Virtual())
+        for (const Path& folder : folders)
+          if (folder.StartWidth(root->getPath()))
+            changed |= system->RefreshRomFolder(*root, folder, removed);
+    if (!changed) continue;
+
+    std::vector<SystemData*> updated;
+    RemoveFromVirtualSystems(removed, updated);
+    RefreshMetaSystems(*system, updated);
+    mDetachedItems.insert(mDetachedItems.end(), removed.begin(), removed.end());
+    DateTime stop;
+    LOG(LogInfo) << "[RomWatch] " << system->getFullName() << " updated in " << (stop-start).TotalMilliseconds() << "ms. "
+                 << removed.size() << " items removed";
+
+    if (mLoadingInterface != nullptr)
+      mLoadingInterface->SystemUpdated(*system, updated);
   }
+}
+
+void SystemManager::PrioritizeLoading(SystemData* system)
+{
+  if (mLazyLoader != nullptr && system->IsLoading())
+    mLazyLoader->Prioritize(system);
+}
+
+SystemData* SystemManager::CreateFavoriteSystem(const std::string& name, const std::string& fullName,
+                                                const std::string& themeFolder, const std::vector<SystemData*>& systems)
+{
+  class Filter : public IFilter
+  {
+    public:
+      bool ApplyFilter(const FileData& file) const override
+      {
+        return file.Metadata().Favorite() && (SystemData::IncludeHiddenGames() || !file.Metadata().Hidden());
+      }
+  };
 
+  SystemData* result = CreateViewSystem(name, fullName, themeFolder, systems, std::make_shared<Filter>(), nullptr, 0,
+                                        SystemData::Properties::AlwaysFlat | SystemData::Properties::Favorite);
   result->loadTheme();
 
   return result;
@@ -129,8 +351,7 @@ SystemData* SystemManager::CreateFavoriteSystem(const std::string& name, const s
 
 SystemData* SystemManager::CreateMetaSystem(const std::string& name, const std::string& fullName,
                                             const std::string& themeFolder, const std::vector<SystemData*>& systems,
-                                            SystemData::Properties properties, FileData::StringMap& doppelganger,
-                                            FileSorts::Sorts fixedSort)
+                                            SystemData::Properties properties, FileSorts::Sorts fixedSort)
 {
   std::vector<PlatformIds::PlatformId> platformIds;
   platformIds.push_back(PlatformIds::PlatformId::PLATFORM_IGNORE);
@@ -140,6 +361,7 @@ SystemData* SystemManager::CreateMetaSystem(const std::string& name, const std::
   SystemData* result = new SystemData(*this, descriptor, SystemData::Properties::Virtual | properties, fixedSort);
 
   RootFolderData& root = result->LookupOrCreateRootFolder(Path(), RootFolderData::Ownership::FolderOnly, RootFolderData::Types::Virtual);
+  PathIndex doppelganger;
   for(SystemData* source : systems)
   {
     FileData::List all = source->getTopGamesAndFolders();
@@ -147,7 +369,7 @@ SystemData* SystemManager::CreateMetaSystem(const std::string& name, const std::
     {
       LOG(LogWarning) << "Add games from " << source->getName() << " into " << fullName;
       for (auto* fd : all)
-        result->LookupOrCreateGame(root, fd->getTopAncestor().getPath(), fd->getPath(), fd->getType(), doppelganger);
+        result->LookupOrCreateGame(root, fd->getTopAncestor().getPath(), fd->getPath(), fd->getType(), doppelganger, fd);
     }
   }
 
@@ -156,27 +378,15 @@ SystemData* SystemManager::CreateMetaSystem(const std::string& name, const std::
   return result;
 }
 
-SystemData* SystemManager::CreateMetaSystem(const std::string& name, const std::string& fullName,
-                                            const std::string& themeFolder, const FileData::List& games,
-                                            SystemData::Properties properties, FileData::StringMap& doppelganger,
-                                            FileSorts::Sorts fixedSort)
+SystemData* SystemManager::CreateViewSystem(const std::string& name, const std::string& fullName,
+                                            const std::string& themeFolder, const std::vector<SystemData*>& sources,
+                                            const std::shared_ptr<IFilter>& filter, FileData::Comparer comparer, int limit,
+                                            SystemData::Properties properties, FileSorts::Sorts fixedSort)
 {
-  std::vector<PlatformIds::PlatformId> platformIds;
-  platformIds.push_back(PlatformIds::PlatformId::PLATFORM_IGNORE);
-
   SystemDescriptor descriptor;
   descriptor.SetInformation("", name, fullName, "", "", themeFolder, false);
   SystemData* result = new SystemData(*this, descriptor, SystemData::Properties::Virtual | properties, fixedSort);
-
-  if (!games.empty())
-  {
-    RootFolderData& root = result->CreateRootFolder(Path(), RootFolderData::Ownership::FolderOnly, RootFolderData::Types::Virtual);
-    LOG(LogWarning) << "Add " << games.size() << " games into " << fullName;
-    for (auto* fd : games)
-      result->LookupOrCreateGame(root, fd->getTopAncestor().getPath(), fd->getPath(), fd->getType(), doppelganger);
-  }
-
-  result->loadTheme();
+  result->CreateViewRootFolder(sources, filter, comparer, limit);
 
   return result;
 }
@@ -191,7 +401,9 @@ SystemData* SystemManager::ThreadPoolRunJob(SystemDescriptor& systemDescriptor)
 {
   try
   {
-    SystemData* newSys = CreateRegularSystem(systemDescriptor, mForceReload);
+    int* estimatedCount = mLazyWeights.try_get(systemDescriptor.Name());
+    SystemData* newSys = estimatedCount != nullptr ? CreateLazySystem(systemDescriptor, *estimatedCount)
+                                                   : CreateRegularSystem(systemDescriptor, mForceReload);
     if (newSys->GameCount() == 0)
     {
       LOG(LogWarning) << "System \"" << systemDescriptor.Name() << "\" has no games! Ignoring it.";
@@ -234,7 +446,6 @@ bool SystemManager::AddArcadeMetaSystem()
   {
     std::vector<SystemData*> arcades;
     bool includeNeogeo = RecalboxConf::Instance().AsBool("emulationstation.arcade.includeneogeo", true);
-    FileData::StringMap doppelganger;
 
     // Lookup all non-empty arcade platforms
     for (SystemData* system: mVisibleSystemVector)
@@ -244,7 +455,6 @@ bool SystemManager::AddArcadeMetaSystem()
               (system->PlatformIds(i) == PlatformIds::PlatformId::NEOGEO && includeNeogeo))
           {
             arcades.push_back(system);
-            system->BuildDoppelgangerMap(doppelganger, false);
             break;
           }
 
@@ -265,7 +475,7 @@ bool SystemManager::AddArcadeMetaSystem()
       // Create meta-system
       SystemData::Properties properties = SystemData::Properties::Virtual;
       if (hideOriginals) properties |= SystemData::Properties::Searchable;
-      SystemData* arcade = CreateMetaSystem("arcade", "Arcade", "arcade", arcades, properties, doppelganger);
+      SystemData* arcade = CreateMetaSystem("arcade", "Arcade", "arcade", arcades, properties);
       LOG(LogInfo) << "creating Arcade meta-system";
       int position = RecalboxConf::Instance().AsInt("emulationstation.arcade.position", 0) % (int)mVisibleSystemVector.size();
       auto it = position >= 0 ? mVisibleSystemVector.begin() + position : mVisibleSystemVector.end() + (position + 1);
@@ -280,7 +490,6 @@ bool SystemManager::AddArcadeMetaSystem()
 bool SystemManager::AddPorts()
 {
   std::vector<SystemData*> ports;
-  FileData::StringMap doppelganger;
 
   // Lookup all non-empty arcade platforms
   for (SystemData* system: mVisibleSystemVector)
@@ -288,10 +497,7 @@ bool SystemManager::AddPorts()
       if ((system->PlatformIds(0) > PlatformIds::PlatformId::PORT_START) &&
           (system->PlatformIds(0) < PlatformIds::PlatformId::PORT_STOP))
         if (system->HasGame())
-        {
           ports.push_back(system);
-          system->BuildDoppelgangerMap(doppelganger, false);
-        }
 
   // Non empty?
   if (!ports.empty())
@@ -306,7 +512,7 @@ bool SystemManager::AddPorts()
     }
 
     // Create meta-system
-    SystemData* portSystem = CreateMetaSystem("ports", "Ports", "ports", ports, SystemData::Properties::Virtual | SystemData::Properties::Searchable, doppelganger);
+    SystemData* portSystem = CreateMetaSystem("ports", "Ports", "ports", ports, SystemData::Properties::Virtual | SystemData::Properties::Searchable);
     LOG(LogInfo) << "creating Ports";
     // Seek defaulot position
     int position = 0;
@@ -319,7 +525,7 @@ bool SystemManager::AddPorts()
   return !ports.empty();
 }
 
-bool SystemManager::AddManuallyFilteredMetasystem(IFilter* filter, FileData::Comparer comparer, const std::string& identifier, const std::string& fullname, SystemData::Properties properties, FileSorts::Sorts fixedSort)
+bool SystemManager::AddManuallyFilteredMetasystem(const std::shared_ptr<IFilter>& filter, FileData::Comparer comparer, const std::string& identifier, const std::string& fullname, SystemData::Properties properties, FileSorts::Sorts fixedSort)
 {
   std::string confPrefix("emulationstation.collection.");
   confPrefix += identifier;
@@ -329,47 +535,31 @@ bool SystemManager::AddManuallyFilteredMetasystem(IFilter* filter, FileData::Com
   {
     // Get theme name
     std::string theme = RecalboxConf::Instance().AsString(confPrefix + ".theme", "auto-" + identifier);
-    FileData::List allGames;
-    FileData::StringMap doppelganger;
+    int limit = RecalboxConf::Instance().AsInt(confPrefix + ".limit", 0);
 
-    // Filter and insert items
-    for(const SystemData* system : mVisibleSystemVector)
+    // Games are taken from regular systems, once the collection is displayed
+    std::vector<SystemData*> sources;
+    for(SystemData* system : mVisibleSystemVector)
       if (!system->IsVirtual())
-        for(const RootFolderData* root : system->MasterRoot().SubRoots())
-          if (!root->Virtual())
-          {
-            FileData::List list = root->getFilteredItemsRecursively(filter, true, system->IncludeAdultGames());
-            allGames.reserve(allGames.size() + list.size());
-            allGames.insert(allGames.end(), list.begin(), list.end());
-            // dopplegagner must be build using file only
-            // Let the virtual system re-create all intermediate folder
-            // ... and destroy them properly
-            system->BuildDoppelgangerMap(doppelganger, false);
-          }
+        sources.push_back(system);
+    SystemData* allsystem = CreateViewSystem(identifier, _S(fullname), theme, sources, filter, comparer, limit, properties, fixedSort);
 
-    // Not empty?
-    if (!allGames.empty())
+    // Not empty? Systems loaded in background may fill empty collections later
+    if (allsystem->HasGame() || !mLazyWeights.empty())
     {
-      // Sort if required
-      if (comparer != nullptr)
-        FolderData::Sort(allGames, comparer, true);
-      // Limit if required
-      int limit = RecalboxConf::Instance().AsInt(confPrefix + ".limit", 0);
-      if (limit > 0)
-        if (limit < (int)allGames.size())
-          allGames.resize(limit);
-
       // Create!
       LOG(LogInfo) << "creating " << fullname << " meta-system";
-      SystemData* allsystem = CreateMetaSystem(identifier, _S(fullname), theme, allGames, properties, doppelganger, fixedSort);
+      allsystem->loadTheme();
 
       // And add the system
       int position = RecalboxConf::Instance().AsInt(confPrefix + ".position", 0) % (int) mVisibleSystemVector.size();
       auto it = position >= 0 ? mVisibleSystemVector.begin() + position : mVisibleSystemVector.end() + (position + 1);
       mVisibleSystemVector.insert(it, allsystem);
+      mManualCollections.push_back(allsystem);
 
       return true;
     }
+    delete allsystem;
   }
   return false;
 }
@@ -380,8 +570,9 @@ bool SystemManager::AddAllGamesMetaSystem()
   {
     public:
       bool ApplyFilter(const FileData&) const override { return true; }
-  } filter;
-  return AddManuallyFilteredMetasystem(&filter, nullptr, sAllGamesSystemShortName, sAllGamesSystemFullName,
+      bool ApplyIndexFilter(const GameIndex&, int) const override { return true; }
+  };
+  return AddManuallyFilteredMetasystem(std::make_shared<Filter>(), nullptr, sAllGamesSystemShortName, sAllGamesSystemFullName,
                                        SystemData::Properties::None);
 }
 
@@ -391,8 +582,14 @@ bool SystemManager::AddMultiplayerMetaSystems()
   {
     public:
       bool ApplyFilter(const FileData& file) const override { return file.Metadata().PlayerMin() > 1 || file.Metadata().PlayerMax() > 1; }
-  } filter;
-  return AddManuallyFilteredMetasystem(&filter, nullptr, sMultiplayerSystemShortName, sMultiplayerSystemFullName,
+      bool ApplyIndexFilter(const GameIndex& index, int slot) const override
+      {
+        // Same packing as MetadataDescriptor::PlayerRange: max in the high word, min in the low word
+        int range = index.Players()[slot];
+        return (range & 0xFFFF) > 1 || (range >> 16) > 1;
+      }
+  };
+  return AddManuallyFilteredMetasystem(std::make_shared<Filter>(), nullptr, sMultiplayerSystemShortName, sMultiplayerSystemFullName,
                                        SystemData::Properties::None);
 }
 
@@ -402,8 +599,9 @@ bool SystemManager::AddLastPlayedMetaSystem()
   {
     public:
       bool ApplyFilter(const FileData& file) const override { return file.Metadata().LastPlayedEpoc() != 0; }
-  } filter;
-  return AddManuallyFilteredMetasystem(&filter, nullptr, sLastPlayedSystemShortName, sLastPlayedSystemFullName,
+      bool ApplyIndexFilter(const GameIndex& index, int slot) const override { return index.LastPlayed()[slot] != 0; }
+  };
+  return AddManuallyFilteredMetasystem(std::make_shared<Filter>(), nullptr, sLastPlayedSystemShortName, sLastPlayedSystemFullName,
                                        SystemData::Properties::FixedSort | SystemData::Properties::AlwaysFlat, FileSorts::Sorts::LastPlayedDescending);
 }
 
@@ -418,12 +616,12 @@ bool SystemManager::AddGenresMetaSystem()
     public:
       explicit Filter(GameGenres genre) : mGenre(genre) {}
       bool ApplyFilter(const FileData& file) const override { return file.Metadata().GenreId() == mGenre; }
+      bool ApplyIndexFilter(const GameIndex& index, int slot) const override { return index.GenreIds()[slot] == (unsigned short)mGenre; }
   };
 
   for(const auto& genre : genres)
   {
-    Filter filter(genre.first);
-    AddManuallyFilteredMetasystem(&filter, nullptr, genre.second, Genres::GetName(genre.first),
+    AddManuallyFilteredMetasystem(std::make_shared<Filter>(genre.first), nullptr, genre.second, Genres::GetName(genre.first),
                                   SystemData::Properties::None);
   }
   return true;
@@ -444,6 +642,13 @@ bool SystemManager::AddSpecialCollectionsMetaSystems()
 bool SystemManager::LoadSystemConfigurations(FileNotifier& gamelistWatcher, bool forceReloadFromDisk)
 {
   mForceReload = forceReloadFromDisk;
+  mGamelistWatcher = &gamelistWatcher;
+  // Rom folders may be modified over the network while running
+  if (RecalboxConf::Instance().AsBool("emulationstation.romwatch", false))
+    mRomWatcher = new RomFolderWatcher(RecalboxConf::Instance().AsInt("emulationstation.romwatch.maxwatches", 8192),
+                                       RecalboxConf::Instance().AsInt("emulationstation.romwatch.delay", 2000));
+  // Systems not shown at startup may be loaded in background, except when a full reload is requested
+  bool lazyLoading = !forceReloadFromDisk && RecalboxConf::Instance().AsBool("emulationstation.lazyloading", false);
 
   SystemDeserializer deserializer;
   bool loaded = deserializer.LoadSystems();
@@ -473,6 +678,9 @@ bool SystemManager::LoadSystemConfigurations(FileNotifier& gamelistWatcher, bool
       {
         // Get weight
         int weight = weights.GetInt(descriptor.FullName(), 0);
+        // Known non-empty system? Load it later
+        if (lazyLoading && weight > 0 && !MustLoadAtStartup(descriptor))
+          mLazyWeights[descriptor.Name()] = weight;
         // Add system name and watch gamelist
         mAllDeclaredSystemShortNames.push_back(descriptor.Name());
         // Push weighted system
@@ -485,7 +693,13 @@ bool SystemManager::LoadSystemConfigurations(FileNotifier& gamelistWatcher, bool
   int count = threadPool.PendingJobs();
   if (mProgressInterface != nullptr)
     mProgressInterface->SetMaximum(count);
-  threadPool.Run(-2, false);
+  {
+    // Let idle cores help with the largest systems once smaller ones are loaded
+    WorkStealingScheduler scheduler("System-Scan", 0);
+    mLoadingScheduler = &scheduler;
+    threadPool.Run(-2, false);
+    mLoadingScheduler = nullptr;
+  }
   // Push result
   LOG(LogInfo) << "Store visible systems";
   mVisibleSystemVector.resize(count, nullptr);
@@ -518,11 +732,25 @@ bool SystemManager::LoadSystemConfigurations(FileNotifier& gamelistWatcher, bool
   for(SystemData* service : mVisibleSystemVector) mAllSystemVector.push_back(service);
   for(SystemData* service : mHiddenSystemVector) mAllSystemVector.push_back(service);
 
-  // Add gamelist watching
+  // Add gamelist & rom folder watching
   for(SystemData* system : mAllSystemVector)
+  {
     for(const Path& path : system->WritableGamelists())
       if (path.Exists())
         gamelistWatcher.WatchFile(path);
+    if (!system->IsLoading())
+      WatchRomFolders(*system);
+  }
+
+  // Load remaining systems in background, in display order
+  if (!mLazyWeights.empty())
+  {
+    mLazyLoader = new LazySystemLoader(*this);
+    for(SystemData* system : mVisibleSystemVector)
+      if (system->IsLoading())
+        mLazyLoader->Push(system);
+    mLazyLoader->StartLoading();
+  }
 
   return true;
 }
@@ -577,7 +805,11 @@ bool SystemManager::ThreadPoolRunJob(SystemData*& feed)
   // Save changed game data back to xml
   if (!Settings::Instance().IgnoreGamelist())
     if (!feed->IsVirtual())
-      feed->UpdateGamelistXml();
+      feed->UpdateGamelistXml(false);
+
+  // Then refresh snapshots from the saved trees
+  if (!feed->IsVirtual())
+    feed->UpdateSnapshots();
 
   return true;
 }
@@ -602,13 +834,51 @@ void SystemManager::UpdateAllSystems()
   LOG(LogInfo) << "Gamelist update time: " << std::to_string((stop-start).TotalMilliseconds()) << "ms";
 }
 
+void SystemManager::StartPlayStatsCompaction()
+{
+  if (Settings::Instance().IgnoreGamelist()) return;
+
+  if (mCompactor == nullptr)
+    mCompactor = new PlayStatsCompactor(*this);
+  mCompactor->Start();
+}
+
+void SystemManager::CancelPlayStatsCompaction()
+{
+  if (mCompactor != nullptr)
+    mCompactor->Cancel();
+}
+
+bool SystemManager::IsCompactingPlayStats() const
+{
+  return mCompactor != nullptr && mCompactor->Compacting();
+}
+
 void SystemManager::DeleteAllSystems(bool updateGamelists)
 {
+  // Stop background loading & writing first
+  delete mLazyLoader;
+  mLazyLoader = nullptr;
+  delete mCompactor;
+  mCompactor = nullptr;
+  mLazyWeights.clear();
+  mManualCollections.clear();
+
   if (updateGamelists && !mAllSystemVector.empty())
     UpdateAllSystems();
 
+  // Detached items & virtual systems reference games of regular systems: destroy them first
+  for(FileData* item : mDetachedItems)
+    delete item;
+  mDetachedItems.clear();
+  for(SystemData* system : mAllSystemVector)
+    if (system->IsVirtual())
+      delete system;
   for(SystemData* system : mAllSystemVector)
-    delete system;
+    if (!system->IsVirtual())
+      delete system;
+  delete mRomWatcher;
+  mRomWatcher = nullptr;
 
   mVisibleSystemVector.clear();
   mAllSystemVector.clear();
@@ -680,19 +950,29 @@ void SystemManager::SearchResultQuickSortAscending(FolderData::ResultList& items
   if (Low < high) SearchResultQuickSortAscending(items, Low, high);
 }
 
+SystemManager::SystemList SystemManager::GetSearchableSystemList() const
+{
+  SystemList systems;
+  for(auto *system : mVisibleSystemVector)
+    if (system->IsSearchable())
+      systems.push_back(system);
+  return systems;
+}
+
 FileData::List SystemManager::searchTextInGames(FolderData::FastSearchContext context, const std::string& originaltext, int maxpersystem, int maxglobal)
 {
-  std::string lowercaseText = Strings::ToLowerUTF8(originaltext);
+  std::string searchKey = Strings::ToSearchKey(originaltext);
 
-  // Get search results
+  // Get search results. Search indexes are shared with the background searcher, one system at a time
   FolderData::ResultList searchResults;
   searchResults.reserve(5000);
   for(auto *system : mVisibleSystemVector)
     if (system->IsSearchable())
     {
+      Mutex::AutoLock locker(mTreeLocker);
       int maximumResultPerSystem = maxpersystem;
 
-      system->FastSearch(context, lowercaseText, searchResults, maximumResultPerSystem);
+      system->FastSearch(context, searchKey, searchResults, maximumResultPerSystem);
     }
 
   // Sort results
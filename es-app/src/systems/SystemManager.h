@@ -7,8 +7,15 @@
 #include <RootFolders.h>
 #include <utils/cplusplus/INoCopy.h>
 #include <views/IProgressInterface.h>
+#include <views/ISystemLoadingInterface.h>
 #include <utils/os/fs/watching/FileNotifier.h>
 #include <utils/os/system/Mutex.h>
+#include <utils/os/system/WorkStealingScheduler.h>
+#include "RomFolderWatcher.h"
+#include <memory>
+
+class LazySystemLoader;
+class PlayStatsCompactor;
 
 class SystemManager :
   private INoCopy, // No copy allowed
@@ -35,9 +42,15 @@ class SystemManager :
     static constexpr const char* sAllGamesSystemFullName = "All Games";
 
   private:
+    // Allow the lazy loader to build & hand back system trees
+    friend class LazySystemLoader;
+
     //! Rom source folder to read/write (false) / read-only (true) state
     typedef HashMap<std::string, bool> RomSources;
 
+    //! Root folder list
+    typedef std::vector<RootFolderData*> RootList;
+
     //! File path to system weight file for fast loading/saving
     static constexpr const char* sWeightFilePath = "/recalbox/share/system/.emulationstation/.weights";
 
@@ -80,6 +93,28 @@ class SystemManager :
     //! The system manager is instructed to reload game list from disk, not only from gamelist.xml
     bool mForceReload;
 
+    //! Scheduler shared by all systems to split large folder scans & gamelist parsing. Only available while loading
+    WorkStealingScheduler* mLoadingScheduler;
+
+    //! Estimated game count of systems to load in background, by system short name
+    HashMap<std::string, int> mLazyWeights;
+    //! Background loader of systems not required at startup
+    LazySystemLoader* mLazyLoader;
+    //! Background writer of play statistics, or null if not started yet
+    PlayStatsCompactor* mCompactor;
+    //! Game tree protection, held by the main thread while adding or removing items and by background readers
+    Mutex mTreeLocker;
+    //! Interface notified when a background loaded system is complete
+    ISystemLoadingInterface* mLoadingInterface;
+    //! Manually filtered collections, kept to receive games from systems loaded later
+    std::vector<SystemData*> mManualCollections;
+    //! Gamelist watcher, to watch gamelists of systems loaded in background
+    FileNotifier* mGamelistWatcher;
+    //! Rom folder watcher, or null if rom folders are not watched
+    RomFolderWatcher* mRomWatcher;
+    //! Items removed from the disk while running. They may still be referenced by views, so they live until systems are deleted
+    FileData::List mDetachedItems;
+
     /*!
      * @brief Create and add the favorite meta-system
      * @param systemList All system from which to fetch favorite games
@@ -108,7 +143,7 @@ class SystemManager :
      * @param fullname System full name
      * @return True if the system has been added
      */
-    bool AddManuallyFilteredMetasystem(IFilter* filter, FileData::Comparer comparer, const std::string& identifier,
+    bool AddManuallyFilteredMetasystem(const std::shared_ptr<IFilter>& filter, FileData::Comparer comparer, const std::string& identifier,
                                        const std::string& fullname, SystemData::Properties properties,
                                        FileSorts::Sorts fixedSort = FileSorts::Sorts::FileNameAscending);
 
@@ -157,6 +192,66 @@ class SystemManager :
      */
     SystemData* CreateRegularSystem(const SystemDescriptor& systemDescriptor, bool forceLoad);
 
+    /*!
+     * @brief Create regular system in loading state. Its game tree is built later in background
+     * @param systemDescriptor SystemDescriptor object
+     * @param estimatedCount Game count from the last run
+     * @return New system
+     */
+    SystemData* CreateLazySystem(const SystemDescriptor& systemDescriptor, int estimatedCount);
+
+    /*!
+     * @brief Check if a system must be loaded at startup, whatever the lazy loading configuration.
+     * Ports and arcade systems are merged into meta-systems that need their games
+     * @param systemDescriptor SystemDescriptor object
+     * @return True if the system must be loaded at startup
+     */
+    static bool MustLoadAtStartup(const SystemDescriptor& systemDescriptor);
+
+    /*!
+     * @brief Build all root folders of a system, from snapshots, disks and gamelists.
+     * Root folders are not attached to the system, so that this method may run in any thread
+     * @param system System to build root folders for
+     * @param forceLoad Force reloading list from disk and not only from gamelist.xml
+     * @param scheduler Scheduler to split large folder scans & gamelist parsing, or null
+     * @return Detached root folders
+     */
+    RootList LoadRootFolders(SystemData& system, bool forceLoad, WorkStealingScheduler* scheduler);
+
+    /*!
+     * @brief Attach root folders loaded in background to their system, then update meta-systems.
+     * Must be called from the main thread
+     * @param system Loaded system
+     * @param roots Detached root folders
+     */
+    void LazySystemLoaded(SystemData& system, const RootList& roots);
+
+    /*!
+     * @brief Synchronize favorites & manually filtered collections with the current games of the given system
+     * @param system Source system
+     * @param updated Meta-systems whose game list has changed
+     */
+    void RefreshMetaSystems(SystemData& system, std::vector<SystemData*>& updated);
+
+    /*!
+     * @brief Remove collections still empty once all systems are loaded from the visible system list.
+     * They are destroyed along with other systems
+     */
+    void RemoveEmptyCollections();
+
+    /*!
+     * @brief Watch the rom folders of the given system, if rom folders are watched
+     * @param system Loaded system
+     */
+    void WatchRomFolders(const SystemData& system);
+
+    /*!
+     * @brief Remove the given detached items, including games of detached folders, from all virtual systems
+     * @param removed Detached items
+     * @param updated Virtual systems whose game list has changed
+     */
+    void RemoveFromVirtualSystems(const FileData::List& removed, std::vector<SystemData*>& updated);
+
     /*!
      * @brief Create Favorite system using favorites available in systems from a list
      * @param name Target system short name
@@ -175,27 +270,30 @@ class SystemManager :
      * @param themeFolder Theme folder name
      * @param systems System to fetch games to aggregate into a single list
      * @param properties System properties
-     * @param doppelganger Map to FileData
      * @return New meta-system
      */
     SystemData* CreateMetaSystem(const std::string& name, const std::string& fullName,
                                  const std::string& themeFolder, const std::vector<SystemData*>& systems,
-                                 SystemData::Properties properties, FileData::StringMap& doppelganger,
+                                 SystemData::Properties properties,
                                  FileSorts::Sorts fixedSort = FileSorts::Sorts::FileNameAscending);
 
     /*!
-     * @brief Create meta-system aggregating games from multiple systems
+     * @brief Create view system over games of other systems. Its content is computed on first use.
+     * The theme is not loaded, so that empty views can be dropped cheaply
      * @param name Target system short name
      * @param fullName Target system fullname
      * @param themeFolder Theme folder name
-     * @param games Games to add
+     * @param sources Systems to fetch games from
+     * @param filter Game filter
+     * @param comparer Comparer used to select games to keep when the limit is reached, or null
+     * @param limit Maximum game count, 0 = no limit
      * @param properties System properties
-     * @param doppelganger Map to FileData
-     * @return New meta-system
+     * @return New view system
      */
-    SystemData* CreateMetaSystem(const std::string& name, const std::string& fullName,
-                                 const std::string& themeFolder, const FileData::List& games,
-                                 SystemData::Properties properties, FileData::StringMap& doppelganger,
+    SystemData* CreateViewSystem(const std::string& name, const std::string& fullName,
+                                 const std::string& themeFolder, const std::vector<SystemData*>& sources,
+                                 const std::shared_ptr<IFilter>& filter, FileData::Comparer comparer, int limit,
+                                 SystemData::Properties properties,
                                  FileSorts::Sorts fixedSort = FileSorts::Sorts::FileNameAscending);
 
     /*!
@@ -230,7 +328,13 @@ class SystemManager :
      */
     SystemManager()
      : mProgressInterface(nullptr),
-       mForceReload(false)
+       mForceReload(false),
+       mLoadingScheduler(nullptr),
+       mLazyLoader(nullptr),
+       mCompactor(nullptr),
+       mLoadingInterface(nullptr),
+       mGamelistWatcher(nullptr),
+       mRomWatcher(nullptr)
     {
     }
 
@@ -240,6 +344,31 @@ class SystemManager :
      */
     void SetProgressInterface(IProgressInterface* interface) { mProgressInterface = interface; }
 
+    /*!
+     * @brief Set the interface notified when a system loaded in background is complete
+     * @param interface
+     */
+    void SetLoadingInterface(ISystemLoadingInterface* interface) { mLoadingInterface = interface; }
+
+    /*!
+     * @brief Load the given system as soon as possible, if it is still loading in background
+     * @param system System the user wants to browse
+     */
+    void PrioritizeLoading(SystemData* system);
+
+    /*!
+     * @brief Reload a gamelist modified by an external tool, and update views & meta-systems accordingly
+     * @param gamelist Gamelist path
+     * @return True if the gamelist has been reloaded, false if it does not belong to any loaded system
+     */
+    bool ReloadGamelist(const Path& gamelist);
+
+    /*!
+     * @brief Apply rom folder modifications to game trees, once the filesystem has been quiet for a while.
+     * Views & meta-systems are updated accordingly. Must be called from the main thread
+     */
+    void CheckRomFolders();
+
     /*!
      * @brief Get favorite system
      * @return Favorite system of nullptr if there is no favorite system
@@ -271,6 +400,29 @@ class SystemManager :
      */
     void UpdateAllSystems();
 
+    /*!
+     * @brief Start folding pending play statistics into gamelist journals in background, while the user is idle
+     */
+    void StartPlayStatsCompaction();
+
+    /*!
+     * @brief Stop folding play statistics, once the system being written is complete
+     */
+    void CancelPlayStatsCompaction();
+
+    /*!
+     * @brief Check if play statistics are being folded in background
+     * @return True if the compaction is still in progress
+     */
+    bool IsCompactingPlayStats() const;
+
+    /*!
+     * @brief Get the game tree lock. Background readers of game trees must hold it,
+     * as the main thread does while adding or removing items
+     * @return Tree lock
+     */
+    Mutex& TreeLocker() { return mTreeLocker; }
+
     /*!
      * @brief Delete all systems and all sub-objects
      * @param updateGamelists
@@ -370,5 +522,11 @@ class SystemManager :
      * @return Sorted game found list
      */
     FileData::List searchTextInGames(FolderData::FastSearchContext context, const std::string& text, int maxpersystem, int maxglobal);
+
+    /*!
+     * @brief Get visible systems games can be searched in
+     * @return Searchable system list
+     */
+    SystemList GetSearchableSystemList() const;
 };
 
@@ -278,7 +278,7 @@ void NotificationManager::Notify(const SystemData* system, const FileData* game,
   if (VideoEngine::IsInstantiated())
     VideoEngine::Instance().StopVideo();
 
-  const std::string& notificationParameter = (game != nullptr) ? game->getPath().ToString() :
+  std::string notificationParameter = (game != nullptr) ? game->getPath().ToString() :
                                              ((system != nullptr) ? system->getName() : actionParameters);
 
   // Check if it is the same event than in previous call
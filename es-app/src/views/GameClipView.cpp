@@ -11,6 +11,7 @@
 #include <audio/AudioManager.h>
 #include "utils/locale/LocaleHelper.h"
 #include <usernotifications/NotificationManager.h>
+#include <games/PlayStatsJournal.h>
 
 GameClipView::GameClipView(WindowManager& window, SystemManager& systemManager)
   : Gui(window), mWindow(window), mSystemManager(systemManager), mRecalboxConf(RecalboxConf::Instance()),
@@ -70,13 +71,17 @@ void GameClipView::init()
     }
 
   // Filter and insert items
-  for (const SystemData* system : demoSystems)
+  class Collector : public IVisitor
   {
-    FileData::List list = system->MasterRoot().getFilteredItemsRecursively(&videoFilter, false,
-                                                                           system->IncludeAdultGames());
-    mDemoFiles.reserve(mDemoFiles.size() + list.size());
-    mDemoFiles.insert(mDemoFiles.end(), list.begin(), list.end());
+    private:
+      std::vector<FileData*>& mFiles;
+    public:
+      explicit Collector(std::vector<FileData*>& files) : mFiles(files) {}
+      bool Visit(FileData& file) override { mFiles.push_back(&file); return true; }
   }
+  collector(mDemoFiles);
+  for (const SystemData* system : demoSystems)
+    system->MasterRoot().visitGamesRecursively(collector, &videoFilter, system->IncludeAdultGames());
 
   checkEmptyDemoFiles();
 
@@ -304,17 +309,18 @@ bool GameClipView::ProcessInput(const InputCompactEvent& event)
     {
       MetadataDescriptor& md = mGame->Metadata();
       SystemData* favoriteSystem = mSystemManager.FavoriteSystem();
-      md.SetFavorite(!md.Favorite());
+      mGame->SetFavorite(!md.Favorite());
+      PlayStatsJournal::Append(*mGame);
 
       if (favoriteSystem != nullptr)
       {
         if (md.Favorite())
         {
-          favoriteSystem->GetFavoriteRoot().addChild(mGame, false);
+          favoriteSystem->GetFavoriteRoot().Add(*mGame);
         }
         else
         {
-          favoriteSystem->GetFavoriteRoot().removeChild(mGame);
+          favoriteSystem->GetFavoriteRoot().Remove(*mGame);
         }
 
         ViewController::Instance().setInvalidGamesList(mGame->getSystem());
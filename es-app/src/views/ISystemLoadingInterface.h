@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+class SystemData;
+
+class ISystemLoadingInterface
+{
+  public:
+    /*!
+     * @brief Called from the main thread when a system loaded in background is complete
+     * @param system System whose game tree is now available
+     * @param updatedSystems Meta-systems (favorites, collections) that received games from this system
+     */
+    virtual void SystemLoaded(SystemData& system, const std::vector<SystemData*>& updatedSystems) = 0;
+
+    /*!
+     * @brief Called from the main thread when the game tree of a system has been patched,
+     * after an external modification of its gamelists or rom folders
+     * @param system System whose game tree has been patched
+     * @param updatedSystems Meta-systems (favorites, collections) whose game list has changed
+     */
+    virtual void SystemUpdated(SystemData& system, const std::vector<SystemData*>& updatedSystems) = 0;
+};
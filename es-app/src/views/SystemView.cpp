@@ -807,3 +807,34 @@ void SystemView::manageFavorite()
   if (hasFavorite && favorite->FavoritesCount() == 0) removeFavoriteSystem();
   else if (!hasFavorite && favorite->FavoritesCount() > 0) addSystem(favorite);
 }
+
+void SystemView::manageSystemsVisibility(const std::vector<SystemData*>& systems)
+{
+  // Not populated yet?
+  if (mEntries.empty()) return;
+
+  // Any system to add or remove?
+  bool changed = false;
+  for (SystemData* system : systems)
+  {
+    bool displayed = false;
+    for (auto& mEntrie : mEntries)
+      if (mEntrie.object == system)
+      {
+        displayed = true;
+        break;
+      }
+    if (displayed != system->HasVisibleGame())
+    {
+      changed = true;
+      break;
+    }
+  }
+  if (!changed) return;
+
+  // Rebuild, keeping the selected system
+  SystemData* selected = getSelected();
+  populate();
+  if (!setCursor(selected))
+    setCursor(mSystemManager.FirstNonEmptySystem());
+}
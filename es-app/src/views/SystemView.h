@@ -61,6 +61,11 @@ public:
 	void populate();
 	void removeFavoriteSystem();
 	void manageFavorite();
+	/*!
+	 * @brief Add or remove the given systems whose game lists changed, if required
+	 * @param systems Systems to check
+	 */
+	void manageSystemsVisibility(const std::vector<SystemData*>& systems);
 	void addSystem(SystemData * it);
 
 protected:
@@ -39,6 +39,8 @@ ViewController::ViewController(WindowManager& window, SystemManager& systemManag
 {
   // Progress interface
   systemManager.SetProgressInterface(&mSplashView);
+  // Systems loaded in background
+  systemManager.SetLoadingInterface(this);
 
   // default view mode
 	mState.viewing = ViewMode::SplashScreen;
@@ -180,6 +182,10 @@ bool ViewController::goToGameList(std::string& systemName) {
 
 void ViewController::goToGameList(SystemData* system)
 {
+  // Still loading in background? The user is waiting for it
+  if (system->IsLoading())
+    mSystemManager.PrioritizeLoading(system);
+
 	if (mState.viewing == ViewMode::SystemList)
 	{
 		// move system list
@@ -604,6 +610,45 @@ bool ViewController::reloadGameListView(IGameListView* view, bool reloadTheme)
   }
 }
 
+void ViewController::SystemLoaded(SystemData& system, const std::vector<SystemData*>& updatedSystems)
+{
+  // Replace the loading state of the system view, if already created
+  auto loaded = mGameListViews.find(&system);
+  if (loaded != mGameListViews.end())
+    loaded->second->onLoadingComplete();
+
+  // Meta-systems are refreshed now if displayed, or when they are displayed next
+  for(SystemData* updated : updatedSystems)
+  {
+    auto view = mGameListViews.find(updated);
+    if (view == mGameListViews.end()) continue;
+    if (mCurrentView == view->second.get()) reloadGameListView(updated);
+    else setInvalidGamesList(updated);
+  }
+
+  // Systems may have appeared in or disappeared from the system list
+  std::vector<SystemData*> systems(updatedSystems);
+  systems.push_back(&system);
+  mSystemListView.manageSystemsVisibility(systems);
+}
+
+void ViewController::SystemUpdated(SystemData& system, const std::vector<SystemData*>& updatedSystems)
+{
+  // Patched systems are refreshed now if displayed, or when they are displayed next
+  std::vector<SystemData*> systems(updatedSystems);
+  systems.push_back(&system);
+  for(SystemData* updated : systems)
+  {
+    auto view = mGameListViews.find(updated);
+    if (view == mGameListViews.end()) continue;
+    if (mCurrentView == view->second.get()) reloadGameListView(updated);
+    else setInvalidGamesList(updated);
+  }
+
+  // Meta-systems may have been emptied or filled
+  mSystemListView.manageSystemsVisibility(systems);
+}
+
 void ViewController::setInvalidGamesList(SystemData* system)
 {
 	for (auto& mGameListView : mGameListViews)
@@ -6,11 +6,12 @@
 #include "views/gamelist/IGameListView.h"
 #include "views/SystemView.h"
 #include "SplashView.h"
+#include "ISystemLoadingInterface.h"
 
 class SystemData;
 
 // Used to smoothly transition the camera between multiple views (e.g. from system to system, from gamelist to gamelist).
-class ViewController : public StaticLifeCycleControler<ViewController>, public Gui, private INoCopy
+class ViewController : public StaticLifeCycleControler<ViewController>, public Gui, public ISystemLoadingInterface, private INoCopy
 {
 public:
 	ViewController(WindowManager& window, SystemManager& systemManager);
@@ -108,6 +109,13 @@ public:
 	 */
 	IProgressInterface& GetProgressInterface() { return mSplashView; }
 
+	/*
+	 * ISystemLoadingInterface implementation
+	 */
+
+	void SystemLoaded(SystemData& system, const std::vector<SystemData*>& updatedSystems) override;
+	void SystemUpdated(SystemData& system, const std::vector<SystemData*>& updatedSystems) override;
+
 private:
 	void playViewTransition();
 	int getSystemId(SystemData* system);
@@ -5,6 +5,7 @@
 #include "themes/ThemeData.h"
 #include "systems/SystemData.h"
 #include "games/FileSorts.h"
+#include "games/PooledList.h"
 #include "Settings.h"
 #include "utils/locale/LocaleHelper.h"
 #include "SystemIcons.h"
@@ -85,12 +86,18 @@ void BasicGameListView::populateList(const FolderData& folder)
 
   // Get items
   bool flatfolders = mSystem.IsAlwaysFlat() || (RecalboxConf::Instance().AsBool(mSystem.getName() + ".flatfolder"));
-  FileData::List items;
+  PooledList pooled;
+  FileData::List& items = pooled.List();
   if (flatfolders) folder.getItemsRecursivelyTo(items, filter, false, mSystem.IncludeAdultGames());
   else             folder.getItemsTo(items, filter, true, mSystem.IncludeAdultGames());
 
   // Check emptyness
-  if (items.empty()) items.push_back(&mEmptyListItem); // Insert "EMPTY SYSTEM" item
+  if (items.empty())
+  {
+    // Insert "EMPTY SYSTEM" item, or "LOADING" item while the system is loading in background
+    mEmptyListItem.Metadata().SetName(IsLoading() ? _("LOADING...") : _("EMPTY LIST"));
+    items.push_back(&mEmptyListItem);
+  }
 
   // Sort
   FileSorts::Sorts sort =
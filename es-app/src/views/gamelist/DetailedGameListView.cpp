@@ -393,21 +393,31 @@ void DetailedGameListView::setFolderInfo(FolderData* folder)
 {
   char strbuf[256];
 
-  FileData::List games = folder->getAllDisplayableItemsRecursively(false, folder->getSystem()->IncludeAdultGames());
-  snprintf(strbuf, 256, _N("%i GAME AVAILABLE", "%i GAMES AVAILABLE", (int) games.size()).c_str(), games.size());
+  bool adult = folder->getSystem()->IncludeAdultGames();
+  int count = folder->countAllDisplayableItemsRecursively(false, adult);
+  snprintf(strbuf, 256, _N("%i GAME AVAILABLE", "%i GAMES AVAILABLE", count).c_str(), count);
   mFolderName.setText(folder->getName() + " - " + strbuf);
 
-  unsigned char idx = 0;
-
-  for (FileData* game : games)
+  // Fill thumbnails from the first games having one, and stop there
+  class Thumbnails : public IVisitor
   {
-    if (game->hasThumbnailOrImage())
-    {
-      mFolderContent[idx]->setImage(game->getThumbnailOrImagePath());
-      if (++idx == mFolderContent.size())
-        break;
-    }
+    private:
+      std::vector<ImageComponent*>& mImages;
+    public:
+      unsigned char mIndex;
+      explicit Thumbnails(std::vector<ImageComponent*>& images) : mImages(images), mIndex(0) {}
+      bool Visit(FileData& game) override
+      {
+        if (game.hasThumbnailOrImage())
+          mImages[mIndex++]->setImage(game.getThumbnailOrImagePath());
+        return mIndex < mImages.size();
+      }
   }
+  thumbnails(mFolderContent);
+  if (!mFolderContent.empty())
+    folder->visitGamesRecursively(thumbnails, FileData::Filter::Normal | FileData::Filter::Favorite, adult);
+  unsigned char idx = thumbnails.mIndex;
+
   for (int i = idx; i < (int) mFolderContent.size(); i++)
   {
     mFolderContent[i]->setImage(Path());
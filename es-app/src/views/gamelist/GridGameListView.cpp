@@ -3,6 +3,7 @@
 #include "WindowManager.h"
 #include "Settings.h"
 #include "utils/locale/LocaleHelper.h"
+#include "games/PooledList.h"
 
 GridGameListView::GridGameListView(WindowManager&window, SystemData& system)
   : ISimpleGameListView(window, mSystemManager, system),
@@ -36,9 +37,10 @@ void GridGameListView::populateList(const FolderData& folder)
 {
 	mGrid.clear();
 	bool favoritesOnly = Settings::Instance().FavoritesOnly();
-	FileData::List files = favoritesOnly ?
-	  folder.getAllFavorites(true, folder.getSystem()->IncludeAdultGames()) :
-	  folder.getAllDisplayableItems(true, folder.getSystem()->IncludeAdultGames());
+	PooledList pooled;
+	FileData::List& files = pooled.List();
+	folder.getItemsTo(files, favoritesOnly ? FileData::Filter::Favorite : FileData::Filter::Normal | FileData::Filter::Favorite,
+	                  true, folder.getSystem()->IncludeAdultGames());
 	for (FileData* fd : files)
 	{
 		mGrid.add(fd->getName(), fd->getThumbnailOrImagePath(), fd);
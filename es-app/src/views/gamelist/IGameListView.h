@@ -59,6 +59,17 @@ class IGameListView : public Gui
     // Called whenever the theme changes.
     virtual void onThemeChanged(const ThemeData& theme) = 0;
 
+    /*!
+     * @brief Check if the system game tree is still loading in background
+     * @return True if the view displays a loading state
+     */
+    bool IsLoading() const { return mSystem.IsLoading(); }
+
+    /*!
+     * @brief Called when the system game tree loaded in background is available
+     */
+    virtual void onLoadingComplete() = 0;
+
     void setTheme(const ThemeData& theme);
 
     inline const ThemeData& getTheme() const { return *mTheme; }
@@ -9,6 +9,7 @@
 #include "views/ViewController.h"
 #include "Settings.h"
 #include "utils/locale/LocaleHelper.h"
+#include <games/PlayStatsJournal.h>
 
 ISimpleGameListView::ISimpleGameListView(WindowManager& window, SystemManager& systemManager, SystemData& system)
   : IGameListView(window, system),
@@ -87,6 +88,15 @@ void ISimpleGameListView::onChanged(Change change)
   updateInfoPanel();
 }
 
+void ISimpleGameListView::onLoadingComplete()
+{
+  // Replace the loading item with the real list
+  populateList(mSystem.MasterRoot());
+  setCursorIndex(0);
+  // And refresh game info
+  updateInfoPanel();
+}
+
 void ISimpleGameListView::onFileChanged(FileData* file, FileChangeType change)
 {
   if (change == FileChangeType::Run)
@@ -101,13 +111,13 @@ void ISimpleGameListView::onFileChanged(FileData* file, FileChangeType change)
   if (file->isGame())
   {
     SystemData* favoriteSystem = mSystemManager.FavoriteSystem();
-    bool isInFavorite = favoriteSystem->GetFavoriteRoot().Contains(file, true);
+    bool isInFavorite = favoriteSystem->GetFavoriteRoot().Has(*file);
     bool isFavorite = file->Metadata().Favorite();
 
     if (isInFavorite != isFavorite)
     {
-      if (isInFavorite) favoriteSystem->GetFavoriteRoot().removeChild(file);
-      else favoriteSystem->GetFavoriteRoot().addChild(file, false);
+      if (isInFavorite) favoriteSystem->GetFavoriteRoot().Remove(*file);
+      else favoriteSystem->GetFavoriteRoot().Add(*file);
       ViewController::Instance().setInvalidGamesList(mSystemManager.FavoriteSystem());
       ViewController::Instance().getSystemListView().manageFavorite();
       if (mSystem.FavoritesCount() == 0) mFavoritesOnly = false;
@@ -192,12 +202,13 @@ bool ISimpleGameListView::ProcessInput(const InputCompactEvent& event) {
       MetadataDescriptor& md = cursor->Metadata();
       SystemData *favoriteSystem = mSystemManager.FavoriteSystem();
 
-      md.SetFavorite(!md.Favorite());
+      cursor->SetFavorite(!md.Favorite());
+      PlayStatsJournal::Append(*cursor);
 
       if (favoriteSystem != nullptr)
       {
-        if (md.Favorite()) favoriteSystem->GetFavoriteRoot().addChild(cursor, false);
-        else favoriteSystem->GetFavoriteRoot().removeChild(cursor);
+        if (md.Favorite()) favoriteSystem->GetFavoriteRoot().Add(*cursor);
+        else favoriteSystem->GetFavoriteRoot().Remove(*cursor);
 
         ViewController::Instance().setInvalidGamesList(cursor->getSystem());
         ViewController::Instance().setInvalidGamesList(favoriteSystem);
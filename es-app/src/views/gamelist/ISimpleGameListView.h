@@ -23,6 +23,11 @@ public:
    */
   void onChanged(Change change) override;
 
+  /*!
+   * @brief Called when the system game tree loaded in background is available
+   */
+  void onLoadingComplete() override;
+
 	// Called whenever the theme changes.
 	void onThemeChanged(const ThemeData& theme) override;
 
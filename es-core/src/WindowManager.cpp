@@ -214,6 +214,10 @@ void WindowManager::Update(int deltaTime)
       ss += "\nFont VRAM: " + Strings::ToString(fontVramUsageMb, 2) + " Tex VRAM: " +
             Strings::ToString(textureVramUsageMb, 2) + " Tex Max: " + Strings::ToString(textureTotalUsageMb, 2);
 
+      // Application specific
+      std::string additional = FramerateAdditionalInformation();
+      if (!additional.empty()) ss.append(1, '\n').append(additional);
+
       mFrameDataText = std::unique_ptr<TextCache>(mDefaultFonts[1]->buildTextCache(ss, 50.f, 50.f, 0xFF00FFFF));
     }
 
@@ -91,6 +91,13 @@ class WindowManager
      */
     virtual bool UpdateHelpSystem();
 
+  protected:
+    /*!
+     * @brief Get additional information to display below framerate statistics
+     * @return Additional lines, or an empty string
+     */
+    virtual std::string FramerateAdditionalInformation() { return std::string(); }
+
   private:
     //! Maximum popup info
     static constexpr int sMaxInfoPopups = 10;
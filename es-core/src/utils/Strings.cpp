@@ -79,6 +79,82 @@ std::string Strings::ToLowerUTF8(const std::string& _string)
   return result;
 }
 
+std::string Strings::ToSearchKey(const std::string& source)
+{
+  std::string result;
+  result.reserve(source.size());
+  int l = (int)source.size();
+
+  for(int cursor = 0; cursor < l; )
+  {
+    unsigned char c = source[cursor];
+    if((c & 0x80) == 0) // 0xxxxxxx, one byte character
+    {
+      // Simple ASCII7 lowercase
+      result += (char)(c - 0x41u < 26u ? c | 0x20 : c);
+      cursor++;
+      continue;
+    }
+
+    // Truncated sequence?
+    int start = cursor;
+    int length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+    if (start + length > l) break;
+    unsigned int unicode = chars2Unicode(source, cursor);
+
+    // Combining diacritical marks are dropped
+    if (unicode - 0x300u < 0x70u) continue;
+    // Latin letters with diacritics
+    if (unicode - UnicodeSearchKeyFirst < (unsigned int)(sizeof(UnicodeSearchKeyTable) / sizeof(UnicodeSearchKeyTable[0])))
+    {
+      const char* key = UnicodeSearchKeyTable[unicode - UnicodeSearchKeyFirst];
+      if (key != nullptr)
+      {
+        result.append(key);
+        continue;
+      }
+    }
+    // Other letters are just lowercased
+    unsigned int lower = LowerChar(unicode);
+    if (lower != unicode) result.append(unicode2Chars(lower));
+    else result.append(source, start, cursor - start);
+  }
+
+  return result;
+}
+
+std::string Strings::ToSortKey(const std::string& source)
+{
+  std::string result;
+  result.reserve(source.size());
+  int l = (int)source.size();
+
+  for(int cursor = 0; cursor < l; )
+  {
+    unsigned char c = source[cursor];
+    if((c & 0x80) == 0) // 0xxxxxxx, one byte character
+    {
+      // Simple ASCII7 uppercase
+      result += (char)(c - 0x61u < 26u ? c & 0xDF : c);
+      cursor++;
+      continue;
+    }
+
+    // Truncated sequence?
+    int start = cursor;
+    int length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+    if (start + length > l) break;
+    unsigned int unicode = chars2Unicode(source, cursor);
+
+    // UTF8 byte order is the code point order
+    unsigned int upper = UpperChar(unicode);
+    if (upper != unicode) result.append(unicode2Chars(upper));
+    else result.append(source, start, cursor - start);
+  }
+
+  return result;
+}
+
 std::string Strings::ToUpperUTF8(const std::string& _string)
 {
   std::string result = _string; // Allocate memory once
@@ -792,6 +868,15 @@ int Strings::CountChar(const std::string& source, char c)
   return count;
 }
 
+size_t Strings::HeapSize(const std::string& source)
+{
+  // Small strings are stored inside the object itself
+  const char* data = source.data();
+  const char* object = (const char*)&source;
+  if (data >= object && data < object + sizeof(source)) return 0;
+  return source.capacity() + 1;
+}
+
 std::string Strings::Extract(const std::string& source, const char* starttag, const char* endtag, int starttagl, int endtagl)
 {
   int start = source.find(starttag, 0, starttagl);
@@ -63,6 +63,13 @@ class Strings
 
     static int CountChar(const std::string& source, char c);
 
+    /*!
+     * @brief Get the heap memory used by a string, out of the string object itself
+     * @param source String
+     * @return Size in bytes, 0 if the string is stored inline (small string optimization)
+     */
+    static size_t HeapSize(const std::string& source);
+
     static bool Contains(const std::string& source, const char* what);
 
     static bool Contains(const std::string& source, const std::string& what);
@@ -73,6 +80,22 @@ class Strings
 
     static std::string ToUpperUTF8(const std::string& _string);
 
+    /*!
+     * @brief Build a search key: lowercase, latin letters without diacritics ("Pokémon" => "pokemon")
+     * Keys can be compared byte per byte, without any case or accent consideration
+     * @param source UTF8 source string
+     * @return Search key
+     */
+    static std::string ToSearchKey(const std::string& source);
+
+    /*!
+     * @brief Build a sort key: uppercase unicode characters, UTF8 encoded.
+     * Comparing keys byte per byte (memcmp) gives the same order as comparing uppercase code points one by one
+     * @param source UTF8 source string
+     * @return Sort key
+     */
+    static std::string ToSortKey(const std::string& source);
+
     static std::string ToLowerASCII(const std::string& _string);
 
     static std::string ToUpperASCII(const std::string& _string);
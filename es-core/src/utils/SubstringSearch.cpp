@@ -0,0 +1,238 @@
+#include "utils/SubstringSearch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #if defined(__SSE2__)
+    #define SUBSTRING_SEARCH_SSE2
+    #if defined(__GNUC__)
+      // Compiled for AVX2 whatever the target, selected at runtime
+      #define SUBSTRING_SEARCH_AVX2
+    #endif
+  #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define SUBSTRING_SEARCH_NEON
+#endif
+
+/*!
+ * @brief Compare bytes, folding the case of the text searched in
+ * @param text Text to search for
+ * @param into Text to search in
+ * @param length Byte count
+ * @param fold Fold mask
+ * @return True if all bytes are equal
+ */
+static inline bool Verify(const unsigned char* text, const unsigned char* into, int length, unsigned char fold)
+{
+  for (int i = 0; i < length; ++i)
+    if ((into[i] | fold) != text[i]) return false;
+  return true;
+}
+
+static int FindScalar(const unsigned char* text, int textLength, const unsigned char* into, int intoLength, unsigned char fold)
+{
+  if (textLength == 0) return 0;
+  const unsigned char first = text[0];
+  for (int i = 0, last = intoLength - textLength; i <= last; ++i)
+    if ((into[i] | fold) == first)
+      if (Verify(text + 1, into + i + 1, textLength - 1, fold))
+        return i;
+  return -1;
+}
+
+#ifdef SUBSTRING_SEARCH_SSE2
+static int FindSSE2(const unsigned char* text, int textLength, const unsigned char* into, int intoLength, unsigned char fold)
+{
+  if (textLength < 2) return FindScalar(text, textLength, into, intoLength, fold);
+  // Candidate positions are [0, count[. The last byte load never goes beyond the end
+  int count = intoLength - textLength + 1;
+  if (count < 16) return FindScalar(text, textLength, into, intoLength, fold);
+
+  const __m128i folder = _mm_set1_epi8((char)fold);
+  const __m128i first = _mm_set1_epi8((char)text[0]);
+  const __m128i last = _mm_set1_epi8((char)text[textLength - 1]);
+  for (int i = 0; i < count; i += 16)
+  {
+    // Last block overlaps the previous one: skip already checked positions
+    int shift = 0;
+    if (i + 16 > count)
+    {
+      shift = i - (count - 16);
+      i = count - 16;
+    }
+    __m128i blockFirst = _mm_or_si128(_mm_loadu_si128((const __m128i*)(into + i)), folder);
+    __m128i blockLast = _mm_or_si128(_mm_loadu_si128((const __m128i*)(into + i + textLength - 1)), folder);
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+    mask &= 0xFFFFu << shift;
+    for (; mask != 0; mask &= mask - 1)
+    {
+      int bit = __builtin_ctz(mask);
+      if (Verify(text + 1, into + i + bit + 1, textLength - 2, fold)) return i + bit;
+    }
+  }
+  return -1;
+}
+#endif
+
+#ifdef SUBSTRING_SEARCH_AVX2
+__attribute__((target("avx2")))
+static int FindAVX2(const unsigned char* text, int textLength, const unsigned char* into, int intoLength, unsigned char fold)
+{
+  if (textLength < 2) return FindScalar(text, textLength, into, intoLength, fold);
+  // Candidate positions are [0, count[. The last byte load never goes beyond the end
+  int count = intoLength - textLength + 1;
+  if (count < 32) return FindSSE2(text, textLength, into, intoLength, fold);
+
+  const __m256i folder = _mm256_set1_epi8((char)fold);
+  const __m256i first = _mm256_set1_epi8((char)text[0]);
+  const __m256i last = _mm256_set1_epi8((char)text[textLength - 1]);
+  // Do not hand remaining positions to SSE2 code: mixing both costs a state transition
+  for (int i = 0; i < count; i += 32)
+  {
+    // Last block overlaps the previous one: skip already checked positions
+    int shift = 0;
+    if (i + 32 > count)
+    {
+      shift = i - (count - 32);
+      i = count - 32;
+    }
+    __m256i blockFirst = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(into + i)), folder);
+    __m256i blockLast = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(into + i + textLength - 1)), folder);
+    unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last)));
+    mask &= 0xFFFFFFFFu << shift;
+    for (; mask != 0; mask &= mask - 1)
+    {
+      int bit = __builtin_ctz(mask);
+      if (Verify(text + 1, into + i + bit + 1, textLength - 2, fold)) return i + bit;
+    }
+  }
+  return -1;
+}
+#endif
+
+#ifdef SUBSTRING_SEARCH_NEON
+static int FindNeon(const unsigned char* text, int textLength, const unsigned char* into, int intoLength, unsigned char fold)
+{
+  if (textLength < 2) return FindScalar(text, textLength, into, intoLength, fold);
+
+  const uint8x16_t folder = vdupq_n_u8(fold);
+  const uint8x16_t first = vdupq_n_u8(text[0]);
+  const uint8x16_t last = vdupq_n_u8(text[textLength - 1]);
+  // Candidate positions are [0, count[. The last byte load never goes beyond the end
+  int count = intoLength - textLength + 1;
+  if (count < 16) return FindScalar(text, textLength, into, intoLength, fold);
+
+  for (int i = 0; i < count; i += 16)
+  {
+    // Last block overlaps the previous one: skip already checked positions
+    int shift = 0;
+    if (i + 16 > count)
+    {
+      shift = i - (count - 16);
+      i = count - 16;
+    }
+    uint8x16_t blockFirst = vorrq_u8(vld1q_u8(into + i), folder);
+    uint8x16_t blockLast = vorrq_u8(vld1q_u8(into + i + textLength - 1), folder);
+    uint8x16_t equals = vandq_u8(vceqq_u8(blockFirst, first), vceqq_u8(blockLast, last));
+    // No movemask on NEON: narrow each byte to a nibble
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equals), 4)), 0);
+    if (shift != 0) mask &= ~0ull << (shift << 2);
+    for (; mask != 0; mask &= ~(0xFull << (__builtin_ctzll(mask) & ~3)))
+    {
+      int bit = __builtin_ctzll(mask) >> 2;
+      if (Verify(text + 1, into + i + bit + 1, textLength - 2, fold)) return i + bit;
+    }
+  }
+  return -1;
+}
+#endif
+
+SubstringSearch::Variant SubstringSearch::sSelected = SubstringSearch::Variant::Scalar;
+SubstringSearch::Finder SubstringSearch::sFinder = FindScalar;
+
+bool SubstringSearch::sInitialized = SubstringSearch::sInitialize();
+
+bool SubstringSearch::sInitialize()
+{
+  if (!sInitialized)
+  {
+    static const Variant sPreferred[] = { Variant::AVX2, Variant::SSE2, Variant::Neon };
+    for (Variant variant : sPreferred)
+      if (IsAvailable(variant))
+      {
+        sSelected = variant;
+        break;
+      }
+    sFinder = Get(sSelected);
+  }
+  return true;
+}
+
+bool SubstringSearch::IsAvailable(Variant variant)
+{
+  switch(variant)
+  {
+    case Variant::Scalar: return true;
+    case Variant::SSE2:
+    {
+      #ifdef SUBSTRING_SEARCH_SSE2
+      return true;
+      #endif
+      break;
+    }
+    case Variant::AVX2:
+    {
+      #ifdef SUBSTRING_SEARCH_AVX2
+      // Cpu model may not be initialized yet when called from static initializers
+      static const bool sSupported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+      return sSupported;
+      #endif
+      break;
+    }
+    case Variant::Neon:
+    {
+      #ifdef SUBSTRING_SEARCH_NEON
+      return true;
+      #endif
+      break;
+    }
+  }
+  return false;
+}
+
+SubstringSearch::Finder SubstringSearch::Get(Variant variant)
+{
+  if (IsAvailable(variant))
+    switch(variant)
+    {
+      case Variant::Scalar: break;
+      #ifdef SUBSTRING_SEARCH_SSE2
+      case Variant::SSE2: return FindSSE2;
+      #else
+      case Variant::SSE2: break;
+      #endif
+      #ifdef SUBSTRING_SEARCH_AVX2
+      case Variant::AVX2: return FindAVX2;
+      #else
+      case Variant::AVX2: break;
+      #endif
+      #ifdef SUBSTRING_SEARCH_NEON
+      case Variant::Neon: return FindNeon;
+      #else
+      case Variant::Neon: break;
+      #endif
+    }
+  return FindScalar;
+}
+
+const char* SubstringSearch::Name(Variant variant)
+{
+  switch(variant)
+  {
+    case Variant::Scalar: return "Scalar";
+    case Variant::SSE2: return "SSE2";
+    case Variant::AVX2: return "AVX2";
+    case Variant::Neon: return "NEON";
+  }
+  return "Unknown";
+}
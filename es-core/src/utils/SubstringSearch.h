@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+
+/*!
+ * @brief Vectorized substring search
+ *
+ * Wide compares look for candidate positions whose first and last bytes match the searched text,
+ * then candidates are checked byte per byte.
+ * The best variant available on the running CPU is selected once at startup:
+ * AVX2 or SSE2 on x86, NEON on ARM, scalar everywhere else.
+ *
+ * Optional case folding is the one used by game searches: bytes of the text searched in
+ * are ORed with 0x20, so the searched text must be lowercase already.
+ */
+class SubstringSearch
+{
+  public:
+    //! Implementations
+    enum class Variant
+    {
+      Scalar, //!< Byte per byte, always available
+      SSE2,   //!< 16 bytes at once, x86
+      AVX2,   //!< 32 bytes at once, x86
+      Neon,   //!< 16 bytes at once, ARM
+    };
+
+    /*!
+     * @brief Search text into another text, using the best variant
+     * @param text Text to search for
+     * @param into Text to search in
+     * @param caseFold True to fold ASCII case of the text searched in
+     * @return Index of the first occurence of text, or -1
+     */
+    static int Find(const std::string& text, const std::string& into, bool caseFold)
+    {
+      return sFinder((const unsigned char*)text.data(), (int)text.size(), (const unsigned char*)into.data(), (int)into.size(), caseFold ? 0x20 : 0);
+    }
+
+    /*!
+     * @brief Search text into another text, using the given variant
+     * @param variant Variant to use. Scalar is used if the variant is not available
+     * @param text Text to search for
+     * @param into Text to search in
+     * @param caseFold True to fold ASCII case of the text searched in
+     * @return Index of the first occurence of text, or -1
+     */
+    static int Find(Variant variant, const std::string& text, const std::string& into, bool caseFold)
+    {
+      return Get(variant)((const unsigned char*)text.data(), (int)text.size(), (const unsigned char*)into.data(), (int)into.size(), caseFold ? 0x20 : 0);
+    }
+
+    /*!
+     * @brief Check if a variant can run on this CPU
+     * @param variant Variant to check
+     * @return True if the variant is available
+     */
+    static bool IsAvailable(Variant variant);
+
+    //! Variant used by Find
+    static Variant Selected() { return sSelected; }
+
+    /*!
+     * @brief Get variant name
+     * @param variant Variant
+     * @return Name
+     */
+    static const char* Name(Variant variant);
+
+  private:
+    //! Implementation signature
+    typedef int (*Finder)(const unsigned char* text, int textLength, const unsigned char* into, int intoLength, unsigned char fold);
+
+    //! Selected variant
+    static Variant sSelected;
+    //! Selected implementation
+    static Finder sFinder;
+
+    static bool sInitialized;
+
+    static bool sInitialize();
+
+    /*!
+     * @brief Get a variant implementation
+     * @param variant Variant
+     * @return Implementation, or scalar implementation if the variant is not available
+     */
+    static Finder Get(Variant variant);
+};
@@ -675,3 +675,26 @@ static UnicodeConverter UnicodeConverterTable[] =
   { 0xFF59, 0xFF39 }, // FULLWIDTH LATIN SMALL LETTER Y to FULLWIDTH LATIN CAPITAL LETTER Y
   { 0xFF5A, 0xFF3A }, // FULLWIDTH LATIN SMALL LETTER Z to FULLWIDTH LATIN CAPITAL LETTER Z
 };
+
+//! First unicode of the search key table
+static constexpr unsigned int UnicodeSearchKeyFirst = 0x00C0;
+
+/*
+ * Search keys of Latin-1 Supplement & Latin Extended-A letters, from U+00C0 to U+017F:
+ * case-folded base letters, without diacritics. Null entries are kept as is.
+ */
+static const char* UnicodeSearchKeyTable[] =
+{
+  "a" , "a" , "a" , "a" , "a" , "a" , "ae", "c" , "e" , "e" , "e" , "e" , "i" , "i" , "i" , "i" , // U+00C0 À Á Â Ã Ä Å Æ Ç È É Ê Ë Ì Í Î Ï
+  "d" , "n" , "o" , "o" , "o" , "o" , "o" , nullptr, "o" , "u" , "u" , "u" , "u" , "y" , "th", "ss", // U+00D0 Ð Ñ Ò Ó Ô Õ Ö × Ø Ù Ú Û Ü Ý Þ ß
+  "a" , "a" , "a" , "a" , "a" , "a" , "ae", "c" , "e" , "e" , "e" , "e" , "i" , "i" , "i" , "i" , // U+00E0 à á â ã ä å æ ç è é ê ë ì í î ï
+  "d" , "n" , "o" , "o" , "o" , "o" , "o" , nullptr, "o" , "u" , "u" , "u" , "u" , "y" , "th", "y" , // U+00F0 ð ñ ò ó ô õ ö ÷ ø ù ú û ü ý þ ÿ
+  "a" , "a" , "a" , "a" , "a" , "a" , "c" , "c" , "c" , "c" , "c" , "c" , "c" , "c" , "d" , "d" , // U+0100 Ā ā Ă ă Ą ą Ć ć Ĉ ĉ Ċ ċ Č č Ď ď
+  "d" , "d" , "e" , "e" , "e" , "e" , "e" , "e" , "e" , "e" , "e" , "e" , "g" , "g" , "g" , "g" , // U+0110 Đ đ Ē ē Ĕ ĕ Ė ė Ę ę Ě ě Ĝ ĝ Ğ ğ
+  "g" , "g" , "g" , "g" , "h" , "h" , "h" , "h" , "i" , "i" , "i" , "i" , "i" , "i" , "i" , "i" , // U+0120 Ġ ġ Ģ ģ Ĥ ĥ Ħ ħ Ĩ ĩ Ī ī Ĭ ĭ Į į
+  "i" , "i" , "ij", "ij", "j" , "j" , "k" , "k" , "k" , "l" , "l" , "l" , "l" , "l" , "l" , "l" , // U+0130 İ ı Ĳ ĳ Ĵ ĵ Ķ ķ ĸ Ĺ ĺ Ļ ļ Ľ ľ Ŀ
+  "l" , "l" , "l" , "n" , "n" , "n" , "n" , "n" , "n" , "n" , "n" , "n" , "o" , "o" , "o" , "o" , // U+0140 ŀ Ł ł Ń ń Ņ ņ Ň ň ŉ Ŋ ŋ Ō ō Ŏ ŏ
+  "o" , "o" , "oe", "oe", "r" , "r" , "r" , "r" , "r" , "r" , "s" , "s" , "s" , "s" , "s" , "s" , // U+0150 Ő ő Œ œ Ŕ ŕ Ŗ ŗ Ř ř Ś ś Ŝ ŝ Ş ş
+  "s" , "s" , "t" , "t" , "t" , "t" , "t" , "t" , "u" , "u" , "u" , "u" , "u" , "u" , "u" , "u" , // U+0160 Š š Ţ ţ Ť ť Ŧ ŧ Ũ ũ Ū ū Ŭ ŭ Ů ů
+  "u" , "u" , "u" , "u" , "w" , "w" , "y" , "y" , "y" , "z" , "z" , "z" , "z" , "z" , "z" , "s" , // U+0170 Ű ű Ų ų Ŵ ŵ Ŷ ŷ Ÿ Ź ź Ż ż Ž ž ſ
+};
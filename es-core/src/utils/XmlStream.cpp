@@ -0,0 +1,233 @@
+#include "XmlStream.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+XmlStream::XmlStream(IReceiver& receiver, const std::string& rootName, int batchSize)
+  : mReceiver(receiver),
+    mRootName(rootName),
+    mBatchSize(batchSize > 0 ? batchSize : 1),
+    mScan(0),
+    mElementStart(0),
+    mDepth(rootName.empty() ? 1 : 0),
+    mBatchCount(0),
+    mRootFound(rootName.empty()),
+    mError(false),
+    mStopped(false)
+{
+}
+
+static bool StartsWith(const std::string& buffer, size_t at, const char* prefix, size_t length)
+{
+  return buffer.compare(at, length, prefix, length) == 0;
+}
+
+size_t XmlStream::TokenEnd(size_t start) const
+{
+  // Not enough data to identify the token?
+  static constexpr size_t sLongestPrefix = sizeof("<![CDATA[") - 1;
+  size_t available = mBuffer.size() - start;
+  if (available < sLongestPrefix)
+    if (mBuffer.find('>', start) == std::string::npos)
+      return std::string::npos;
+
+  size_t end = std::string::npos;
+  if (StartsWith(mBuffer, start, "<?", 2))
+  {
+    end = mBuffer.find("?>", start + 2);
+    if (end != std::string::npos) end += 2;
+  }
+  else if (StartsWith(mBuffer, start, "<!--", 4))
+  {
+    end = mBuffer.find("-->", start + 4);
+    if (end != std::string::npos) end += 3;
+  }
+  else if (StartsWith(mBuffer, start, "<![CDATA[", 9))
+  {
+    end = mBuffer.find("]]>", start + 9);
+    if (end != std::string::npos) end += 3;
+  }
+  else if (StartsWith(mBuffer, start, "<!", 2))
+  {
+    end = mBuffer.find('>', start + 2);
+    if (end != std::string::npos) end += 1;
+  }
+  else
+  {
+    // Start/end tag: lookup the closing '>', ignoring quoted attribute values
+    char quote = 0;
+    for (size_t i = start + 1; i < mBuffer.size(); ++i)
+    {
+      char c = mBuffer[i];
+      if (quote != 0) { if (c == quote) quote = 0; }
+      else if (c == '"' || c == '\'') quote = c;
+      else if (c == '>') { end = i + 1; break; }
+    }
+  }
+  return end;
+}
+
+void XmlStream::ProcessTag(size_t start, size_t end)
+{
+  char second = mBuffer[start + 1];
+  // Comments, processing instructions, doctype & CDATA are not tags
+  if (second == '?' || second == '!') return;
+
+  // End tag
+  if (second == '/')
+  {
+    if (--mDepth == 1) AddElement(mElementStart, end);
+    if (mDepth < (mRootName.empty() ? 1 : 0)) mError = true;
+    return;
+  }
+
+  // Start tag
+  bool selfClosing = mBuffer[end - 2] == '/';
+  switch(mDepth)
+  {
+    case 0:
+    {
+      size_t nameEnd = mBuffer.find_first_of(" \t\r\n/>", start + 1);
+      if (mRootFound || mBuffer.compare(start + 1, nameEnd - start - 1, mRootName) != 0)
+      {
+        mError = true;
+        return;
+      }
+      mRootFound = true;
+      if (!selfClosing) mDepth = 1;
+      break;
+    }
+    case 1:
+    {
+      mElementStart = start;
+      if (selfClosing) AddElement(start, end);
+      else mDepth = 2;
+      break;
+    }
+    default:
+    {
+      if (!selfClosing) mDepth++;
+      break;
+    }
+  }
+}
+
+bool XmlStream::Feed(const char* data, int length)
+{
+  if (mError || mStopped) return false;
+  mBuffer.append(data, length);
+
+  while(!mError && !mStopped)
+  {
+    size_t start = mBuffer.find('<', mScan);
+    if (start == std::string::npos) { mScan = mBuffer.size(); break; }
+    mScan = start;
+    size_t end = TokenEnd(start);
+    if (end == std::string::npos) break; // Wait for more data
+    ProcessTag(start, end);
+    mScan = end;
+  }
+
+  // Discard processed data, but the pending child element
+  size_t processed = mDepth >= 2 ? mElementStart : mScan;
+  mBuffer.erase(0, processed);
+  mScan -= processed;
+  if (mDepth >= 2) mElementStart = 0;
+
+  return !mError && !mStopped;
+}
+
+void XmlStream::AddElement(size_t start, size_t end)
+{
+  mBatch.append(mBuffer, start, end - start);
+  if (++mBatchCount >= mBatchSize) Flush();
+}
+
+void XmlStream::Flush()
+{
+  if (mBatchCount == 0) return;
+
+  XmlResult result = mDocument.load_buffer_inplace(&mBatch[0], mBatch.size(), pugi::parse_default | pugi::parse_fragment, pugi::encoding_utf8);
+  if (!result) mError = true;
+  else if (!mReceiver.ReceiveElements(mDocument)) mStopped = true;
+
+  mDocument.reset();
+  mBatch.clear();
+  mBatchCount = 0;
+}
+
+bool XmlStream::Complete()
+{
+  if (!mError && !mStopped) Flush();
+  if (mStopped) return true;
+  return !mError && mRootFound && mDepth == (mRootName.empty() ? 1 : 0);
+}
+
+bool XmlStream::ParseFile(const Path& path)
+{
+  FILE* file = fopen(path.ToChars(), "rb");
+  if (file == nullptr) return false;
+
+  std::vector<char> buffer(sReadBufferSize);
+  bool ok = true;
+  for(size_t read = 0; ok && (read = fread(buffer.data(), 1, buffer.size(), file)) > 0; )
+    ok = Feed(buffer.data(), (int)read);
+  fclose(file);
+
+  return Complete();
+}
+
+XmlStreamWriter::XmlStreamWriter(const Path& path, const std::string& rootName, bool append)
+  : mPath(path),
+    mWritePath(append ? path : Path(path.ToString() + ".tmp")),
+    mRootName(append ? std::string() : rootName),
+    mFile(fopen(mWritePath.ToChars(), append ? "ab" : "wb")),
+    mError(mFile == nullptr)
+{
+  if (!mRootName.empty())
+  {
+    static constexpr const char* sHeader = "<?xml version=\"1.0\"?>\n";
+    write(sHeader, strlen(sHeader));
+    std::string root = '<' + mRootName + ">\n";
+    write(root.data(), root.size());
+  }
+}
+
+XmlStreamWriter::~XmlStreamWriter()
+{
+  if (mFile != nullptr)
+  {
+    fclose(mFile);
+    if (mWritePath != mPath) mWritePath.Delete();
+  }
+}
+
+void XmlStreamWriter::write(const void* data, size_t size)
+{
+  if (mFile != nullptr)
+    if (fwrite(data, 1, size, mFile) != size)
+      mError = true;
+}
+
+void XmlStreamWriter::Write(XmlNode element)
+{
+  element.print(*this, "\t", pugi::format_default, pugi::encoding_utf8, mRootName.empty() ? 0 : 1);
+}
+
+bool XmlStreamWriter::Commit()
+{
+  if (mFile == nullptr) return false;
+
+  if (!mRootName.empty())
+  {
+    std::string root = "</" + mRootName + ">\n";
+    write(root.data(), root.size());
+  }
+  if (fclose(mFile) != 0) mError = true;
+  mFile = nullptr;
+
+  if (mWritePath == mPath) return !mError;
+  if (!mError && Path::Rename(mWritePath, mPath)) return true;
+  mWritePath.Delete();
+  return false;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <string>
+#include <cstdio>
+#include <utils/Xml.h>
+#include <utils/Zip.h>
+#include <utils/os/fs/Path.h>
+
+/*!
+ * @brief Streamed reader of large xml documents made of a root node and a long list of child elements
+ *
+ * Data are fed by chunks. Complete child elements are gathered in small batches, and each batch is parsed
+ * as a document fragment and handed to the receiver. Neither the whole document nor its whole DOM
+ * are kept in memory: the memory footprint only depends on the batch size.
+ * Comments, processing instructions, doctypes and CDATA sections are skipped safely.
+ * When no root name is given, the document is a bare list of elements, as written by
+ * XmlStreamWriter in append mode.
+ */
+class XmlStream : public Zip::IContentReceiver
+{
+  public:
+    //! Element receiver interface
+    class IReceiver
+    {
+      public:
+        //! Default destructor
+        virtual ~IReceiver() = default;
+
+        /*!
+         * @brief Receive a batch of complete child elements
+         * @param elements Parent node of the batched elements. Only valid during the call
+         * @return False to stop parsing
+         */
+        virtual bool ReceiveElements(XmlNode elements) = 0;
+    };
+
+    /*!
+     * @brief Constructor
+     * @param receiver Element receiver
+     * @param rootName Expected root node name, or empty for a bare list of elements
+     * @param batchSize Maximum child elements per batch
+     */
+    XmlStream(IReceiver& receiver, const std::string& rootName, int batchSize);
+
+    /*!
+     * @brief Feed the parser with the next chunk of data
+     * @param data Data
+     * @param length Data length
+     * @return False if the document is invalid or if the receiver stopped parsing
+     */
+    bool Feed(const char* data, int length);
+
+    /*!
+     * @brief Signal the end of the document, and hand the last batch to the receiver
+     * @return True if the document has been fully and successfully parsed, or stopped by the receiver
+     */
+    bool Complete();
+
+    /*!
+     * @brief Stream a whole file
+     * @param path File path
+     * @return True if the document has been fully and successfully parsed, or stopped by the receiver
+     */
+    bool ParseFile(const Path& path);
+
+  private:
+    //! File read buffer size
+    static constexpr int sReadBufferSize = 64 << 10; // 64Kb
+
+    //! Receiver
+    IReceiver& mReceiver;
+    //! Expected root node name
+    std::string mRootName;
+    //! Maximum elements per batch
+    int mBatchSize;
+
+    //! Unprocessed data
+    std::string mBuffer;
+    //! Scan position in mBuffer
+    size_t mScan;
+    //! Start of the pending child element in mBuffer
+    size_t mElementStart;
+    //! Current depth. 0 = outside root, 1 = inside root, 2+ = inside a child element
+    int mDepth;
+
+    //! Complete elements waiting to be parsed
+    std::string mBatch;
+    //! Element count in mBatch
+    int mBatchCount;
+    //! Batch document
+    XmlDocument mDocument;
+
+    //! Root node found
+    bool mRootFound;
+    //! Parsing error
+    bool mError;
+    //! Parsing stopped by the receiver
+    bool mStopped;
+
+    /*!
+     * @brief Get the end of the markup token starting at the given position
+     * @param start '<' position
+     * @return Position right after the token, or std::string::npos if the token is not complete yet
+     */
+    size_t TokenEnd(size_t start) const;
+
+    /*!
+     * @brief Process a start or end tag
+     * @param start '<' position
+     * @param end Position right after '>'
+     */
+    void ProcessTag(size_t start, size_t end);
+
+    /*!
+     * @brief Add a complete child element to the current batch
+     * @param start Element start in mBuffer
+     * @param end Element end in mBuffer
+     */
+    void AddElement(size_t start, size_t end);
+
+    /*!
+     * @brief Parse the current batch and hand it to the receiver
+     */
+    void Flush();
+
+    /*
+     * Zip::IContentReceiver implementation
+     */
+
+    bool ReceiveContent(const char* data, int length) override { return Feed(data, length); }
+};
+
+/*!
+ * @brief Streamed writer of large xml documents made of a root node and a long list of child elements
+ *
+ * Child elements are printed one by one straight into the file, so that the whole document
+ * never has to be built in memory.
+ * In rewrite mode, the document is written aside and renamed over the target file on commit,
+ * so that an interrupted write never leaves a partial document.
+ * In append mode, elements are appended without root node, to an existing or new file.
+ */
+class XmlStreamWriter : private pugi::xml_writer
+{
+  public:
+    /*!
+     * @brief Constructor. Open the file
+     * @param path Target file path
+     * @param rootName Root node name. Ignored in append mode
+     * @param append True to append elements to the target file, false to rewrite it
+     */
+    XmlStreamWriter(const Path& path, const std::string& rootName, bool append);
+
+    /*!
+     * @brief Destructor. Drop the written document if it has not been committed
+     */
+    ~XmlStreamWriter() override;
+
+    /*!
+     * @brief Check if the file has been opened successfully
+     * @return True if the file is open
+     */
+    bool IsOpen() const { return mFile != nullptr; }
+
+    /*!
+     * @brief Write a child element
+     * @param element Element to write
+     */
+    void Write(XmlNode element);
+
+    /*!
+     * @brief Close the document and make it replace the target file
+     * @return True if the whole document has been written successfully
+     */
+    bool Commit();
+
+  private:
+    //! Target file
+    Path mPath;
+    //! File actually written
+    Path mWritePath;
+    //! Root node name, empty in append mode
+    std::string mRootName;
+    //! File
+    FILE* mFile;
+    //! Write error
+    bool mError;
+
+    /*
+     * pugi::xml_writer implementation
+     */
+
+    void write(const void* data, size_t size) override;
+};
@@ -4,6 +4,7 @@
 
 #include <utils/hash/Md5.h>
 #include <algorithm>
+#include <vector>
 #include "Zip.h"
 
 Zip::Zip(const Path& zipfile, bool write)
@@ -181,3 +182,22 @@ std::string Zip::Content(int index) const
   }
   return std::string();
 }
+
+bool Zip::Content(int index, IContentReceiver& receiver) const
+{
+  if (mArchive != nullptr)
+  {
+    zip_file_t* file = zip_fopen_index(mArchive, index, 0);
+    if (file != nullptr)
+    {
+      std::vector<char> buffer(sStreamBufferSize);
+      bool ok = true;
+      zip_int64_t read = 0;
+      while(ok && (read = zip_fread(file, buffer.data(), buffer.size())) > 0)
+        ok = receiver.ReceiveContent(buffer.data(), (int)read);
+      zip_fclose(file);
+      return ok && read == 0;
+    }
+  }
+  return false;
+}
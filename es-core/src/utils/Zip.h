@@ -9,7 +9,28 @@
 
 class Zip
 {
+  public:
+    //! Content receiver interface, for streamed reads
+    class IContentReceiver
+    {
+      public:
+        //! Default destructor
+        virtual ~IContentReceiver() = default;
+
+        /*!
+         * @brief Receive the next chunk of uncompressed content
+         * @param data Data
+         * @param length Data length
+         * @return False to stop reading
+         */
+        virtual bool ReceiveContent(const char* data, int length) = 0;
+    };
+
   private:
+    //! Streamed read buffer size
+    static constexpr int sStreamBufferSize = 64 << 10; // 64Kb
+
+
     //! Archive file
     zip_t* mArchive;
 
@@ -46,6 +67,14 @@ class Zip
      */
     std::string Content(int index) const;
 
+    /*!
+     * @brief Stream content of the entry at the given index, chunk by chunk, without loading it entirely
+     * @param index Entry index from 0 to Count()-1
+     * @param receiver Content receiver
+     * @return True if the whole content has been read and accepted by the receiver
+     */
+    bool Content(int index, IContentReceiver& receiver) const;
+
     /*!
      * @brief Get crc32 of the entry at the given index
      * @param index Entry index from 0 to Count()-1
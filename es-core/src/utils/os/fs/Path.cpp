@@ -7,6 +7,7 @@
 #include <zconf.h>
 #include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include "Path.h"
 
 const Path Path::Empty;
@@ -258,6 +259,17 @@ long long Path::Size() const
   return 0;
 }
 
+long long Path::LastModificationTime() const
+{
+  struct stat64 info = {};
+
+  // check if stat64 succeeded
+  if (stat64(mPath.c_str(), &info) == 0)
+    return (long long)info.st_mtim.tv_sec * 1000000000LL + (long long)info.st_mtim.tv_nsec;
+
+  return 0;
+}
+
 bool Path::IsFile() const
 {
   struct stat64 info = {};
@@ -443,6 +455,69 @@ Path::PathList Path::GetDirectoryContent() const
   return list;
 }
 
+static Path::EntryType EntryTypeFromMode(mode_t mode)
+{
+  if (S_ISREG(mode)) return Path::EntryType::File;
+  if (S_ISDIR(mode)) return Path::EntryType::Directory;
+  return Path::EntryType::Other;
+}
+
+Path::DirectoryEntryList Path::GetDirectoryEntries() const
+{
+  DirectoryEntryList list;
+
+  constexpr unsigned int dot    = (unsigned int)sDotDirectory;
+  constexpr unsigned int dotdot = (unsigned int)sDotDirectory | ((unsigned int)sDotDirectory << 8);
+
+  DIR* dir = opendir(mPath.c_str());
+  if(dir != nullptr)
+  {
+    int fd = dirfd(dir);
+    struct stat64 info = {};
+    const struct dirent64* entry = nullptr;
+    // loop over all files in the directory
+    while((entry = readdir64(dir)) != nullptr)
+    {
+      // Ignore "." and ".."
+      unsigned int strint = *((unsigned int*)entry->d_name);
+      if ((strint &   0xFFFF) == dot   ) continue;
+      if ((strint & 0xFFFFFF) == dotdot) continue;
+
+      EntryType type = EntryType::Unknown;
+      bool symLink = false;
+      switch(entry->d_type)
+      {
+        case DT_REG: type = EntryType::File; break;
+        case DT_DIR: type = EntryType::Directory; break;
+        case DT_LNK:
+        {
+          // Resolve the target type
+          symLink = true;
+          if (fstatat64(fd, entry->d_name, &info, 0) == 0) type = EntryTypeFromMode(info.st_mode);
+          break;
+        }
+        case DT_UNKNOWN:
+        {
+          // File system not filling d_type: stat relatively to the opened directory
+          if (fstatat64(fd, entry->d_name, &info, AT_SYMLINK_NOFOLLOW) == 0)
+          {
+            symLink = S_ISLNK(info.st_mode);
+            if (!symLink) type = EntryTypeFromMode(info.st_mode);
+            else if (fstatat64(fd, entry->d_name, &info, 0) == 0) type = EntryTypeFromMode(info.st_mode);
+          }
+          break;
+        }
+        default: type = EntryType::Other; break;
+      }
+
+      list.emplace_back(entry->d_name, (int)strlen(entry->d_name), type, symLink);
+    }
+    closedir(dir);
+  }
+
+  return list;
+}
+
 Path Path::MakeRelative(const Path& parent, bool &ok) const
 {
   if (!parent.IsEmpty())
@@ -38,6 +38,38 @@ class Path
   public:
     typedef std::vector<Path> PathList;
 
+    //! Directory entry type
+    enum class EntryType : char
+    {
+      Unknown,   //!< Cannot be determined (broken link, access error, ...)
+      File,      //!< Regular file
+      Directory, //!< Directory
+      Other,     //!< Device, pipe, socket, ...
+    };
+
+    //! Single directory entry, typed right from the directory listing
+    struct DirectoryEntry
+    {
+      std::string Name; //!< Entry name, without any path
+      EntryType Type;   //!< Entry type. Symbolic links are resolved to their target type
+      bool SymLink;     //!< True if the entry is a symbolic link
+
+      DirectoryEntry(const char* name, int length, EntryType type, bool symLink)
+        : Name(name, length),
+          Type(type),
+          SymLink(symLink)
+      {
+      }
+
+      //! @return True if the entry is a file
+      bool IsFile() const { return Type == EntryType::File; }
+      //! @return True if the entry is a directory
+      bool IsDirectory() const { return Type == EntryType::Directory; }
+      //! @return True if the entry is hidden (name starting with a dot)
+      bool IsHidden() const { return Name[0] == sDotDirectory; }
+    };
+    typedef std::vector<DirectoryEntry> DirectoryEntryList;
+
     //! Empty path
     static const Path Empty;
 
@@ -238,6 +270,12 @@ class Path
      */
     long long Size() const;
 
+    /*!
+     * @brief Get last modification time of the file or folder
+     * @return Modification time in nanoseconds since epoch, or 0 if the path does not exist
+     */
+    long long LastModificationTime() const;
+
     /*
      * Operator overloading
      */
@@ -465,6 +503,15 @@ class Path
      */
     PathList GetDirectoryContent() const;
 
+    /*!
+     * @brief Get typed entries from the current directory path, excluding "." and "..".
+     * Types come from the directory listing itself. Entries are only stat'ed, relatively
+     * to the opened directory, when the file system does not provide the type, or to
+     * resolve symbolic links
+     * @return Entry list, or empty list if the current path is invalid or not a directory
+     */
+    DirectoryEntryList GetDirectoryEntries() const;
+
     /*!
      * @brief Rename a from "from" to "to"
      * @param from Source path
@@ -74,13 +74,30 @@ void FileSystemWatcher::WatchFile(const Path& file)
                          "\"/proc/sys/fs/inotify/max_user_watches\".";
 
       LOG(LogError) << "Failed to watch! " << strerror(Error) << ". Path: " << file.ToString();
+      return;
     }
-    mDirectorieMap.insert({wd, file });
+    // A moved file or directory keeps its watch descriptor: update its path
+    mDirectorieMap[wd] = file;
   }
   else
     LOG(LogError) << "Can´t watch Path! Path does not exist. Path: " << file.ToString();
 }
 
+void FileSystemWatcher::UnwatchDirectoryRecursively(const Path& path)
+{
+  std::vector<int> removed;
+  for (const auto& item : mDirectorieMap)
+    if (item.second.StartWidth(path))
+      removed.push_back(item.first);
+
+  // Watches of removed directories are already gone: errors are expected
+  for (int wd : removed)
+  {
+    inotify_rm_watch(mInotifyFd, wd);
+    mDirectorieMap.erase(wd);
+  }
+}
+
 bool FileSystemWatcher::GetNextEvent(FileSystemEvent& fsevent)
 {
   std::vector<FileSystemEvent> newEvents;
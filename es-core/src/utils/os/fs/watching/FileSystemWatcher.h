@@ -63,6 +63,12 @@ class FileSystemWatcher
      */
     void WatchFile(const Path& file);
 
+    /*!
+     * @brief Remove the watches of the given directory and of all its sub-directories
+     * @param path Directory not to watch anymore
+     */
+    void UnwatchDirectoryRecursively(const Path& path);
+
     /*!
      * @brief Set the event we want to be notified of
      * @param eventMask events
@@ -75,6 +81,12 @@ class FileSystemWatcher
      */
     EventType EventMask() const { return mEventMask; }
 
+    /*!
+     * @brief Get the number of active watches
+     * @return Watch count
+     */
+    int WatchCount() const { return (int)mDirectorieMap.size(); }
+
     /*!
      * @brief Get next event if any
      * @param fsevent Event structure filled in with the next event if available
@@ -0,0 +1,141 @@
+#include "WorkStealingScheduler.h"
+#include <sys/sysinfo.h>
+#include <utils/Log.h>
+
+//! Scheduler the current thread works for, and its queue index
+static thread_local const WorkStealingScheduler* sCurrentScheduler = nullptr;
+static thread_local int sCurrentQueue = 0;
+
+WorkStealingScheduler::WorkStealingScheduler(const std::string& name, int threadCount)
+  : mQueued(0)
+{
+  if (threadCount <= 0) threadCount = get_nprocs_conf();
+
+  LOG(LogDebug) << "Creating work-stealing scheduler '" << name << "' using " << threadCount << " workers";
+
+  mQueues.push_back(new Queue()); // Injection queue
+  for (int i = 0; i < threadCount; ++i)
+  {
+    mQueues.push_back(new Queue());
+    mWorkers.push_back(new Worker(*this, (int)mQueues.size() - 1));
+  }
+  for (int i = 0; i < threadCount; ++i)
+    mWorkers[i]->Start(name + '#' + std::to_string(i));
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+  for (Worker* worker : mWorkers)
+    worker->Stop();
+  for (Worker* worker : mWorkers)
+  {
+    mIdleSignal.Signal();
+    worker->Join();
+    delete worker;
+  }
+  for (Queue* queue : mQueues)
+    delete queue;
+}
+
+int WorkStealingScheduler::CurrentQueue() const
+{
+  return sCurrentScheduler == this ? sCurrentQueue : sInjectionQueue;
+}
+
+void WorkStealingScheduler::Push(Group& group, Task&& task)
+{
+  group.mPending++;
+  Queue& queue = *mQueues[CurrentQueue()];
+  queue.Locker.Lock();
+  queue.Jobs.push_back({ &group, std::move(task) });
+  queue.Locker.UnLock();
+  mQueued++;
+  mIdleSignal.Signal();
+}
+
+bool WorkStealingScheduler::Next(int index, Job& job)
+{
+  if (mQueued == 0) return false;
+
+  // Own queue, last in first out
+  Queue& own = *mQueues[index];
+  own.Locker.Lock();
+  bool found = !own.Jobs.empty();
+  if (found)
+  {
+    job = std::move(own.Jobs.back());
+    own.Jobs.pop_back();
+  }
+  own.Locker.UnLock();
+
+  // Others, including the injection queue, first in first out
+  int count = (int)mQueues.size();
+  for (int i = 1; !found && i < count; ++i)
+  {
+    Queue& victim = *mQueues[(index + i) % count];
+    victim.Locker.Lock();
+    found = !victim.Jobs.empty();
+    if (found)
+    {
+      job = std::move(victim.Jobs.front());
+      victim.Jobs.pop_front();
+    }
+    victim.Locker.UnLock();
+  }
+
+  if (found) mQueued--;
+  return found;
+}
+
+void WorkStealingScheduler::Execute(Job& job)
+{
+  try
+  {
+    job.Run();
+  }
+  catch (std::exception& ex)
+  {
+    LOG(LogError) << "Work-stealing task has raised an error: " << ex.what();
+  }
+
+  // Updated under lock: the group may be destroyed as soon as its waiter sees it complete
+  Group& group = *job.Owner;
+  Mutex::AutoLock locker(group.mLocker);
+  group.mPending--;
+  group.mLocker.Signal();
+}
+
+void WorkStealingScheduler::Wait(Group& group)
+{
+  int index = CurrentQueue();
+  Job job;
+  for(;;)
+  {
+    if (Next(index, job))
+    {
+      Execute(job);
+      continue;
+    }
+
+    // Remaining tasks are running in other threads. Sleep until one of them completes,
+    // as it may have pushed sub-tasks to run meanwhile
+    group.mLocker.Lock();
+    bool completed = (group.mPending == 0);
+    group.mLocker.UnLock();
+    if (completed) break;
+    group.mLocker.WaitSignal(10); // Timeout guards against completions signaled before waiting
+  }
+}
+
+void WorkStealingScheduler::Worker::Run()
+{
+  sCurrentScheduler = &mParent;
+  sCurrentQueue = mIndex;
+
+  Job job;
+  while (IsRunning())
+  {
+    if (mParent.Next(mIndex, job)) Execute(job);
+    else mParent.mIdleSignal.WaitSignal(10); // Timeout guards against lost signals
+  }
+}
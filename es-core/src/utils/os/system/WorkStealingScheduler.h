@@ -0,0 +1,153 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <functional>
+#include "Thread.h"
+#include "Mutex.h"
+
+/*!
+ * @brief Work-stealing task scheduler
+ *
+ * Each worker owns a task queue: it pushes and pops its own tasks at the back (depth first, cache friendly)
+ * and, once empty, steals the oldest tasks at the front of other queues (biggest remaining subtrees).
+ * Threads that are not workers push into a shared injection queue.
+ *
+ * Tasks are grouped: a thread waiting for a group keeps running pending tasks instead of sleeping,
+ * so tasks may safely push and wait for sub-tasks, and any thread (including ThreadPool workers)
+ * may wait for a group without risking a deadlock. When no task is left to run, the waiting thread
+ * sleeps until a task of the group completes.
+ */
+class WorkStealingScheduler
+{
+  public:
+    //! Task
+    typedef std::function<void()> Task;
+
+    /*!
+     * @brief Group of tasks to wait for
+     */
+    class Group
+    {
+      public:
+        //! Constructor
+        Group() : mPending(0) {}
+
+      private:
+        friend class WorkStealingScheduler;
+        //! Pending tasks
+        std::atomic<int> mPending;
+        //! Completion protection & signal
+        Mutex mLocker;
+    };
+
+    /*!
+     * @brief Constructor. Start workers immediately
+     * @param name Scheduler name, used to name worker threads
+     * @param threadCount Worker count. 0 to use the cpu count
+     */
+    WorkStealingScheduler(const std::string& name, int threadCount);
+
+    /*!
+     * @brief Destructor. Stop all workers. Pending tasks must be waited before
+     */
+    ~WorkStealingScheduler();
+
+    /*!
+     * @brief Push a new task
+     * @param group Group the task belongs to
+     * @param task Task to run
+     */
+    void Push(Group& group, Task&& task);
+
+    /*!
+     * @brief Wait for all tasks of the given group to complete, running pending tasks meanwhile
+     * @param group Group to wait for
+     */
+    void Wait(Group& group);
+
+    /*!
+     * @brief Get the worker count
+     * @return Worker count
+     */
+    int WorkerCount() const { return (int)mWorkers.size(); }
+
+  private:
+    //! Task & its group
+    struct Job
+    {
+      Group* Owner; //!< Owner group
+      Task Run;     //!< Task
+    };
+
+    //! Task queue
+    struct Queue
+    {
+      Mutex Locker;          //!< Queue protection
+      std::deque<Job> Jobs;  //!< Jobs
+    };
+
+    /*!
+     * @brief Worker thread
+     */
+    class Worker : public Thread
+    {
+      public:
+        /*!
+         * @brief Constructor
+         * @param parent Scheduler
+         * @param index Own queue index
+         */
+        Worker(WorkStealingScheduler& parent, int index)
+          : mParent(parent),
+            mIndex(index)
+        {
+        }
+
+      private:
+        //! Scheduler
+        WorkStealingScheduler& mParent;
+        //! Own queue index
+        int mIndex;
+
+        /*
+         * Thread implementation
+         */
+
+        void Run() override;
+    };
+
+    //! Injection queue index, used by non-worker threads
+    static constexpr int sInjectionQueue = 0;
+
+    //! Queues. Index 0 is the injection queue, then one queue per worker
+    std::vector<Queue*> mQueues;
+    //! Workers
+    std::vector<Worker*> mWorkers;
+    //! Idle workers wake up signal
+    Mutex mIdleSignal;
+    //! Queued tasks, all queues included
+    std::atomic<int> mQueued;
+
+    /*!
+     * @brief Get the queue index of the calling thread in this scheduler
+     * @return Queue index
+     */
+    int CurrentQueue() const;
+
+    /*!
+     * @brief Get the next job to run: own queue first, then the injection queue, then steal from others
+     * @param index Own queue index
+     * @param job Job to fill in
+     * @return True if a job has been found
+     */
+    bool Next(int index, Job& job);
+
+    /*!
+     * @brief Run a job and update its group
+     * @param job Job to run
+     */
+    static void Execute(Job& job);
+};
@@ -0,0 +1,61 @@
+#include "Arena.h"
+#include <utils/storage/Common.h>
+#include <utils/Log.h>
+#include <cstdlib>
+
+Arena::Arena(int blockSize)
+  : mCurrent(nullptr),
+    mUsed(0),
+    mBlockSize(blockSize),
+    mAllocated(0),
+    mReserved(0)
+{
+}
+
+void* Arena::Allocate(size_t size)
+{
+  size = (size + sAlignment - 1) & ~(sAlignment - 1);
+  Mutex::AutoLock locker(mLocker);
+
+  if (mCurrent == nullptr || mUsed + size > mCurrent->mSize)
+  {
+    // Oversized allocations get their own block
+    size_t blockSize = size > mBlockSize ? size : mBlockSize;
+    Block* block = (Block*)malloc(sHeaderSize + blockSize);
+    if (block == nullptr) LOG_AND_EXIT("Arena memory allocation failure!");
+    block->mSize = blockSize;
+    // Keep the current block if it still has room
+    if (mCurrent != nullptr && blockSize > mBlockSize)
+    {
+      block->mPrevious = mCurrent->mPrevious;
+      mCurrent->mPrevious = block;
+      mAllocated += size;
+      mReserved += blockSize;
+      return (char*)block + sHeaderSize;
+    }
+    block->mPrevious = mCurrent;
+    mCurrent = block;
+    mUsed = 0;
+    mReserved += blockSize;
+  }
+
+  void* result = (char*)mCurrent + sHeaderSize + mUsed;
+  mUsed += size;
+  mAllocated += size;
+  return result;
+}
+
+void Arena::Clear()
+{
+  Mutex::AutoLock locker(mLocker);
+  for (Block* block = mCurrent; block != nullptr; )
+  {
+    Block* previous = block->mPrevious;
+    free(block);
+    block = previous;
+  }
+  mCurrent = nullptr;
+  mUsed = 0;
+  mAllocated = 0;
+  mReserved = 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <utils/os/system/Mutex.h>
+#include <utils/cplusplus/INoCopy.h>
+
+/*!
+ * @brief Thread-safe bump allocator
+ *
+ * Memory is carved sequentially out of large blocks and is never released individually:
+ * all blocks are freed at once when the arena is cleared or destroyed.
+ * Objects allocated from an arena must not use memory after the arena is destroyed,
+ * but their destructors must still be called if they own other resources.
+ */
+class Arena : private INoCopy
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param blockSize Size of memory blocks
+     */
+    explicit Arena(int blockSize = sDefaultBlockSize);
+
+    /*!
+     * @brief Destructor. Free all blocks
+     */
+    ~Arena() { Clear(); }
+
+    /*!
+     * @brief Allocate memory suitably aligned for any object
+     * @param size Size in bytes
+     * @return Memory pointer
+     */
+    void* Allocate(size_t size);
+
+    /*!
+     * @brief Free all blocks at once
+     */
+    void Clear();
+
+    /*!
+     * @brief Get the total size of allocations
+     * @return Allocated size in bytes
+     */
+    size_t AllocatedSize() const { return mAllocated; }
+
+    /*!
+     * @brief Get the total size of blocks
+     * @return Reserved size in bytes
+     */
+    size_t ReservedSize() const { return mReserved; }
+
+  private:
+    //! Default block size
+    static constexpr int sDefaultBlockSize = 64 << 10; // 64Kb
+    //! Allocation alignment
+    static constexpr size_t sAlignment = alignof(std::max_align_t);
+
+    //! Block header, followed by block memory
+    struct Block
+    {
+      Block* mPrevious; //!< Previous block
+      size_t mSize;     //!< Memory size, header excluded
+    };
+    //! Header size, keeping block memory aligned
+    static constexpr size_t sHeaderSize = (sizeof(Block) + sAlignment - 1) & ~(sAlignment - 1);
+
+    //! Allocation lock, since trees are built by several threads
+    Mutex mLocker;
+    //! Current block
+    Block* mCurrent;
+    //! Used size in the current block
+    size_t mUsed;
+    //! Block size
+    size_t mBlockSize;
+    //! Allocated size
+    size_t mAllocated;
+    //! Reserved size
+    size_t mReserved;
+};
@@ -0,0 +1,45 @@
+#include "StringPool.h"
+
+StringPool::Shard* StringPool::Shards()
+{
+  // Never destroyed, so that interned strings remain valid during static destruction
+  static Shard* sShards = new Shard[sShardCount];
+  return sShards;
+}
+
+const std::string* StringPool::Intern(const std::string& value)
+{
+  if (value.empty()) return nullptr;
+
+  size_t hash = std::hash<std::string>()(value);
+  Shard& shard = Shards()[(hash >> 8) & (sShardCount - 1)];
+
+  Mutex::AutoLock locker(shard.mLocker);
+  auto result = shard.mValues.insert(value);
+  if (result.second) shard.mSize += value.size();
+  return &(*result.first);
+}
+
+int StringPool::Count()
+{
+  int count = 0;
+  Shard* shards = Shards();
+  for (int i = 0; i < sShardCount; ++i)
+  {
+    Mutex::AutoLock locker(shards[i].mLocker);
+    count += (int)shards[i].mValues.size();
+  }
+  return count;
+}
+
+size_t StringPool::Size()
+{
+  size_t size = 0;
+  Shard* shards = Shards();
+  for (int i = 0; i < sShardCount; ++i)
+  {
+    Mutex::AutoLock locker(shards[i].mLocker);
+    size += shards[i].mSize;
+  }
+  return size;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <utils/os/system/Mutex.h>
+
+/*!
+ * @brief Global pool of interned strings
+ *
+ * Each distinct value is stored once, and lives until the application exits.
+ * Interned strings never move, so that their address can be used as a handle:
+ * two handles are equal if and only if their values are equal.
+ * The pool is split into independently locked shards, so that threads loading
+ * gamelists in parallel rarely wait for each other.
+ */
+class StringPool
+{
+  public:
+    /*!
+     * @brief Get the interned copy of the given value
+     * @param value Value to intern
+     * @return Interned string, or null if the value is empty
+     */
+    static const std::string* Intern(const std::string& value);
+
+    /*!
+     * @brief Get the number of interned strings
+     * @return String count
+     */
+    static int Count();
+
+    /*!
+     * @brief Get the total size of interned strings
+     * @return Size in bytes, not including container overhead
+     */
+    static size_t Size();
+
+  private:
+    //! Shard count. Must be a power of 2
+    static constexpr int sShardCount = 16;
+
+    //! Independently locked part of the pool
+    struct Shard
+    {
+      Mutex mLocker;                           //!< Shard lock
+      std::unordered_set<std::string> mValues; //!< Interned values
+      size_t mSize = 0;                        //!< Total size of values
+    };
+
+    /*!
+     * @brief Get shards
+     * @return Shard array
+     */
+    static Shard* Shards();
+};
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <utils/storage/Arena.h>
+#include <utils/os/system/WorkStealingScheduler.h>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+class ArenaTest: public ::testing::Test
+{
+};
+
+TEST_F(ArenaTest, testAlignmentAndBlocks)
+{
+  Arena arena(1024);
+  std::vector<char*> pointers;
+  for (int i = 1; i <= 200; ++i)
+  {
+    char* p = (char*)arena.Allocate((size_t)i);
+    ASSERT_EQ((uintptr_t)p % alignof(std::max_align_t), 0u);
+    memset(p, i, (size_t)i);
+    pointers.push_back(p);
+  }
+  // Nothing has been overwritten
+  for (int i = 1; i <= 200; ++i)
+    for (int j = 0; j < i; ++j)
+      ASSERT_EQ(pointers[i - 1][j], (char)i);
+  ASSERT_GE(arena.ReservedSize(), arena.AllocatedSize());
+
+  // Oversized allocation
+  char* big = (char*)arena.Allocate(10000);
+  memset(big, 0x55, 10000);
+  ASSERT_EQ(pointers[199][199], (char)200);
+
+  arena.Clear();
+  ASSERT_EQ(arena.AllocatedSize(), 0u);
+  ASSERT_EQ(arena.ReservedSize(), 0u);
+}
+
+TEST_F(ArenaTest, testConcurrentAllocations)
+{
+  Arena arena(4096);
+  WorkStealingScheduler scheduler("Test", 4);
+  std::vector<int*> pointers(4000, nullptr);
+  WorkStealingScheduler::Group group;
+  for (int i = 0; i < (int)pointers.size(); ++i)
+    scheduler.Push(group, [&arena, &pointers, i] { pointers[i] = new (arena.Allocate(sizeof(int))) int(i); });
+  scheduler.Wait(group);
+
+  for (int i = 0; i < (int)pointers.size(); ++i)
+    ASSERT_EQ(*pointers[i], i);
+  std::sort(pointers.begin(), pointers.end());
+  ASSERT_TRUE(std::adjacent_find(pointers.begin(), pointers.end()) == pointers.end());
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <games/GamelistSnapshotFile.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+
+static const std::string rootTest = "/tmp/googletests/";
+
+class GamelistSnapshotTest: public ::testing::Test
+{
+  protected:
+    const Path mRomFolder = Path(rootTest) / "roms/snes";
+    const Path mGamelist = mRomFolder / "gamelist.xml";
+    const Path mJournal = mRomFolder / "gamelist.journal";
+    const Path mSnapshot = Path(rootTest) / "snapshots/_roms_snes.snapshot";
+
+    void SetUp() override
+    {
+      ASSERT_EQ(system(("mkdir -p " + mRomFolder.ToString()).c_str()), 0);
+      ASSERT_TRUE(Files::SaveFile(mGamelist, std::string("<gameList/>")));
+      // Invalid snapshots are logged
+      Log::open((rootTest + "es_log.txt").c_str());
+    }
+
+    void TearDown() override
+    {
+      Log::close();
+      ASSERT_EQ(system("rm -rf /tmp/googletests"), 0);
+    }
+
+    GamelistSnapshotFile::Fingerprint Current(unsigned int configuration = 1) const
+    {
+      return GamelistSnapshotFile::BuildFingerprint(mGamelist, mJournal, mRomFolder, 0, configuration);
+    }
+
+    //! Build a root folder holding a folder holding a game
+    static void BuildRecords(std::string& records, std::string& pool)
+    {
+      GamelistSnapshotFile::Record folder = {};
+      folder.Parent = -1;
+      folder.Type = ItemType::Folder;
+      folder.Strings[(int)GamelistSnapshotFile::Texts::Path] = GamelistSnapshotFile::Store(pool, "rpg");
+      folder.Strings[(int)GamelistSnapshotFile::Texts::Name] = GamelistSnapshotFile::Store(pool, "RPG");
+      records.append((const char*)&folder, sizeof(folder));
+
+      GamelistSnapshotFile::Record game = {};
+      game.Parent = 0;
+      game.Type = ItemType::Game;
+      game.Flags = GamelistSnapshotFile::FlagFavorite;
+      game.Playcount = 42;
+      game.Strings[(int)GamelistSnapshotFile::Texts::Path] = GamelistSnapshotFile::Store(pool, "rpg/Chrono Trigger (USA).sfc");
+      game.Strings[(int)GamelistSnapshotFile::Texts::Name] = GamelistSnapshotFile::Store(pool, "Chrono Trigger");
+      game.Strings[(int)GamelistSnapshotFile::Texts::Developer] = GamelistSnapshotFile::Store(pool, "Square");
+      records.append((const char*)&game, sizeof(game));
+    }
+};
+
+TEST_F(GamelistSnapshotTest, testSaveLoad)
+{
+  std::string records;
+  std::string pool;
+  BuildRecords(records, pool);
+
+  GamelistSnapshotFile file(mSnapshot);
+  ASSERT_FALSE(file.IsUpToDate(Current()));
+  ASSERT_FALSE(file.Map(Current()));
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+  ASSERT_TRUE(file.IsUpToDate(Current()));
+  ASSERT_FALSE(Path(mSnapshot.ToString() + ".tmp").Exists());
+
+  ASSERT_TRUE(file.Map(Current()));
+  ASSERT_EQ(file.RecordCount(), 2);
+  ASSERT_EQ(file.PoolSize(), (unsigned int)pool.size());
+
+  const GamelistSnapshotFile::Record& folder = file.Records()[0];
+  ASSERT_EQ(folder.Parent, -1);
+  ASSERT_EQ(folder.Type, ItemType::Folder);
+  ASSERT_EQ(file.String(folder, GamelistSnapshotFile::Texts::Path), "rpg");
+  ASSERT_EQ(file.String(folder, GamelistSnapshotFile::Texts::Name), "RPG");
+
+  const GamelistSnapshotFile::Record& game = file.Records()[1];
+  ASSERT_EQ(game.Parent, 0);
+  ASSERT_EQ(game.Type, ItemType::Game);
+  ASSERT_EQ(game.Flags, GamelistSnapshotFile::FlagFavorite);
+  ASSERT_EQ(game.Playcount, 42);
+  ASSERT_EQ(file.String(game, GamelistSnapshotFile::Texts::Path), "rpg/Chrono Trigger (USA).sfc");
+  ASSERT_EQ(file.String(game, GamelistSnapshotFile::Texts::Name), "Chrono Trigger");
+  ASSERT_EQ(file.String(game, GamelistSnapshotFile::Texts::Developer), "Square");
+  ASSERT_EQ(file.String(game, GamelistSnapshotFile::Texts::Description), "");
+
+  file.Unmap();
+  ASSERT_EQ(file.RecordCount(), 0);
+  ASSERT_EQ(file.Records(), nullptr);
+}
+
+TEST_F(GamelistSnapshotTest, testStaleInvalidation)
+{
+  std::string records;
+  std::string pool;
+  BuildRecords(records, pool);
+
+  GamelistSnapshotFile file(mSnapshot);
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+
+  // Configuration change
+  ASSERT_FALSE(file.IsUpToDate(Current(2)));
+  ASSERT_FALSE(file.Map(Current(2)));
+
+  // Journaled metadata change
+  ASSERT_TRUE(Files::SaveFile(mJournal, std::string("<game/>")));
+  ASSERT_FALSE(file.IsUpToDate(Current()));
+  ASSERT_FALSE(file.Map(Current()));
+
+  // Saving again with the new state makes it valid again
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+  ASSERT_TRUE(file.Map(Current()));
+  file.Unmap();
+
+  // Gamelist rewrite
+  ASSERT_TRUE(Files::SaveFile(mGamelist, std::string("<gameList></gameList>")));
+  ASSERT_FALSE(file.IsUpToDate(Current()));
+  ASSERT_FALSE(file.Map(Current()));
+
+  // Rom folder change
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+  ASSERT_TRUE(file.IsUpToDate(Current()));
+  ASSERT_EQ(system(("mkdir " + (mRomFolder / "new").ToString()).c_str()), 0);
+  ASSERT_FALSE(file.IsUpToDate(Current()));
+}
+
+TEST_F(GamelistSnapshotTest, testCorruptedFile)
+{
+  std::string records;
+  std::string pool;
+  BuildRecords(records, pool);
+
+  GamelistSnapshotFile file(mSnapshot);
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+
+  // Truncated
+  std::string content = Files::LoadFile(mSnapshot);
+  ASSERT_TRUE(Files::SaveFile(mSnapshot, content.substr(0, content.size() - 1)));
+  ASSERT_FALSE(file.Map(Current()));
+
+  // String outside the pool
+  GamelistSnapshotFile::Record& game = *(GamelistSnapshotFile::Record*)&records[sizeof(GamelistSnapshotFile::Record)];
+  game.Strings[(int)GamelistSnapshotFile::Texts::Name].Offset = (unsigned int)pool.size();
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+  ASSERT_TRUE(file.IsUpToDate(Current()));
+  ASSERT_FALSE(file.Map(Current()));
+
+  // Parent after child
+  game.Strings[(int)GamelistSnapshotFile::Texts::Name].Offset = 0;
+  game.Parent = 1;
+  ASSERT_TRUE(file.Save(Current(), records, pool));
+  ASSERT_FALSE(file.Map(Current()));
+}
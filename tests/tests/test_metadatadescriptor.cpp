@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <games/MetadataDescriptor.h>
+#include <games/MetadataFieldDescriptor.h>
+#include <chrono>
+
+class MetadataDescriptorTest: public ::testing::Test
+{
+  protected:
+    //! Root folder all paths are relative to
+    static const Path sRoot;
+
+    //! Sample non-default value for the given field
+    static std::string Sample(const MetadataFieldDescriptor& field)
+    {
+      switch(field.Type())
+      {
+        case MetadataFieldDescriptor::DataType::String:
+        case MetadataFieldDescriptor::DataType::Text: return "Super Sample Bros";
+        case MetadataFieldDescriptor::DataType::PString:
+        case MetadataFieldDescriptor::DataType::PList: return field.Key() + "-sample";
+        case MetadataFieldDescriptor::DataType::Path:
+        case MetadataFieldDescriptor::DataType::PPath: return (sRoot / "media" / (field.Key() + ".png")).ToString();
+        case MetadataFieldDescriptor::DataType::Int: return field.Key() == "region" ? "eu,us" : "3";
+        case MetadataFieldDescriptor::DataType::Bool: return "true";
+        case MetadataFieldDescriptor::DataType::Float:
+        case MetadataFieldDescriptor::DataType::Rating: return "0.5";
+        case MetadataFieldDescriptor::DataType::Date: return "20200102T030405";
+        case MetadataFieldDescriptor::DataType::Range: return "2-4";
+        case MetadataFieldDescriptor::DataType::Crc32: return "1234ABCD";
+        default: break;
+      }
+      return std::string();
+    }
+
+    //! Build metadata with all fields set to non-default values
+    static MetadataDescriptor Build(ItemType type)
+    {
+      MetadataDescriptor metadata("default", type);
+      int count = 0;
+      const MetadataFieldDescriptor* fields = metadata.GetMetadataFieldDescriptors(count);
+      for (int i = 0; i < count; ++i)
+        (metadata.*(fields[i].SetValueMethod()))(Sample(fields[i]));
+      return metadata;
+    }
+
+    //! Check all fields are written in descriptor order, and read back unchanged
+    static void CheckRoundTrip(ItemType type)
+    {
+      MetadataDescriptor metadata = Build(type);
+      XmlDocument document;
+      metadata.Serialize(document, sRoot / "game.zip", sRoot);
+      XmlNode node = document.first_child();
+
+      int count = 0;
+      const MetadataFieldDescriptor* fields = metadata.GetMetadataFieldDescriptors(count);
+      // Path first, then fields in reverse order
+      std::vector<std::string> keys;
+      for (const XmlNode child : node.children()) keys.push_back(child.name());
+      ASSERT_EQ((int)keys.size(), count + 1);
+      ASSERT_EQ(keys[0], "path");
+      for (int i = 0; i < count; ++i)
+        ASSERT_EQ(keys[count - i], fields[i].Key());
+
+      MetadataDescriptor read("default", ItemType::Empty);
+      ASSERT_TRUE(read.Deserialize(node, sRoot));
+      for (int i = 0; i < count; ++i)
+        ASSERT_EQ((read.*(fields[i].GetValueMethod()))(), (metadata.*(fields[i].GetValueMethod()))()) << fields[i].Key();
+    }
+};
+
+const Path MetadataDescriptorTest::sRoot("/recalbox/share/roms/snes");
+
+TEST_F(MetadataDescriptorTest, testFieldTableMatchesDescriptors)
+{
+  ASSERT_TRUE(MetadataDescriptor::FieldTableMatchesDescriptors(ItemType::Game));
+  ASSERT_TRUE(MetadataDescriptor::FieldTableMatchesDescriptors(ItemType::Folder));
+}
+
+TEST_F(MetadataDescriptorTest, testGameRoundTrip)
+{
+  CheckRoundTrip(ItemType::Game);
+}
+
+TEST_F(MetadataDescriptorTest, testFolderRoundTrip)
+{
+  CheckRoundTrip(ItemType::Folder);
+}
+
+TEST_F(MetadataDescriptorTest, testDefaultsAreNotWritten)
+{
+  MetadataDescriptor metadata("default", ItemType::Game);
+  XmlDocument document;
+  metadata.Serialize(document, sRoot / "game.zip", sRoot);
+  // Name is never default once set from the file name
+  ASSERT_EQ(std::distance(document.first_child().children().begin(), document.first_child().children().end()), 2);
+}
+
+TEST_F(MetadataDescriptorTest, DISABLED_benchmarkSerialization)
+{
+  // 20k scraped-like game nodes
+  static constexpr int sGames = 20000;
+  static constexpr int sPasses = 10;
+  MetadataDescriptor metadata = Build(ItemType::Game);
+  XmlDocument source;
+  XmlNode list = source.append_child("gameList");
+  for (int i = sGames; --i >= 0; )
+    metadata.Serialize(list, sRoot / ("game" + std::to_string(i) + ".zip"), sRoot);
+
+  long long bestRead = -1;
+  long long bestWrite = -1;
+  for (int pass = sPasses; --pass >= 0; )
+  {
+    std::vector<MetadataDescriptor> games;
+    games.reserve(sGames);
+    auto start = std::chrono::steady_clock::now();
+    for (const XmlNode node : list.children())
+    {
+      games.emplace_back("default", ItemType::Empty);
+      games.back().Deserialize(node, sRoot);
+    }
+    auto read = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    XmlDocument target;
+    XmlNode output = target.append_child("gameList");
+    start = std::chrono::steady_clock::now();
+    for (const MetadataDescriptor& game : games)
+      game.Serialize(output, sRoot / "game.zip", sRoot);
+    auto write = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if (bestRead < 0 || read < bestRead) bestRead = read;
+    if (bestWrite < 0 || write < bestWrite) bestWrite = write;
+  }
+  printf("[ DESERIALIZE ] %lld ns/node\n", bestRead / sGames);
+  printf("[   SERIALIZE ] %lld ns/node\n", bestWrite / sGames);
+}
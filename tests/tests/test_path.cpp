@@ -726,6 +726,35 @@ TEST_F(PathTest, testGetDirectoryContent)
   ASSERT_EQ(list[1].ToString(), TestSet.Folder1.Folder2.name);
 }
 
+TEST_F(PathTest, testGetDirectoryEntries)
+{
+  // Not an existing dir
+  ASSERT_EQ(Path("/path/to/file").GetDirectoryEntries().size(), 0u);
+  // Existing file
+  ASSERT_EQ(Path(TestSet.Folder1.file1).GetDirectoryEntries().size(), 0u);
+  // Existing folder: file2, folder3 & folder4 -> folder1
+  Path::DirectoryEntryList list = Path(TestSet.Folder1.Folder2.name).GetDirectoryEntries();
+  std::sort(list.begin(), list.end(), [](const Path::DirectoryEntry& a, const Path::DirectoryEntry& b) { return a.Name < b.Name; });
+  ASSERT_EQ(list.size(), 3u);
+  ASSERT_EQ(list[0].Name, "file2");
+  ASSERT_TRUE(list[0].IsFile());
+  ASSERT_FALSE(list[0].SymLink);
+  ASSERT_EQ(list[1].Name, "folder3");
+  ASSERT_TRUE(list[1].IsDirectory());
+  ASSERT_FALSE(list[1].SymLink);
+  ASSERT_EQ(list[2].Name, "folder4");
+  ASSERT_TRUE(list[2].IsDirectory());
+  ASSERT_TRUE(list[2].SymLink);
+  ASSERT_FALSE(list[2].IsHidden());
+  // Symlink to file
+  list = Path(TestSet.Folder1.Folder2.Folder3.name).GetDirectoryEntries();
+  std::sort(list.begin(), list.end(), [](const Path::DirectoryEntry& a, const Path::DirectoryEntry& b) { return a.Name < b.Name; });
+  ASSERT_EQ(list.size(), 2u);
+  ASSERT_EQ(list[1].Name, "file4");
+  ASSERT_TRUE(list[1].IsFile());
+  ASSERT_TRUE(list[1].SymLink);
+}
+
 TEST_F(PathTest, testMakeRelative)
 {
   bool ok;
@@ -759,4 +788,11 @@ TEST_F(PathTest, testFileSize)
   ASSERT_EQ(Path("/path/to/file").Size(), 0);
   ASSERT_EQ(Path(TestSet.Folder1.Folder2.Folder3.file3).Size(), 5); // text + \n
   ASSERT_NE(Path(TestSet.Folder1.Folder2.Folder3.name).Size(), 0);
+}
+
+TEST_F(PathTest, testLastModificationTime)
+{
+  ASSERT_EQ(Path("/path/to/file").LastModificationTime(), 0);
+  ASSERT_NE(Path(TestSet.Folder1.Folder2.Folder3.file3).LastModificationTime(), 0);
+  ASSERT_NE(Path(TestSet.Folder1.Folder2.Folder3.name).LastModificationTime(), 0);
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <games/ScanManifest.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+
+static const std::string rootTest = "/tmp/googletests/";
+
+class ScanManifestTest: public ::testing::Test
+{
+  protected:
+    const Path mRoot = Path("/recalbox/share/roms/snes");
+    const Path mFolder = Path(rootTest) / "manifests";
+    const Path mManifest = mFolder / "_recalbox_share_roms_snes.manifest";
+    const std::string mExtensions = ".sfc .smc .zip";
+
+    void SetUp() override
+    {
+      ASSERT_EQ(system(("mkdir -p " + rootTest).c_str()), 0);
+      // Corrupted manifests are logged
+      Log::open((rootTest + "es_log.txt").c_str());
+    }
+
+    void TearDown() override
+    {
+      Log::close();
+      ASSERT_EQ(system("rm -rf /tmp/googletests"), 0);
+    }
+
+    //! Scan result of the root folder
+    ScanManifest::Folder RootResult() const
+    {
+      ScanManifest::Folder result;
+      result.Time = 1234567890123456789LL;
+      result.Extensions = ScanManifest::Folder::HashExtensions(mExtensions);
+      result.EntryCount = 4;
+      result.Games = { "Chrono Trigger (USA).sfc", "Super Metroid (USA).sfc" };
+      result.SubFolders = { "rpg", "hacks" };
+      result.SymLinks = { "hacks" };
+      return result;
+    }
+
+    //! Scan result of a sub-folder
+    ScanManifest::Folder SubFolderResult() const
+    {
+      ScanManifest::Folder result;
+      result.Time = 42;
+      result.Extensions = ScanManifest::Folder::HashExtensions(".sfc");
+      result.EntryCount = 2;
+      result.Games = { "Secret of Mana (USA).sfc" };
+      result.SystemConfig = true;
+      return result;
+    }
+
+    //! Save a manifest holding the root folder and a sub-folder
+    void SaveManifest() const
+    {
+      ScanManifest manifest(mRoot, mFolder);
+      ASSERT_FALSE(manifest.Load());
+      manifest.Store(mRoot, RootResult(), true);
+      manifest.Store(mRoot / "rpg", SubFolderResult(), true);
+      ASSERT_TRUE(manifest.Save());
+      ASSERT_TRUE(mManifest.Exists());
+      ASSERT_FALSE(Path(mManifest.ToString() + ".tmp").Exists());
+    }
+};
+
+TEST_F(ScanManifestTest, testSaveLoadLookup)
+{
+  SaveManifest();
+
+  ScanManifest manifest(mRoot, mFolder);
+  ASSERT_TRUE(manifest.Load());
+  ASSERT_NE(manifest.FileTime(), 0);
+
+  ScanManifest::Folder expected = RootResult();
+  const ScanManifest::Folder* root = manifest.Lookup(mRoot, expected.Time);
+  ASSERT_NE(root, nullptr);
+  ASSERT_EQ(root->Time, expected.Time);
+  ASSERT_EQ(root->Extensions, expected.Extensions);
+  ASSERT_EQ(root->EntryCount, 4);
+  ASSERT_EQ(root->Games, expected.Games);
+  ASSERT_EQ(root->SubFolders, expected.SubFolders);
+  ASSERT_EQ(root->SymLinks, expected.SymLinks);
+  ASSERT_FALSE(root->SystemConfig);
+
+  const ScanManifest::Folder* rpg = manifest.Lookup(mRoot / "rpg", 42);
+  ASSERT_NE(rpg, nullptr);
+  ASSERT_EQ(rpg->Games.size(), 1u);
+  ASSERT_EQ(rpg->Games[0], "Secret of Mana (USA).sfc");
+  ASSERT_TRUE(rpg->SubFolders.empty());
+  ASSERT_TRUE(rpg->SystemConfig);
+
+  // Modified or unknown directories must be scanned again
+  ASSERT_EQ(manifest.Lookup(mRoot, expected.Time + 1), nullptr);
+  ASSERT_EQ(manifest.Lookup(mRoot / "hacks", 0), nullptr);
+  // Whatever their time
+  ASSERT_EQ(manifest.Previous(mRoot), manifest.Lookup(mRoot, expected.Time));
+  ASSERT_EQ(manifest.Previous(mRoot / "hacks"), nullptr);
+}
+
+TEST_F(ScanManifestTest, testSaveOnlyWhenChanged)
+{
+  SaveManifest();
+  ScanManifest manifest(mRoot, mFolder);
+  ASSERT_TRUE(manifest.Load());
+  ASSERT_TRUE(mManifest.Delete());
+
+  // Same folders, all taken from the previous manifest: nothing to write
+  manifest.Store(mRoot, *manifest.Previous(mRoot), false);
+  manifest.Store(mRoot / "rpg", *manifest.Previous(mRoot / "rpg"), false);
+  ASSERT_TRUE(manifest.Save());
+  ASSERT_FALSE(mManifest.Exists());
+}
+
+TEST_F(ScanManifestTest, testRemovedFolder)
+{
+  SaveManifest();
+  ScanManifest manifest(mRoot, mFolder);
+  ASSERT_TRUE(manifest.Load());
+
+  // rpg is gone: only the root is stored
+  manifest.Store(mRoot, *manifest.Previous(mRoot), false);
+  ASSERT_TRUE(manifest.Save());
+
+  ScanManifest reloaded(mRoot, mFolder);
+  ASSERT_TRUE(reloaded.Load());
+  ASSERT_NE(reloaded.Previous(mRoot), nullptr);
+  ASSERT_EQ(reloaded.Previous(mRoot / "rpg"), nullptr);
+}
+
+TEST_F(ScanManifestTest, testVersionMismatch)
+{
+  SaveManifest();
+
+  // Patch the version, right after the magic
+  std::string content = Files::LoadFile(mManifest);
+  ASSERT_GT(content.size(), 8u);
+  content[4] = (char)(content[4] + 1);
+  ASSERT_TRUE(Files::SaveFile(mManifest, content));
+
+  ScanManifest manifest(mRoot, mFolder);
+  ASSERT_FALSE(manifest.Load());
+  ASSERT_EQ(manifest.Lookup(mRoot, RootResult().Time), nullptr);
+  ASSERT_EQ(manifest.Previous(mRoot / "rpg"), nullptr);
+}
+
+TEST_F(ScanManifestTest, testCorruptedManifest)
+{
+  SaveManifest();
+
+  std::string content = Files::LoadFile(mManifest);
+  ASSERT_TRUE(Files::SaveFile(mManifest, content.substr(0, content.size() - 1)));
+
+  // No partial result
+  ScanManifest manifest(mRoot, mFolder);
+  ASSERT_FALSE(manifest.Load());
+  ASSERT_EQ(manifest.Previous(mRoot), nullptr);
+  ASSERT_EQ(manifest.Previous(mRoot / "rpg"), nullptr);
+}
+
+TEST_F(ScanManifestTest, testExtensionsInvalidation)
+{
+  SaveManifest();
+
+  ScanManifest manifest(mRoot, mFolder);
+  ASSERT_TRUE(manifest.Load());
+  const ScanManifest::Folder* root = manifest.Lookup(mRoot, RootResult().Time);
+  ASSERT_NE(root, nullptr);
+  ASSERT_TRUE(root->MatchExtensions(mExtensions));
+  ASSERT_FALSE(root->MatchExtensions(".sfc .smc"));
+  ASSERT_FALSE(root->MatchExtensions(".sfc .smc .zip .7z"));
+  ASSERT_FALSE(root->MatchExtensions(""));
+
+  // Sub-folders overriding extensions are checked against their own filter
+  const ScanManifest::Folder* rpg = manifest.Lookup(mRoot / "rpg", 42);
+  ASSERT_NE(rpg, nullptr);
+  ASSERT_TRUE(rpg->MatchExtensions(".sfc"));
+  ASSERT_FALSE(rpg->MatchExtensions(mExtensions));
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include <utils/storage/StringPool.h>
+#include <utils/os/system/WorkStealingScheduler.h>
+
+class StringPoolTest: public ::testing::Test
+{
+};
+
+TEST_F(StringPoolTest, testIntern)
+{
+  ASSERT_EQ(StringPool::Intern(""), nullptr);
+
+  const std::string* capcom = StringPool::Intern("Capcom");
+  ASSERT_NE(capcom, nullptr);
+  ASSERT_EQ(*capcom, "Capcom");
+  ASSERT_EQ(StringPool::Intern(std::string("Cap") + "com"), capcom);
+  ASSERT_NE(StringPool::Intern("Konami"), capcom);
+  ASSERT_NE(StringPool::Intern("capcom"), capcom);
+}
+
+TEST_F(StringPoolTest, testConcurrentIntern)
+{
+  int count = StringPool::Count();
+  WorkStealingScheduler scheduler("Test", 4);
+  std::vector<const std::string*> handles(4000, nullptr);
+  WorkStealingScheduler::Group group;
+  for (int i = 0; i < (int)handles.size(); ++i)
+    scheduler.Push(group, [&handles, i] { handles[i] = StringPool::Intern("Publisher #" + std::to_string(i % 100)); });
+  scheduler.Wait(group);
+
+  for (int i = 0; i < (int)handles.size(); ++i)
+    ASSERT_EQ(handles[i], handles[i % 100]);
+  ASSERT_EQ(StringPool::Count(), count + 100);
+}
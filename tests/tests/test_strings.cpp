@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <utils/Strings.h>
+#include <vector>
+
+class StringsTest: public ::testing::Test
+{
+};
+
+TEST_F(StringsTest, testSearchKeyAscii)
+{
+  ASSERT_EQ(Strings::ToSearchKey(""), "");
+  ASSERT_EQ(Strings::ToSearchKey("Street Fighter II'"), "street fighter ii'");
+  ASSERT_EQ(Strings::ToSearchKey("[1989] @Z_09"), "[1989] @z_09");
+}
+
+TEST_F(StringsTest, testSearchKeyDiacritics)
+{
+  ASSERT_EQ(Strings::ToSearchKey("Pok\xC3\xA9mon"), "pokemon");                 // Pokémon
+  ASSERT_EQ(Strings::ToSearchKey("\xC3\x89LITE \xC3\x86ON"), "elite aeon");     // ÉLITE ÆON
+  ASSERT_EQ(Strings::ToSearchKey("Stra\xC3\x9F" "e"), "strasse");               // Straße
+  ASSERT_EQ(Strings::ToSearchKey("\xC5\x81\xC3\xB3" "d\xC5\xBA"), "lodz");      // Łódź
+  ASSERT_EQ(Strings::ToSearchKey("Poke\xCC\x81mon"), "pokemon");                // Decomposed Pokémon
+  ASSERT_EQ(Strings::ToSearchKey("1 \xC3\x97 2"), "1 \xC3\x97 2");              // × is kept
+}
+
+TEST_F(StringsTest, testSearchKeyOtherScripts)
+{
+  ASSERT_EQ(Strings::ToSearchKey("\xD0\xA2\xD0\x95\xD0\xA2\xD0\xA0\xD0\x98\xD0\xA1"), "\xD1\x82\xD0\xB5\xD1\x82\xD1\x80\xD0\xB8\xD1\x81"); // ТЕТРИС
+  ASSERT_EQ(Strings::ToSearchKey("\xE3\x83\x9D\xE3\x82\xB1\xE3\x83\xA2\xE3\x83\xB3"), "\xE3\x83\x9D\xE3\x82\xB1\xE3\x83\xA2\xE3\x83\xB3"); // ポケモン
+  ASSERT_EQ(Strings::ToSearchKey("abc\xC3"), "abc"); // Truncated sequence
+}
+
+TEST_F(StringsTest, testSortKey)
+{
+  ASSERT_EQ(Strings::ToSortKey("Street Fighter II'"), "STREET FIGHTER II'");
+  ASSERT_EQ(Strings::ToSortKey("Pok\xC3\xA9mon"), "POK\xC3\x89MON"); // Pokémon => POKÉMON
+
+  // Byte order of keys must be the order of uppercase code points
+  static const char* sNames[] =
+  {
+    "abc", "ABD", "ab", "Ab c", "\xC3\xA9t\xC3\xA9", "\xC3\x89T\xC3\x89", "zz", "\xD0\xB0\xD0\xB1", "\xE3\x83\x9D", "\xF0\x9F\x8E\xAE", "a~", "a[", "",
+  };
+  for (const char* a : sNames)
+    for (const char* b : sNames)
+    {
+      std::vector<unsigned int> ua, ub;
+      for (unsigned int u : Strings::Utf8ToUnicode(a)) ua.push_back(Strings::UpperChar(u));
+      for (unsigned int u : Strings::Utf8ToUnicode(b)) ub.push_back(Strings::UpperChar(u));
+      int expected = ua < ub ? -1 : (ub < ua ? 1 : 0);
+      int result = Strings::ToSortKey(a).compare(Strings::ToSortKey(b));
+      ASSERT_EQ(result < 0 ? -1 : (result > 0 ? 1 : 0), expected) << a << " / " << b;
+    }
+}
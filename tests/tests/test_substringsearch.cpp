@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <utils/SubstringSearch.h>
+#include <chrono>
+#include <random>
+
+class SubstringSearchTest: public ::testing::Test
+{
+  protected:
+    static const SubstringSearch::Variant sVariants[4];
+
+    //! Reference implementation
+    static int Reference(const std::string& text, const std::string& into, bool caseFold)
+    {
+      for (int i = 0; i + (int)text.size() <= (int)into.size(); ++i)
+      {
+        int j = 0;
+        for (; j < (int)text.size(); ++j)
+          if ((unsigned char)(into[i + j] | (caseFold ? 0x20 : 0)) != (unsigned char)text[j]) break;
+        if (j == (int)text.size()) return i;
+      }
+      return -1;
+    }
+
+    //! Build a random game title
+    static std::string Title(std::mt19937& random)
+    {
+      static const char* sWords[] =
+      {
+        "Super", "Mario", "World", "Street", "Fighter", "Sonic", "Hedgehog", "Legend", "Zelda", "Metal",
+        "Slug", "Final", "Fantasy", "Castlevania", "Bomberman", "Kart", "Turbo", "Championship", "Edition", "Pok\xC3\xA9mon",
+        "Tetris", "Puzzle", "Bobble", "Dragon", "Quest", "Contra", "Ninja", "Gaiden", "Galaxy", "Racing",
+      };
+      std::string title;
+      for (int words = 2 + (int)(random() % 5); --words >= 0; )
+      {
+        if (!title.empty()) title += ' ';
+        title += sWords[random() % (sizeof(sWords) / sizeof(sWords[0]))];
+      }
+      if (random() % 3 == 0) title.append(" (USA, Europe) [!]");
+      return title;
+    }
+
+    //! Search a few queries in the corpus with all available variants, and print timings
+    static void Benchmark(const std::vector<std::string>& corpus, int passes)
+    {
+      static const char* sQueries[] = { "zelda", "street fighter", "(usa", "mega man", "qqq" };
+
+      printf("[ SELECTED ] %s\n", SubstringSearch::Name(SubstringSearch::Selected()));
+      int reference = -1;
+      for (SubstringSearch::Variant variant : sVariants)
+      {
+        if (!SubstringSearch::IsAvailable(variant)) continue;
+        int found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = passes; --pass >= 0; )
+          for (const char* query : sQueries)
+          {
+            std::string text(query);
+            for (const std::string& into : corpus)
+              if (SubstringSearch::Find(variant, text, into, true) >= 0) found++;
+          }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        printf("[ %8s ] %d matches in %lld us\n", SubstringSearch::Name(variant), found, (long long)elapsed);
+
+        if (reference < 0) reference = found;
+        ASSERT_EQ(found, reference);
+      }
+    }
+};
+
+const SubstringSearch::Variant SubstringSearchTest::sVariants[4] =
+{
+  SubstringSearch::Variant::Scalar,
+  SubstringSearch::Variant::SSE2,
+  SubstringSearch::Variant::AVX2,
+  SubstringSearch::Variant::Neon,
+};
+
+TEST_F(SubstringSearchTest, testFind)
+{
+  for (SubstringSearch::Variant variant : sVariants)
+  {
+    if (!SubstringSearch::IsAvailable(variant)) continue;
+    SCOPED_TRACE(SubstringSearch::Name(variant));
+    ASSERT_EQ(SubstringSearch::Find(variant, "abc", "abc", true), 0);
+    ASSERT_EQ(SubstringSearch::Find(variant, "bc", "abc", true), 1);
+    ASSERT_EQ(SubstringSearch::Find(variant, "mario", "Super MARIO Bros", true), 6);
+    ASSERT_EQ(SubstringSearch::Find(variant, "mario", "Super MARIO Bros", false), -1);
+    ASSERT_EQ(SubstringSearch::Find(variant, "x", "Super Mario Bros", true), -1);
+    ASSERT_EQ(SubstringSearch::Find(variant, "bros!", "Super Mario Bros", true), -1);
+    ASSERT_EQ(SubstringSearch::Find(variant, "", "Super Mario Bros", true), 0);
+    // Match on the last bytes, after a full vector
+    std::string into(100, '-');
+    ASSERT_EQ(SubstringSearch::Find(variant, "zelda", into + "ZELDA", true), 100);
+    ASSERT_EQ(SubstringSearch::Find(variant, "zelda", into + "ZELD", true), -1);
+  }
+}
+
+TEST_F(SubstringSearchTest, testFindRandom)
+{
+  std::mt19937 random(1234);
+  for (int i = 0; i < 20000; ++i)
+  {
+    // Small alphabet, so that partial matches are frequent
+    std::string into;
+    for (int l = (int)(random() % 80); --l >= 0; ) into += (char)("aAbB-"[random() % 5]);
+    std::string text;
+    for (int l = 1 + (int)(random() % 6); --l >= 0; ) text += (char)("ab-"[random() % 3]);
+    bool caseFold = (i & 1) != 0;
+
+    int expected = Reference(text, into, caseFold);
+    for (SubstringSearch::Variant variant : sVariants)
+      if (SubstringSearch::IsAvailable(variant))
+      {
+        ASSERT_EQ(SubstringSearch::Find(variant, text, into, caseFold), expected) << SubstringSearch::Name(variant) << " '" << text << "' in '" << into << "'";
+      }
+  }
+}
+
+TEST_F(SubstringSearchTest, DISABLED_benchmarkTitles)
+{
+  // Synthetic corpus of 100k titles
+  std::mt19937 random(42);
+  std::vector<std::string> titles;
+  titles.reserve(100000);
+  for (int i = 100000; --i >= 0; ) titles.push_back(Title(random));
+  Benchmark(titles, 10);
+}
+
+TEST_F(SubstringSearchTest, DISABLED_benchmarkDescriptions)
+{
+  // Synthetic corpus of 10k descriptions, as searched in 'All' context
+  std::mt19937 random(42);
+  std::vector<std::string> descriptions;
+  descriptions.reserve(10000);
+  for (int i = 10000; --i >= 0; )
+  {
+    std::string description;
+    while (description.size() < 600) description.append(Title(random)).append(". ");
+    descriptions.push_back(description);
+  }
+  Benchmark(descriptions, 10);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <utils/os/system/WorkStealingScheduler.h>
+
+class WorkStealingSchedulerTest: public ::testing::Test
+{
+  protected:
+    //! Recursively split a range in sub-tasks, down to single items
+    static void Split(WorkStealingScheduler& scheduler, int from, int to, std::vector<int>& result)
+    {
+      if (to - from <= 1)
+      {
+        if (to > from) result[from] = from * 2;
+        return;
+      }
+      int middle = (from + to) / 2;
+      WorkStealingScheduler::Group group;
+      scheduler.Push(group, [&scheduler, from, middle, &result] { Split(scheduler, from, middle, result); });
+      Split(scheduler, middle, to, result);
+      scheduler.Wait(group);
+    }
+};
+
+TEST_F(WorkStealingSchedulerTest, testFlatTasks)
+{
+  WorkStealingScheduler scheduler("Test", 4);
+  ASSERT_EQ(scheduler.WorkerCount(), 4);
+
+  std::atomic<int> total(0);
+  WorkStealingScheduler::Group group;
+  for (int i = 1; i <= 1000; ++i)
+    scheduler.Push(group, [&total, i] { total += i; });
+  scheduler.Wait(group);
+  ASSERT_EQ(total, 500500);
+}
+
+TEST_F(WorkStealingSchedulerTest, testNestedTasks)
+{
+  WorkStealingScheduler scheduler("Test", 3);
+  std::vector<int> result(10000, -1);
+  Split(scheduler, 0, (int)result.size(), result);
+  for (int i = (int)result.size(); --i >= 0; )
+    ASSERT_EQ(result[i], i * 2);
+}
+
+TEST_F(WorkStealingSchedulerTest, testEmptyGroup)
+{
+  WorkStealingScheduler scheduler("Test", 1);
+  WorkStealingScheduler::Group group;
+  scheduler.Wait(group);
+  SUCCEED();
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <utils/XmlStream.h>
+
+class XmlStreamTest: public ::testing::Test, public XmlStream::IReceiver
+{
+  protected:
+    //! Received paths, in document order
+    std::vector<std::string> mPaths;
+    //! Received batches
+    int mBatches = 0;
+
+    bool ReceiveElements(XmlNode elements) override
+    {
+      mBatches++;
+      for (const XmlNode node : elements.children())
+        mPaths.push_back(std::string(node.name()) + ':' + Xml::AsString(node, "path", ""));
+      return true;
+    }
+
+    //! Feed the given document by chunks of the given size
+    bool Stream(const std::string& document, int chunkSize, int batchSize)
+    {
+      XmlStream stream(*this, "gameList", batchSize);
+      for (int i = 0; i < (int)document.size(); i += chunkSize)
+        if (!stream.Feed(document.data() + i, std::min(chunkSize, (int)document.size() - i)))
+          return false;
+      return stream.Complete();
+    }
+};
+
+static const char* sDocument =
+  "\xEF\xBB\xBF<?xml version=\"1.0\"?>\n"
+  "<!DOCTYPE gameList>\n"
+  "<gameList>\n"
+  "  <!-- <game><path>./commented.zip</path></game> -->\n"
+  "  <game id=\"1\" source=\"a>b\"><path>./a.zip</path><name>A &amp; B</name></game>\n"
+  "  <folder><path>./sub</path><desc><![CDATA[</folder> is text]]></desc></folder>\n"
+  "  <game><path>./sub/c.zip</path><image/></game>\n"
+  "  <provider/>\n"
+  "</gameList>\n";
+
+TEST_F(XmlStreamTest, testAllChunkSizes)
+{
+  for (int chunkSize = 1; chunkSize <= 64; ++chunkSize)
+  {
+    mPaths.clear();
+    ASSERT_TRUE(Stream(sDocument, chunkSize, 1024));
+    ASSERT_EQ(mPaths.size(), 4u);
+    ASSERT_EQ(mPaths[0], "game:./a.zip");
+    ASSERT_EQ(mPaths[1], "folder:./sub");
+    ASSERT_EQ(mPaths[2], "game:./sub/c.zip");
+    ASSERT_EQ(mPaths[3], "provider:");
+  }
+}
+
+TEST_F(XmlStreamTest, testBatches)
+{
+  ASSERT_TRUE(Stream(sDocument, 7, 3));
+  ASSERT_EQ(mPaths.size(), 4u);
+  ASSERT_EQ(mBatches, 2);
+}
+
+TEST_F(XmlStreamTest, testInvalidDocuments)
+{
+  ASSERT_FALSE(Stream("", 16, 10));
+  ASSERT_FALSE(Stream("<systemList><game/></systemList>", 16, 10));
+  ASSERT_FALSE(Stream("<gameList><game><path>./a.zip</path>", 16, 10));
+  ASSERT_TRUE(Stream("<gameList/>", 16, 10));
+}
+
+TEST_F(XmlStreamTest, testBareElements)
+{
+  XmlStream stream(*this, "", 10);
+  static const std::string sElements = "<game><path>./a.zip</path></game>\n<folder><path>./sub</path></folder>\n";
+  ASSERT_TRUE(stream.Feed(sElements.data(), (int)sElements.size()));
+  ASSERT_TRUE(stream.Complete());
+  ASSERT_EQ(mPaths.size(), 2u);
+  ASSERT_EQ(mPaths[1], "folder:./sub");
+}
+
+TEST_F(XmlStreamTest, testWriteAndReadBack)
+{
+  Path path("/tmp/test_xmlstream_gamelist.xml");
+  Path journal("/tmp/test_xmlstream_gamelist.journal");
+  journal.Delete();
+
+  XmlDocument document;
+  XmlNode game = document.append_child("game");
+  Xml::AddAsString(game, "path", "./a & b.zip");
+  {
+    XmlStreamWriter writer(path, "gameList", false);
+    ASSERT_TRUE(writer.IsOpen());
+    writer.Write(game);
+    writer.Write(game);
+    ASSERT_TRUE(writer.Commit());
+  }
+  ASSERT_FALSE(Path("/tmp/test_xmlstream_gamelist.xml.tmp").Exists());
+  for (int i = 0; i < 2; ++i)
+  {
+    XmlStreamWriter writer(journal, "gameList", true);
+    writer.Write(game);
+    ASSERT_TRUE(writer.Commit());
+  }
+
+  XmlStream stream(*this, "gameList", 10);
+  ASSERT_TRUE(stream.ParseFile(path));
+  XmlStream journalStream(*this, "", 10);
+  ASSERT_TRUE(journalStream.ParseFile(journal));
+  ASSERT_EQ(mPaths.size(), 4u);
+  for (const std::string& received : mPaths)
+    ASSERT_EQ(received, "game:./a & b.zip");
+
+  path.Delete();
+  journal.Delete();
+}